@@ -0,0 +1,261 @@
+#include "BulkTransfer.h"
+#include "ESPNowManager.h"
+#include "HostLink.h"
+#include "Statistics.h"
+#include "crc_utils.h"
+
+extern Statistics stats;
+extern ESPNowManager espNowManager;
+
+#define BULK_NO_BLOB -1
+
+void BlobBuffer::start(const BulkHeader& bulk, uint32_t now_ms) {
+    state = BLOB_FILLING;
+    src_id = bulk.src_id;
+    blob_id = bulk.blob_id;
+    flags = bulk.flags;
+    total_len = bulk.total_len;
+    received = 0;
+    received_mask = 0;
+    started_ms = now_ms;
+    last_ms = now_ms;
+}
+
+bool BlobBuffer::add(const BulkHeader& bulk, const uint8_t* chunk, uint16_t len, uint16_t unit, uint32_t now_ms) {
+    // Every chunk but the last is exactly one unit long
+    if (bulk.total_len != total_len || bulk.offset % unit != 0 || len == 0 ||
+        bulk.offset + len > total_len || (len != unit && bulk.offset + len != total_len)) {
+        return false;
+    }
+    uint16_t index = bulk.offset / unit;
+    if (index >= BULK_MAX_CHUNKS || (received_mask & (1ULL << index))) {
+        return false;
+    }
+    memcpy(data + bulk.offset, chunk, len);
+    received_mask |= 1ULL << index;
+    received += len;
+    last_ms = now_ms;
+    return true;
+}
+
+BulkTransfer::BulkTransfer() {
+    for (int i = 0; i < 256; i++) {
+        last_completed[i] = BULK_NO_BLOB;
+        last_completed_ms[i] = 0;
+    }
+}
+
+static size_t chunkLength(size_t packet_len) {
+    size_t overhead = offsetof(BulkDataPacket, data) + sizeof(uint16_t);
+    return packet_len > overhead ? packet_len - overhead : 0;
+}
+
+void BulkTransfer::handleHostChunk(const BulkDataPacket& packet, size_t len, uint32_t now_ms) {
+    const BulkHeader& bulk = packet.bulk;
+    if (bulk.total_len == 0 || bulk.total_len > BULK_MAX_BLOB_SIZE) {
+        stats.bulk.rejected++;
+        Serial.printf("ERROR: Bulk blob of %u bytes exceeds %u\n", bulk.total_len, BULK_MAX_BLOB_SIZE);
+        return;
+    }
+
+    // A chunk of a different blob abandons whatever was being staged
+    if (outgoing.state == BLOB_FREE || outgoing.blob_id != bulk.blob_id || outgoing.total_len != bulk.total_len) {
+        if (outgoing.state != BLOB_FREE) {
+            stats.bulk.timeouts++;
+        }
+        outgoing.start(bulk, now_ms);
+    }
+
+    if (!outgoing.add(bulk, packet.data, chunkLength(len), BULK_UART_CHUNK_SIZE, now_ms)) {
+        stats.bulk.rejected++;
+        return;
+    }
+
+    if (outgoing.isComplete()) {
+        sendBlob(outgoing.data, outgoing.total_len, outgoing.flags);
+        outgoing.state = BLOB_FREE;
+    }
+}
+
+void BulkTransfer::handleFragment(const BulkDataPacket& packet, size_t len, uint32_t now_ms) {
+    const BulkHeader& bulk = packet.bulk;
+    if (bulk.total_len == 0 || bulk.total_len > BULK_MAX_BLOB_SIZE) {
+        stats.bulk.rejected++;
+        return;
+    }
+    stats.bulk.fragments_received++;
+
+    portENTER_CRITICAL(&lock);
+    if (last_completed[bulk.src_id] == bulk.blob_id &&
+        now_ms - last_completed_ms[bulk.src_id] <= BULK_REASSEMBLY_TIMEOUT_MS) {
+        // Late copy of a blob that was already reassembled
+        portEXIT_CRITICAL(&lock);
+        stats.bulk.duplicate_fragments++;
+        return;
+    }
+
+    BlobBuffer* slot = nullptr;
+    BlobBuffer* free_slot = nullptr;
+    BlobBuffer* stale_slot = nullptr;
+    for (uint8_t i = 0; i < BULK_REASSEMBLY_SLOTS; i++) {
+        BlobBuffer& s = slots[i];
+        if (s.state == BLOB_FILLING && s.src_id == bulk.src_id && s.blob_id == bulk.blob_id) {
+            slot = &s;
+            break;
+        }
+        if (s.state == BLOB_FREE && !free_slot) {
+            free_slot = &s;
+        } else if (s.state == BLOB_FILLING && now_ms - s.last_ms > BULK_REASSEMBLY_TIMEOUT_MS) {
+            stale_slot = &s;
+        }
+    }
+
+    bool overflow = false;
+    bool evicted = false;
+    bool added = false;
+    if (!slot) {
+        slot = free_slot ? free_slot : stale_slot;
+        evicted = !free_slot && stale_slot;
+        if (slot) {
+            slot->start(bulk, now_ms);
+        } else {
+            overflow = true;
+        }
+    }
+    if (slot) {
+        added = slot->add(bulk, packet.data, chunkLength(len), BULK_AIR_FRAGMENT_SIZE, now_ms);
+        if (added && slot->isComplete()) {
+            slot->state = BLOB_COMPLETE;
+            last_completed[bulk.src_id] = bulk.blob_id;
+            last_completed_ms[bulk.src_id] = now_ms;
+        }
+    }
+    portEXIT_CRITICAL(&lock);
+
+    if (overflow) stats.bulk.slot_overflows++;
+    if (evicted) stats.bulk.timeouts++;
+    if (slot && !added) stats.bulk.duplicate_fragments++;
+}
+
+void BulkTransfer::update(uint32_t now_ms) {
+    for (uint8_t i = 0; i < BULK_REASSEMBLY_SLOTS; i++) {
+        BlobBuffer& slot = slots[i];
+
+        // The receive callback never touches a complete slot, no lock needed
+        if (slot.state == BLOB_COMPLETE) {
+            deliver(slot);
+            slot.state = BLOB_FREE;
+            continue;
+        }
+
+        bool timed_out = false;
+        portENTER_CRITICAL(&lock);
+        if (slot.state == BLOB_FILLING && now_ms - slot.last_ms > BULK_REASSEMBLY_TIMEOUT_MS) {
+            slot.state = BLOB_FREE;
+            timed_out = true;
+        }
+        portEXIT_CRITICAL(&lock);
+        if (timed_out) stats.bulk.timeouts++;
+    }
+
+    if (outgoing.state == BLOB_FILLING && now_ms - outgoing.last_ms > BULK_REASSEMBLY_TIMEOUT_MS) {
+        outgoing.state = BLOB_FREE;
+        stats.bulk.timeouts++;
+    }
+
+    if (bench_remaining > 0) {
+        runBenchmark();
+    }
+}
+
+bool BulkTransfer::sendBlob(const uint8_t* data, uint16_t len, uint8_t flags) {
+    uint8_t network_id = espNowManager.getConfig().network_id;
+    uint8_t blob_id = next_blob_id++;
+
+    for (uint16_t offset = 0; offset < len; offset += BULK_AIR_FRAGMENT_SIZE) {
+        uint16_t n = min((uint16_t)(len - offset), (uint16_t)BULK_AIR_FRAGMENT_SIZE);
+
+        BulkDataPacket packet;
+        size_t packet_len = offsetof(BulkDataPacket, data) + n + sizeof(uint16_t);
+        initPacketHeader(packet.header, BULK_DATA, packet_len, network_id);
+        packet.bulk.src_id = espNowManager.getNodeId();
+        packet.bulk.blob_id = blob_id;
+        packet.bulk.flags = flags;
+        packet.bulk.total_len = len;
+        packet.bulk.offset = offset;
+        if (data) {
+            memcpy(packet.data, data + offset, n);
+        } else {
+            // Benchmark payload, no buffer behind it
+            for (uint16_t i = 0; i < n; i++) {
+                packet.data[i] = (uint8_t)(offset + i);
+            }
+        }
+        sealPacket((uint8_t*)&packet, packet_len);
+
+        if (!espNowManager.sendPacket((uint8_t*)&packet, packet_len)) {
+            stats.bulk.send_failures++;
+            return false;
+        }
+        stats.bulk.fragments_sent++;
+    }
+
+    stats.bulk.blobs_sent++;
+    stats.bulk.bytes_sent += len;
+    return true;
+}
+
+void BulkTransfer::deliver(const BlobBuffer& blob) {
+    stats.bulk.blobs_received++;
+    stats.bulk.bytes_received += blob.total_len;
+    stats.bulk.reassembly_ms += blob.last_ms - blob.started_ms;
+    if (blob.flags & BULK_FLAG_BENCHMARK) {
+        return;
+    }
+
+    uint8_t network_id = espNowManager.getConfig().network_id;
+    for (uint16_t offset = 0; offset < blob.total_len; offset += BULK_UART_CHUNK_SIZE) {
+        uint16_t n = min((uint16_t)(blob.total_len - offset), (uint16_t)BULK_UART_CHUNK_SIZE);
+
+        BulkDataPacket packet;
+        size_t packet_len = offsetof(BulkDataPacket, data) + n + sizeof(uint16_t);
+        initPacketHeader(packet.header, BULK_DATA, packet_len, network_id);
+        packet.bulk.src_id = blob.src_id;
+        packet.bulk.blob_id = blob.blob_id;
+        packet.bulk.flags = blob.flags;
+        packet.bulk.total_len = blob.total_len;
+        packet.bulk.offset = offset;
+        memcpy(packet.data, blob.data + offset, n);
+        sealPacket((uint8_t*)&packet, packet_len);
+
+        if (!sendToHost((uint8_t*)&packet, packet_len)) {
+            return;
+        }
+    }
+}
+
+void BulkTransfer::startBenchmark(uint16_t blob_size, uint8_t count) {
+    if (blob_size == 0 || blob_size > BULK_MAX_BLOB_SIZE || count == 0) {
+        Serial.printf("ERROR: Invalid bulk benchmark: %u blobs of %u bytes\n", count, blob_size);
+        return;
+    }
+    bench_size = blob_size;
+    bench_count = count;
+    bench_remaining = count;
+    bench_started_ms = millis();
+    Serial.printf("Bulk benchmark: sending %u blobs of %u bytes\n", count, blob_size);
+}
+
+void BulkTransfer::runBenchmark() {
+    // One blob per loop() pass so UART and housekeeping keep running
+    sendBlob(nullptr, bench_size, BULK_FLAG_BENCHMARK);
+    if (--bench_remaining > 0) {
+        return;
+    }
+
+    uint32_t elapsed = millis() - bench_started_ms;
+    uint32_t bytes = (uint32_t)bench_size * bench_count;
+    stats.bulk.benchmark_kbps = elapsed > 0 ? bytes / (float)elapsed : 0.0f;  // bytes/ms == KB/s
+    Serial.printf("Bulk benchmark: %lu bytes in %lu ms, %.1f KB/s\n",
+                 (unsigned long)bytes, (unsigned long)elapsed, stats.bulk.benchmark_kbps);
+}
@@ -0,0 +1,76 @@
+#ifndef BULK_TRANSFER_H
+#define BULK_TRANSFER_H
+
+#include <Arduino.h>
+#include "Packet.h"
+
+#define BULK_REASSEMBLY_SLOTS 2
+#define BULK_REASSEMBLY_TIMEOUT_MS 1000  // Since the last fragment of an incomplete blob
+#define BULK_MAX_CHUNKS 64               // Bits in BlobBuffer::received_mask
+
+enum BlobState : uint8_t {
+    BLOB_FREE = 0,
+    BLOB_FILLING,   // Receiving chunks
+    BLOB_COMPLETE   // Owned by loop() until delivered
+};
+
+// One blob being collected from chunks of a fixed unit size
+struct BlobBuffer {
+    volatile BlobState state = BLOB_FREE;
+    uint8_t src_id = 0;
+    uint8_t blob_id = 0;
+    uint8_t flags = 0;
+    uint16_t total_len = 0;
+    uint16_t received = 0;
+    uint64_t received_mask = 0;  // Bit n: chunk at offset n * unit is in
+    uint32_t started_ms = 0;
+    uint32_t last_ms = 0;
+    uint8_t data[BULK_MAX_BLOB_SIZE];
+
+    void start(const BulkHeader& bulk, uint32_t now_ms);
+    // Returns false for chunks that do not fit this blob or were seen before
+    bool add(const BulkHeader& bulk, const uint8_t* chunk, uint16_t len, uint16_t unit, uint32_t now_ms);
+    bool isComplete() const { return received == total_len; }
+};
+
+// Fragmentation and reassembly of BULK_DATA blobs larger than one packet.
+// Outgoing: host chunks are staged until the blob is complete, then sent as
+// MTU-sized air fragments. Incoming: fragments are reassembled in a small
+// fixed pool of slots (written from the ESP-NOW receive callback) and
+// complete blobs are handed to the host from loop().
+class BulkTransfer {
+public:
+    BulkTransfer();
+
+    // UART BULK_DATA chunk from the host
+    void handleHostChunk(const BulkDataPacket& packet, size_t len, uint32_t now_ms);
+    // BULK_DATA fragment from ESP-NOW, called from the receive callback
+    void handleFragment(const BulkDataPacket& packet, size_t len, uint32_t now_ms);
+
+    // Delivery of complete blobs, timeouts and benchmark, called from loop()
+    void update(uint32_t now_ms);
+
+    // Send count blobs of blob_size bytes back to back and report throughput
+    void startBenchmark(uint16_t blob_size, uint8_t count);
+
+private:
+    bool sendBlob(const uint8_t* data, uint16_t len, uint8_t flags);
+    void deliver(const BlobBuffer& blob);
+    void runBenchmark();
+
+    portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+
+    BlobBuffer outgoing;
+    BlobBuffer slots[BULK_REASSEMBLY_SLOTS];
+    // Per originator, to drop late duplicates of a blob that was just reassembled
+    int16_t last_completed[256];
+    uint32_t last_completed_ms[256];
+    uint8_t next_blob_id = 0;
+
+    uint8_t bench_remaining = 0;
+    uint16_t bench_size = 0;
+    uint8_t bench_count = 0;
+    uint32_t bench_started_ms = 0;
+};
+
+#endif // BULK_TRANSFER_H
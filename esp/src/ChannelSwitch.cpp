@@ -0,0 +1,157 @@
+#include "ChannelSwitch.h"
+#include <esp_timer.h>
+#include "ESPNowManager.h"
+#include "TimeSync.h"
+#include "ConfigManager.h"
+#include "Statistics.h"
+#include "HostLink.h"
+#include "crc_utils.h"
+
+extern ESPNowManager espNowManager;
+extern TimeSync timeSync;
+extern Statistics stats;
+extern ESPNowConfig espnow_config;
+
+void ChannelSwitch::handleHost(const ChannelSwitchPacket& packet) {
+    if (packet.channel < 1 || packet.channel > 13 ||
+        packet.countdown_us < CHANNEL_SWITCH_MIN_COUNTDOWN_MS * 1000UL ||
+        packet.countdown_us > CHANNEL_SWITCH_MAX_COUNTDOWN_MS * 1000UL) {
+        Serial.printf("ERROR: Invalid channel switch to %u in %lu us\n", packet.channel,
+                     (unsigned long)packet.countdown_us);
+        sendReport(packet.switch_id, packet.channel, CHANNEL_SWITCH_REJECTED, 0, 0);
+        return;
+    }
+
+    int64_t now_us = esp_timer_get_time();
+    int64_t master_us;
+    bool synced = timeSync.toMasterTime(now_us, master_us);
+    schedule(packet.switch_id, packet.channel, now_us + packet.countdown_us,
+             synced ? master_us + packet.countdown_us : 0, synced, CHANNEL_SWITCH_ANNOUNCES, now_us);
+    Serial.printf("Channel switch %u: to channel %u in %lu ms%s\n", packet.switch_id, packet.channel,
+                 (unsigned long)(packet.countdown_us / 1000), synced ? "" : " (no swarm clock)");
+}
+
+void ChannelSwitch::handleAir(const ChannelSwitchPacket& packet, int64_t rx_us) {
+    if (packet.op != CHANNEL_SWITCH_ANNOUNCE || packet.channel < 1 || packet.channel > 13) return;
+
+    // Timestamps first, TimeSync takes its own lock
+    int64_t master_us;
+    bool synced = packet.switch_at_us != 0 && timeSync.toMasterTime(rx_us, master_us);
+    int64_t deadline = synced ? rx_us + ((int64_t)packet.switch_at_us - master_us) : rx_us + packet.countdown_us;
+    if (deadline < rx_us) {
+        deadline = rx_us;  // Heard too late: switch at once
+    }
+
+    portENTER_CRITICAL(&lock);
+    bool known = (scheduled && switch_id == packet.switch_id) || (last_valid && last_id == packet.switch_id);
+    portEXIT_CRITICAL(&lock);
+    if (known) return;
+
+    schedule(packet.switch_id, packet.channel, deadline, packet.switch_at_us, synced,
+             CHANNEL_SWITCH_RELAY_ANNOUNCES, rx_us + esp_random() % CHANNEL_SWITCH_RELAY_JITTER_US);
+}
+
+void ChannelSwitch::schedule(uint16_t id, uint8_t ch, int64_t deadline, uint64_t switch_at,
+                             bool swarm_clock, uint8_t announces, int64_t first_announce_us) {
+    portENTER_CRITICAL(&lock);
+    scheduled = true;
+    switch_id = id;
+    channel = ch;
+    deadline_us = deadline;
+    switch_at_us = switch_at;
+    on_swarm_clock = swarm_clock;
+    announces_left = announces;
+    next_announce_us = first_announce_us;
+    portEXIT_CRITICAL(&lock);
+}
+
+void ChannelSwitch::onFrame(int64_t rx_us) {
+    if (!awaiting_frame) return;
+    portENTER_CRITICAL(&lock);
+    if (awaiting_frame && first_frame_us == 0) {
+        int64_t elapsed = rx_us - switched_us;
+        first_frame_us = elapsed > 0 ? (uint32_t)elapsed : 1;
+    }
+    portEXIT_CRITICAL(&lock);
+}
+
+void ChannelSwitch::update(uint32_t now_ms) {
+    int64_t now_us = esp_timer_get_time();
+
+    // Pass the announcement on while there is time for it to matter
+    portENTER_CRITICAL(&lock);
+    bool announce = scheduled && announces_left > 0 && now_us >= next_announce_us &&
+                    deadline_us - now_us > CHANNEL_SWITCH_MIN_LEAD_US;
+    ChannelSwitchPacket packet;
+    if (announce) {
+        announces_left--;
+        next_announce_us = now_us + CHANNEL_SWITCH_ANNOUNCE_INTERVAL_US;
+        memset(&packet, 0, sizeof(packet));
+        initPacketHeader(packet.header, CHANNEL_SWITCH, sizeof(packet), espNowManager.getConfig().network_id);
+        packet.op = CHANNEL_SWITCH_ANNOUNCE;
+        packet.channel = channel;
+        packet.switch_id = switch_id;
+        packet.switch_at_us = switch_at_us;
+        packet.countdown_us = (uint32_t)(deadline_us - now_us);
+    }
+    bool due = scheduled && now_us >= deadline_us;
+    uint8_t target = channel;
+    int64_t late_us = now_us - deadline_us;
+    if (due) {
+        scheduled = false;
+        last_valid = true;
+        last_id = switch_id;
+        report_status = on_swarm_clock ? CHANNEL_SWITCH_OK : CHANNEL_SWITCH_UNSYNCED;
+    }
+    portEXIT_CRITICAL(&lock);
+
+    if (announce) {
+        sealPacket((uint8_t*)&packet, sizeof(packet));
+        if (espNowManager.sendPacket((const uint8_t*)&packet, sizeof(packet))) {
+            stats.channel.announced++;
+        }
+    }
+
+    if (due) {
+        applyESPNowConfig(espnow_config.network_id, target, espnow_config.tx_power);
+        portENTER_CRITICAL(&lock);
+        switched_us = esp_timer_get_time();
+        first_frame_us = 0;
+        awaiting_frame = true;
+        portEXIT_CRITICAL(&lock);
+        report_due_ms = now_ms + CHANNEL_SWITCH_REPORT_TIMEOUT_MS;
+        stats.channel.switches++;
+        stats.channel.late_us = late_us;
+        if (report_status == CHANNEL_SWITCH_UNSYNCED) {
+            stats.channel.unsynced++;
+        }
+        return;
+    }
+
+    // Report once the new channel has carried a frame, or after the timeout
+    if (awaiting_frame) {
+        portENTER_CRITICAL(&lock);
+        uint32_t first = first_frame_us;
+        portEXIT_CRITICAL(&lock);
+        if (first > 0 || (int32_t)(now_ms - report_due_ms) >= 0) {
+            awaiting_frame = false;
+            stats.channel.first_frame_us = first;
+            sendReport(last_id, espNowManager.getConfig().channel, report_status, switch_at_us, first);
+        }
+    }
+}
+
+void ChannelSwitch::sendReport(uint16_t id, uint8_t ch, uint8_t status, uint64_t switch_at, uint32_t first_frame) {
+    ChannelSwitchPacket report;
+    memset(&report, 0, sizeof(report));
+    initPacketHeader(report.header, CHANNEL_SWITCH, sizeof(report), espNowManager.getConfig().network_id);
+    report.op = CHANNEL_SWITCH_REPORT;
+    report.channel = ch;
+    report.status = status;
+    report.switch_id = id;
+    report.switch_at_us = switch_at;
+    report.first_frame_us = first_frame;
+    sealPacket((uint8_t*)&report, sizeof(report));
+    sendToHost((uint8_t*)&report, sizeof(report));
+    Serial.printf("Channel switch %u: channel %u, first frame after %lu us\n", id, ch, (unsigned long)first_frame);
+}
@@ -0,0 +1,66 @@
+#ifndef CHANNEL_SWITCH_H
+#define CHANNEL_SWITCH_H
+
+#include <Arduino.h>
+#include "Packet.h"
+
+#define CHANNEL_SWITCH_MIN_COUNTDOWN_MS 100      // Time for the announcement to cross the swarm
+#define CHANNEL_SWITCH_MAX_COUNTDOWN_MS 10000
+#define CHANNEL_SWITCH_ANNOUNCES 3               // Sent by the bridge the host asked
+#define CHANNEL_SWITCH_RELAY_ANNOUNCES 2         // Sent by every bridge that hears of the switch
+#define CHANNEL_SWITCH_ANNOUNCE_INTERVAL_US 30000
+#define CHANNEL_SWITCH_RELAY_JITTER_US 20000     // Bridges that heard the same copy do not pass it on together
+#define CHANNEL_SWITCH_MIN_LEAD_US 5000          // No announcements this close to the switch
+#define CHANNEL_SWITCH_REPORT_TIMEOUT_MS 2000    // Report without a first frame after this long
+
+// Swarm-wide move to another channel at one instant. The host's request
+// becomes an announcement carrying the switch time on the swarm clock and
+// the time left; every bridge that hears it passes it on a couple of times
+// (flooding, independent of the mesh relay policy) and flips its channel
+// in place when the time comes. Bridges without the swarm clock count down
+// from the arrival of the announcement instead. Each bridge then reports
+// to its host how long it took to hear the first frame on the new channel.
+class ChannelSwitch {
+public:
+    // REQUEST from the host
+    void handleHost(const ChannelSwitchPacket& packet);
+
+    // ANNOUNCE from the ESP-NOW receive callback; rx_us is the arrival time
+    void handleAir(const ChannelSwitchPacket& packet, int64_t rx_us);
+
+    // Every valid frame of our network, from the receive callback
+    void onFrame(int64_t rx_us);
+
+    // Announcements, the switch itself and the report, called from loop()
+    void update(uint32_t now_ms);
+
+private:
+    void schedule(uint16_t id, uint8_t channel, int64_t deadline_us, uint64_t switch_at_us,
+                  bool on_swarm_clock, uint8_t announces, int64_t first_announce_us);
+    void sendReport(uint16_t id, uint8_t channel, uint8_t status, uint64_t switch_at_us, uint32_t first_frame_us);
+
+    portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+
+    // Switch ahead
+    bool scheduled = false;
+    uint16_t switch_id = 0;
+    uint8_t channel = 0;
+    int64_t deadline_us = 0;      // Local esp_timer time of the switch
+    uint64_t switch_at_us = 0;    // Swarm time, passed on as received
+    bool on_swarm_clock = false;
+    uint8_t announces_left = 0;
+    int64_t next_announce_us = 0;
+
+    // Switches already seen, ignored when their announcements come back
+    bool last_valid = false;
+    uint16_t last_id = 0;
+
+    // Switch done, report pending
+    volatile bool awaiting_frame = false;
+    int64_t switched_us = 0;
+    uint32_t first_frame_us = 0;
+    uint32_t report_due_ms = 0;
+    uint8_t report_status = 0;
+};
+
+#endif // CHANNEL_SWITCH_H
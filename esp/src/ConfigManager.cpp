@@ -1,6 +1,7 @@
 #include "ConfigManager.h"
 #include "ESPNowManager.h"
 #include "OTAManager.h"
+#include "ControlWorker.h"
 #include <WiFi.h>
 #include <HTTPClient.h>
 
@@ -18,6 +19,9 @@ bool wifi_connected = false;
 // OTA URL storage
 String ota_url = "";
 
+extern ESPNowManager espNowManager;
+extern ControlWorker controlWorker;
+
 // Load WiFi configuration from SPIFFS
 void loadWiFiConfiguration() {
     if (SPIFFS.exists(WIFI_CONFIG_FILE)) {
@@ -190,8 +194,8 @@ void loadConfiguration() {
     }
 }
 
-// Save ESP-NOW configuration to SPIFFS and restart
-void saveESPNowConfigAndRestart(uint8_t network_id, uint8_t wifi_channel, uint8_t tx_power) {
+// Apply ESP-NOW configuration live, persist it later
+void applyESPNowConfig(uint8_t network_id, uint8_t wifi_channel, uint8_t tx_power) {
     // Validate input parameters
     if (wifi_channel < 1 || wifi_channel > 13) {
         Serial.println("ERROR: Invalid WiFi channel, must be 1-13");
@@ -208,12 +212,32 @@ void saveESPNowConfigAndRestart(uint8_t network_id, uint8_t wifi_channel, uint8_
         return;
     }
     
-    StaticJsonDocument<512> doc;
     extern ESPNowConfig espnow_config;
-    doc["network_id"] = network_id;
-    doc["channel"] = wifi_channel;
-    doc["tx_power"] = tx_power;
-    doc["encrypt"] = espnow_config.encrypt;
+    ESPNowConfig cfg = espnow_config;
+    cfg.network_id = network_id;
+    cfg.channel = wifi_channel;
+    cfg.tx_power = tx_power;
+    if (!espNowManager.applyConfig(cfg)) {
+        Serial.println("ESP-NOW config unchanged");
+        return;
+    }
+    espnow_config = cfg;
+    
+    ControlItem item;
+    item.type = WORK_SAVE_ESPNOW_CONFIG;
+    item.espnow = cfg;
+    if (!controlWorker.post(item)) {
+        Serial.println("ERROR: Control queue full, ESP-NOW config not saved");
+    }
+}
+
+// Write an ESP-NOW configuration to SPIFFS, from the control worker
+bool saveESPNowConfig(const ESPNowConfig& cfg) {
+    StaticJsonDocument<512> doc;
+    doc["network_id"] = cfg.network_id;
+    doc["channel"] = cfg.channel;
+    doc["tx_power"] = cfg.tx_power;
+    doc["encrypt"] = cfg.encrypt;
     
     File file = SPIFFS.open(ESPNOW_CONFIG_FILE, "w");
     if (file) {
@@ -222,17 +246,16 @@ void saveESPNowConfigAndRestart(uint8_t network_id, uint8_t wifi_channel, uint8_
         
         if (bytes_written > 0) {
             Serial.printf("Saved new ESP-NOW config: network_id=%d, channel=%d\n", 
-                         network_id, wifi_channel);
-            Serial.println("Restarting ESP32...");
-            delay(100);
-            ESP.restart();
+                         cfg.network_id, cfg.channel);
+            return true;
         } else {
             Serial.println("ERROR: Failed to write ESP-NOW configuration");
         }
     } else {
         Serial.println("ERROR: Failed to open ESP-NOW config file for writing");
     }
-} 
+    return false;
+}
 
 // Load OTA URL from SPIFFS
 void loadOTAUrl() {
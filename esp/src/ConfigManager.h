@@ -5,6 +5,8 @@
 #include <SPIFFS.h>
 #include <ArduinoJson.h>
 
+struct ESPNowConfig;
+
 // Configuration file paths
 extern const char* CONFIG_FILE;
 extern const char* ESPNOW_CONFIG_FILE;
@@ -23,7 +25,10 @@ extern String ota_url;
 void loadConfiguration();
 void loadWiFiConfiguration();
 bool updateWiFiConfig(const char* ssid, const char* password);
-void saveESPNowConfigAndRestart(uint8_t network_id, uint8_t wifi_channel, uint8_t tx_power);
+// CONFIG from the host: switches the radio in place and has the control
+// worker save the new values a little later; an unchanged config does nothing
+void applyESPNowConfig(uint8_t network_id, uint8_t wifi_channel, uint8_t tx_power);
+bool saveESPNowConfig(const ESPNowConfig& cfg);
 void loadOTAUrl();
 bool saveOTAUrl(const char* url);
 bool checkAndExecutePendingOTA();
@@ -0,0 +1,144 @@
+#include "ControlWorker.h"
+#include "ConfigManager.h"
+#include "Statistics.h"
+
+extern Statistics stats;
+
+bool ControlWorker::begin() {
+    queue = xQueueCreate(CONTROL_QUEUE_DEPTH, sizeof(ControlItem));
+    if (!queue) {
+        Serial.println("ERROR: Failed to create control work queue");
+        return false;
+    }
+    if (xTaskCreatePinnedToCore(taskMain, "control", CONTROL_TASK_STACK, this, CONTROL_TASK_PRIORITY, nullptr,
+                                CONTROL_TASK_CORE) != pdPASS) {
+        Serial.println("ERROR: Failed to start control worker");
+        vQueueDelete(queue);
+        queue = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool ControlWorker::post(const ControlItem& item) {
+    if (!queue || xQueueSend(queue, &item, 0) != pdTRUE) {
+        stats.control.dropped++;
+        return false;
+    }
+    stats.control.posted++;
+    return true;
+}
+
+void ControlWorker::taskMain(void* arg) {
+    ControlWorker* worker = (ControlWorker*)arg;
+    ControlItem item;
+    for (;;) {
+        if (xQueueReceive(worker->queue, &item, portMAX_DELAY) == pdTRUE) {
+            worker->run(item);
+        }
+    }
+}
+
+void ControlWorker::run(ControlItem& item) {
+    // Settle first: later saves waiting behind this one replace it
+    if (item.type == WORK_SAVE_ESPNOW_CONFIG) {
+        vTaskDelay(pdMS_TO_TICKS(CONFIG_SAVE_DELAY_MS));
+        ControlItem next;
+        while (xQueuePeek(queue, &next, 0) == pdTRUE && next.type == WORK_SAVE_ESPNOW_CONFIG) {
+            xQueueReceive(queue, &item, 0);
+        }
+    } else if (item.type == WORK_RESTART) {
+        Serial.println("Restarting device...");
+        vTaskDelay(pdMS_TO_TICKS(CONTROL_RESTART_DELAY_MS));
+        ESP.restart();
+    }
+
+    uint32_t start = millis();
+    bool ok = false;
+    switch (item.type) {
+        case WORK_SAVE_ESPNOW_CONFIG:
+            ok = saveESPNowConfig(item.espnow);
+            break;
+        case WORK_OTA_CONFIG:
+            ok = saveOtaConfig(item);
+            break;
+        default:
+            Serial.printf("ERROR: Unknown control work item %d\n", item.type);
+            break;
+    }
+    uint32_t elapsed = millis() - start;
+
+    if (ok) {
+        stats.control.completed++;
+    } else {
+        stats.control.failed++;
+    }
+    if (elapsed > stats.control.max_ms) {
+        stats.control.max_ms = elapsed;
+    }
+    if (elapsed > CONTROL_ITEM_BUDGET_MS) {
+        stats.control.overruns++;
+        Serial.printf("WARNING: Control work item %d took %lu ms\n", item.type, (unsigned long)elapsed);
+    }
+
+    // The OTA runs on the next boot
+    if (ok && item.type == WORK_OTA_CONFIG) {
+        ControlItem restart;
+        restart.type = WORK_RESTART;
+        post(restart);
+    }
+}
+
+bool ControlWorker::saveOtaConfig(const ControlItem& item) {
+    Serial.printf("Received OTA_CONFIG via ESP-NOW for drone %d:\n", item.drone_id);
+    Serial.printf("  SSID: '%s' (length: %d)\n", item.ssid, strlen(item.ssid));
+    Serial.printf("  Password: '%s' (length: %d)\n", item.password, strlen(item.password));
+    Serial.printf("  OTA URL: '%s' (length: %d)\n", item.ota_url, strlen(item.ota_url));
+
+    // Validate WiFi credentials
+    if (strlen(item.ssid) == 0) {
+        Serial.println("ERROR: WiFi SSID is empty in OTA_CONFIG packet");
+        return false;
+    }
+
+    if (strlen(item.ssid) > 23) {
+        Serial.printf("ERROR: WiFi SSID too long: %d characters (max 23)\n", strlen(item.ssid));
+        return false;
+    }
+
+    if (strlen(item.password) > 31) {
+        Serial.printf("ERROR: WiFi password too long: %d characters (max 31)\n", strlen(item.password));
+        return false;
+    }
+
+    // Save all configuration data to SPIFFS
+    Serial.println("  -> Saving configuration data to SPIFFS...");
+
+    if (!updateWiFiConfig(item.ssid, item.password)) {
+        Serial.println("ERROR: Failed to save WiFi configuration");
+        return false;
+    }
+
+    // Save OTA URL if provided
+    if (strlen(item.ota_url) > 0 && !saveOTAUrl(item.ota_url)) {
+        Serial.println("ERROR: Failed to save OTA URL");
+        return false;
+    }
+
+    // Create pending OTA file to trigger update after reboot
+    StaticJsonDocument<512> pending_doc;
+    pending_doc["pending_ota"] = true;
+    pending_doc["timestamp"] = millis();
+
+    File pending_file = SPIFFS.open("/pending_ota.json", "w");
+    if (!pending_file) {
+        Serial.println("ERROR: Failed to create pending OTA file");
+        return false;
+    }
+    serializeJson(pending_doc, pending_file);
+    pending_file.close();
+    Serial.println("  -> Pending OTA file created");
+
+    Serial.println("  -> All configuration saved successfully");
+    return true;
+}
@@ -0,0 +1,50 @@
+#ifndef CONTROL_WORKER_H
+#define CONTROL_WORKER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include "ESPNowManager.h"
+
+#define CONTROL_QUEUE_DEPTH 4
+#define CONTROL_TASK_STACK 8192
+#define CONTROL_TASK_PRIORITY 1         // loop()'s level, far below the WiFi task
+#define CONTROL_TASK_CORE 0
+#define CONTROL_ITEM_BUDGET_MS 1000     // Items that run longer are counted as overruns
+#define CONFIG_SAVE_DELAY_MS 500        // Repeated CONFIGs within this time cost one write
+#define CONTROL_RESTART_DELAY_MS 2000   // Lets the log drain before a restart
+
+enum ControlWork : uint8_t {
+    WORK_SAVE_ESPNOW_CONFIG = 1,  // Write espnow to SPIFFS
+    WORK_OTA_CONFIG = 2,          // Save the OTA_CONFIG credentials and URL, then restart into the update
+    WORK_RESTART = 3
+};
+
+struct ControlItem {
+    uint8_t type = 0;
+    ESPNowConfig espnow;
+    uint8_t drone_id = 0;
+    char ssid[24];
+    char password[32];
+    char ota_url[48];
+};
+
+// Control-plane work (SPIFFS writes, OTA scheduling, restarts) runs in a
+// background task of its own, one item at a time. Posting never blocks, so
+// the ESP-NOW receive callback and loop() hand work over in microseconds
+// whatever it costs; a full queue drops the item and counts it.
+class ControlWorker {
+public:
+    bool begin();
+    bool post(const ControlItem& item);
+
+private:
+    static void taskMain(void* arg);
+    void run(ControlItem& item);
+    bool saveOtaConfig(const ControlItem& item);
+
+    QueueHandle_t queue = nullptr;
+};
+
+#endif // CONTROL_WORKER_H
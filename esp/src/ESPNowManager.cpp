@@ -3,9 +3,30 @@
 #include "Statistics.h"
 #include "ConfigManager.h"
 #include "OTAManager.h"
+#include "SwarmTable.h"
+#include "BulkTransfer.h"
+#include "StreamManager.h"
+#include "PeerTable.h"
+#include "LinkMonitor.h"
+#include "TimeSync.h"
+#include "RateLimiter.h"
+#include "ChannelSwitch.h"
+#include "RemoteStats.h"
+#include "ControlWorker.h"
+#include "HostLink.h"
 #include "crc_utils.h"
 
 extern Statistics stats;
+extern SwarmTable swarmTable;
+extern BulkTransfer bulkTransfer;
+extern StreamManager streamManager;
+extern PeerTable peerTable;
+extern LinkMonitor linkMonitor;
+extern TimeSync timeSync;
+extern RateLimiter rateLimiter;
+extern ChannelSwitch channelSwitch;
+extern RemoteStats remoteStats;
+extern ControlWorker controlWorker;
 
 ESPNowManager* ESPNowManager::instance = nullptr;
 
@@ -38,6 +59,12 @@ bool ESPNowManager::init(const ESPNowConfig& cfg) {
         return false;
     }
     
+    // Until the host reports its drone_id, identify as the low byte of our MAC
+    uint8_t mac[6];
+    if (esp_wifi_get_mac(WIFI_IF_STA, mac) == ESP_OK) {
+        node_id = mac[5];
+    }
+    
     // Set channel and TX power with error checking
     esp_err_t wifi_result = esp_wifi_set_channel(config.channel, WIFI_SECOND_CHAN_NONE);
     if (wifi_result != ESP_OK) {
@@ -81,6 +108,7 @@ bool ESPNowManager::init(const ESPNowConfig& cfg) {
 
 bool ESPNowManager::addPeer(const uint8_t* peerAddress) {
     esp_now_peer_info_t peer;
+    memset(&peer, 0, sizeof(peer));
     memcpy(peer.peer_addr, peerAddress, 6);
     peer.channel = 0;
     peer.encrypt = false;
@@ -93,6 +121,65 @@ bool ESPNowManager::addPeer(const uint8_t* peerAddress) {
     return true;
 }
 
+bool ESPNowManager::ensurePeer(const uint8_t* mac) {
+    uint32_t now = millis();
+    uint8_t evicted[6];
+    bool evict = false;
+    UnicastPeer* slot = nullptr;
+
+    portENTER_CRITICAL(&peer_lock);
+    UnicastPeer* victim = &unicast_peers[0];
+    for (uint8_t i = 0; i < UNICAST_PEER_SLOTS; i++) {
+        UnicastPeer& peer = unicast_peers[i];
+        if (peer.used && memcmp(peer.mac, mac, 6) == 0) {
+            slot = &peer;
+            break;
+        }
+        if (victim->used && (!peer.used || peer.last_used_ms < victim->last_used_ms)) {
+            victim = &peer;
+        }
+    }
+    bool registered = slot != nullptr;
+    if (!registered) {
+        // Claim a free slot, else the least recently used one
+        slot = victim;
+        if (slot->used) {
+            memcpy(evicted, slot->mac, 6);
+            evict = true;
+        }
+        slot->used = true;
+        slot->ready = false;
+        memcpy(slot->mac, mac, 6);
+    }
+    slot->last_used_ms = now;
+    portEXIT_CRITICAL(&peer_lock);
+
+    if (registered) {
+        return true;
+    }
+    // ESP-NOW calls stay outside the lock
+    if (evict) {
+        esp_now_del_peer(evicted);
+        stats.unicast.peers_evicted++;
+    }
+    if (esp_now_is_peer_exist(mac) || addPeer(mac)) {
+        portENTER_CRITICAL(&peer_lock);
+        if (slot->used && memcmp(slot->mac, mac, 6) == 0) {
+            slot->ready = true;
+        }
+        portEXIT_CRITICAL(&peer_lock);
+        stats.unicast.peers_added++;
+        return true;
+    }
+
+    portENTER_CRITICAL(&peer_lock);
+    if (slot->used && memcmp(slot->mac, mac, 6) == 0) {
+        slot->used = false;
+    }
+    portEXIT_CRITICAL(&peer_lock);
+    return false;
+}
+
 bool ESPNowManager::validatePacket(const uint8_t* data, size_t len) {
     if (!data || len < sizeof(PacketHeader)) {
         return false;
@@ -119,14 +206,89 @@ bool ESPNowManager::sendWithRetry(const uint8_t* data, size_t len, uint8_t retri
         return false;
     }
     
+    bool protect = fec_encoder.enabled() && fec_encoder.protects(len);
+    if (protect && !fec_encoder.fits(frame_seq)) {
+        // Receivers cache one group span per sender, close the group before leaving it
+        sendParity();
+    }
+    uint16_t seq = nextFrameSeq();
+    
+    uint8_t frame[ESPNOW_MAX_FRAME_SIZE];
+    size_t frame_len = buildFrame(frame, data, len, 0, seq);
+    bool sent = transmit(broadcastAddress, frame, frame_len, retries);
+    
+    if (protect) {
+        fec_encoder.add(data, len, seq, millis());
+        stats.fec.protected_frames++;
+        if (fec_encoder.full()) {
+            sendParity();
+        }
+    }
+    return sent;
+}
+
+// Receive callback side of ensurePeer(): finds a registered station but never
+// calls into ESP-NOW, an unknown one is left for update() to register
+bool ESPNowManager::touchPeer(const uint8_t* mac) {
+    bool ready = false;
+    portENTER_CRITICAL(&peer_lock);
+    for (uint8_t i = 0; i < UNICAST_PEER_SLOTS; i++) {
+        UnicastPeer& peer = unicast_peers[i];
+        if (peer.used && memcmp(peer.mac, mac, 6) == 0) {
+            ready = peer.ready;
+            peer.last_used_ms = millis();
+            break;
+        }
+    }
+    if (!ready) {
+        memcpy(pending_peer, mac, 6);
+        pending_peer_valid = true;
+    }
+    portEXIT_CRITICAL(&peer_lock);
+    return ready;
+}
+
+uint16_t ESPNowManager::nextFrameSeq() {
+    portENTER_CRITICAL(&seq_lock);
+    uint16_t seq = frame_seq++;
+    portEXIT_CRITICAL(&seq_lock);
+    return seq;
+}
+
+uint16_t ESPNowManager::nextUnicastSeq() {
+    portENTER_CRITICAL(&seq_lock);
+    uint16_t seq = unicast_seq++;
+    portEXIT_CRITICAL(&seq_lock);
+    return seq;
+}
+
+size_t ESPNowManager::buildFrame(uint8_t* frame, const uint8_t* data, size_t len, uint8_t flags, uint16_t seq) {
+    // Broadcast frames of relayed types may be carried beyond our radio range
+    if (!(flags & (AIR_FLAG_UNICAST | AIR_FLAG_PROBE)) && relay.enabled() &&
+        relay.relays(((const PacketHeader*)data)->packet_type)) {
+        flags |= relay.getHops() << AIR_TTL_SHIFT;
+    }
+    AirTrailer trailer;
+    trailer.src_id = node_id;
+    trailer.flags = flags;
+    trailer.seq = seq;
+    memcpy(frame, data, len);
+    memcpy(frame + len, &trailer, sizeof(trailer));
+    return len + sizeof(trailer);
+}
+
+bool ESPNowManager::transmit(const uint8_t* dest, const uint8_t* frame, size_t len, uint8_t retries) {
     for (uint8_t attempt = 0; attempt < retries; attempt++) {
-        esp_err_t result = esp_now_send(broadcastAddress, data, len);
+        esp_err_t result = esp_now_send(dest, frame, len);
         
         if (result == ESP_OK) {
             packets_sent++;
             stats.espnow.packets_sent++;
             stats.espnow.packets_sent_last_interval++;
             stats.espnow.bytes_sent += len;
+            if (memcmp(dest, broadcastAddress, 6) != 0) {
+                stats.unicast.frames_sent++;
+            }
             return true;
         }
         
@@ -137,31 +299,822 @@ bool ESPNowManager::sendWithRetry(const uint8_t* data, size_t len, uint8_t retri
     }
     
     send_failures++;
+    if (memcmp(dest, broadcastAddress, 6) == 0) {
+        noteChannelBusy();  // Usually a full transmit queue
+    }
     Serial.printf("ERROR: ESP-NOW send failed after %d retries\n", retries);
     return false;
 }
 
 bool ESPNowManager::sendTelemetryPacket(const TelemetryPacket& packet) {
+    if (tdma.enabled() || jitter.enabled()) {
+        // Only the newest position matters, an older one still waiting is dropped.
+        // A replacement keeps the release time already drawn.
+        if (telemetry_held) {
+            if (tdma.enabled()) {
+                stats.tdma.superseded++;
+            } else {
+                stats.jitter.superseded++;
+            }
+        } else if (!tdma.enabled()) {
+            updateBackoff();
+            uint32_t delay_ms = jitter.delayMs(esp_random());
+            telemetry_due_ms = millis() + delay_ms;
+            stats.jitter.delayed++;
+            stats.jitter.total_delay_ms += delay_ms;
+            if (jitter.getBackoffExponent() > 0) {
+                stats.jitter.backed_off++;
+            }
+        }
+        held_telemetry = packet;
+        telemetry_held = true;
+        return true;
+    }
     return sendWithRetry((uint8_t*)&packet, sizeof(TelemetryPacket));
 }
 
+void ESPNowManager::releaseHeldTelemetry() {
+    if (telemetry_held) {
+        telemetry_held = false;
+        sendHeldTelemetry(MAX_RETRY_COUNT);
+    }
+}
+
+bool ESPNowManager::sendHeldTelemetry(uint8_t retries) {
+    bool sent = sendWithRetry((uint8_t*)&held_telemetry, sizeof(TelemetryPacket), retries);
+    if (sent) {
+        jitter.onSent();
+    }
+    return sent;
+}
+
+// A failed unicast says nothing about the channel, only broadcasts count
+void ESPNowManager::noteChannelBusy() {
+    portENTER_CRITICAL(&busy_lock);
+    busy_count++;
+    portEXIT_CRITICAL(&busy_lock);
+}
+
+// One doubling per telemetry period however many broadcasts failed in it
+void ESPNowManager::updateBackoff() {
+    portENTER_CRITICAL(&busy_lock);
+    bool busy = busy_count > 0;
+    busy_count = 0;
+    portEXIT_CRITICAL(&busy_lock);
+    if (busy) {
+        jitter.onBusy();
+    }
+}
+
+void ESPNowManager::setTdma(uint8_t slots, uint32_t slot_us) {
+    if (!tdma.configure(slots, slot_us)) {
+        Serial.printf("ERROR: Invalid TDMA frame: %u slots of %lu us\n", slots, (unsigned long)slot_us);
+        return;
+    }
+    releaseHeldTelemetry();
+    if (tdma.enabled()) {
+        Serial.printf("TDMA: slot %u of %u, %lu us each\n", tdma.slotOf(node_id), slots, (unsigned long)slot_us);
+    } else {
+        Serial.println("TDMA: off");
+    }
+}
+
+void ESPNowManager::setTxJitter(uint16_t window_ms) {
+    jitter.setWindow(window_ms);
+    releaseHeldTelemetry();
+    Serial.printf("TX jitter: %u ms%s\n", jitter.getWindow(), tdma.enabled() ? " (TDMA takes precedence)" : "");
+}
+
 bool ESPNowManager::sendCustomMessagePacket(const CustomMessagePacket& packet) {
     return sendWithRetry((uint8_t*)&packet, sizeof(CustomMessagePacket));
 }
 
+bool ESPNowManager::sendPacket(const uint8_t* data, size_t len) {
+    if (len + sizeof(AirTrailer) > ESPNOW_MTU) {
+        send_failures++;
+        return false;
+    }
+    return sendWithRetry(data, len);
+}
+
+bool ESPNowManager::sendUnicast(const uint8_t* mac, const uint8_t* data, size_t len) {
+    if (!initialized || !validatePacket(data, len) || len + sizeof(AirTrailer) > ESPNOW_MTU ||
+        !ensurePeer(mac)) {
+        send_failures++;
+        return false;
+    }
+
+    uint8_t frame[ESPNOW_MAX_FRAME_SIZE];
+    size_t frame_len = buildFrame(frame, data, len, AIR_FLAG_UNICAST, nextUnicastSeq());
+    return transmit(mac, frame, frame_len, 1);
+}
+
+bool ESPNowManager::replyUnicast(const uint8_t* mac, const uint8_t* data, size_t len) {
+    if (!initialized || !validatePacket(data, len) || len + sizeof(AirTrailer) > ESPNOW_MTU) {
+        send_failures++;
+        return false;
+    }
+
+    uint8_t frame[ESPNOW_MAX_FRAME_SIZE];
+    if (touchPeer(mac)) {
+        size_t frame_len = buildFrame(frame, data, len, AIR_FLAG_UNICAST, nextUnicastSeq());
+        return transmit(mac, frame, frame_len, 1);
+    }
+    // Replies name their recipient, the others drop it
+    size_t frame_len = buildFrame(frame, data, len, 0, nextFrameSeq());
+    stats.unicast.broadcast_fallbacks++;
+    return transmit(broadcastAddress, frame, frame_len, 1);
+}
+
 bool ESPNowManager::sendCommandPacket(const CommandPacket& packet) {
+    if (command_retries > 0) {
+        return sendReliableCommand(packet);
+    }
+    
+    // A command for one drone goes to its radio only and gets link-level retries
+    uint8_t mac[6];
+    if (packet.target_id != COMMAND_TARGET_ALL) {
+        if (peerTable.lookup(packet.target_id, mac) &&
+            sendUnicast(mac, (const uint8_t*)&packet, sizeof(CommandPacket))) {
+            return true;
+        }
+        stats.unicast.broadcast_fallbacks++;
+    }
     return sendWithRetry((uint8_t*)&packet, sizeof(CommandPacket));
 }
 
+void ESPNowManager::setCommandRetries(uint8_t retries) {
+    command_retries = retries;
+    Serial.printf("Reliable commands: %s (%d retransmissions)\n", retries > 0 ? "on" : "off", retries);
+}
+
+bool ESPNowManager::sendReliableCommand(const CommandPacket& packet) {
+    if (!initialized || !validatePacket((const uint8_t*)&packet, sizeof(packet))) {
+        send_failures++;
+        return false;
+    }
+
+    // Everyone who should hear the command: the target, or every live drone
+    uint32_t expected[8] = {0};
+    uint8_t expected_count = 0;
+    if (packet.target_id == COMMAND_TARGET_ALL) {
+        uint8_t ids[SWARM_TABLE_CAPACITY];
+        uint8_t n = swarmTable.activeIds(ids, SWARM_TABLE_CAPACITY);
+        for (uint8_t i = 0; i < n; i++) {
+            if (ids[i] == node_id) continue;
+            expected[ids[i] / 32] |= 1u << (ids[i] % 32);
+            expected_count++;
+        }
+    } else {
+        expected[packet.target_id / 32] |= 1u << (packet.target_id % 32);
+        expected_count = 1;
+    }
+
+    // A command for one drone goes to its radio only, when we know where it is
+    uint8_t mac[6];
+    bool unicast = packet.target_id != COMMAND_TARGET_ALL && peerTable.lookup(packet.target_id, mac) &&
+                   ensurePeer(mac);
+    if (packet.target_id != COMMAND_TARGET_ALL && !unicast) {
+        stats.unicast.broadcast_fallbacks++;
+    }
+
+    uint32_t now = millis();
+    uint8_t frame[sizeof(CommandPacket) + sizeof(AirTrailer)];
+    PendingCommand* entry = nullptr;
+
+    portENTER_CRITICAL(&reliable_lock);
+    for (uint8_t i = 0; i < RELIABLE_MAX_PENDING; i++) {
+        if (!pending[i].in_use) {
+            entry = &pending[i];
+            break;
+        }
+    }
+    if (entry) {
+        entry->in_use = true;
+        entry->complete = expected_count == 0;
+        entry->unicast = unicast;
+        memcpy(entry->mac, mac, 6);
+        entry->seq = reliable_seq++;
+        buildFrame(entry->frame, (const uint8_t*)&packet, sizeof(packet), AIR_FLAG_ACK_REQUESTED, entry->seq);
+        memcpy(entry->expected, expected, sizeof(expected));
+        memset(entry->acked, 0, sizeof(entry->acked));
+        entry->expected_count = expected_count;
+        entry->acked_count = 0;
+        entry->retransmissions = 0;
+        entry->rto_ms = RELIABLE_INITIAL_RTO_MS;
+        entry->first_sent_ms = now;
+        entry->last_ack_ms = now;
+        entry->next_retx_ms = now + RELIABLE_INITIAL_RTO_MS;
+        memcpy(frame, entry->frame, sizeof(frame));
+    }
+    portEXIT_CRITICAL(&reliable_lock);
+
+    if (!entry) {
+        // Too many commands in flight, fall back to a plain broadcast
+        stats.reliable.pending_overflows++;
+        return sendWithRetry((uint8_t*)&packet, sizeof(CommandPacket));
+    }
+
+    stats.reliable.commands_sent++;
+    return transmit(unicast ? mac : broadcastAddress, frame, sizeof(frame), 1);
+}
+
+bool ESPNowManager::retransmitUnicast(const PendingCommand& entry) {
+    if (entry.unicast) {
+        return transmit(entry.mac, entry.frame, sizeof(entry.frame), 1);
+    }
+
+    // Only a few drones still missing: resend to each of them instead of waking everyone
+    uint8_t missing[UNICAST_RETX_MAX_TARGETS];
+    uint8_t count = 0;
+    for (uint16_t id = 0; id < 256; id++) {
+        uint32_t bit = 1u << (id % 32);
+        if (!(entry.expected[id / 32] & bit) || (entry.acked[id / 32] & bit)) continue;
+        if (count == UNICAST_RETX_MAX_TARGETS) {
+            return false;
+        }
+        missing[count++] = id;
+    }
+
+    uint8_t macs[UNICAST_RETX_MAX_TARGETS][6];
+    for (uint8_t i = 0; i < count; i++) {
+        if (!peerTable.lookup(missing[i], macs[i]) || !ensurePeer(macs[i])) {
+            return false;
+        }
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        transmit(macs[i], entry.frame, sizeof(entry.frame), 1);
+    }
+    stats.unicast.unicast_retransmissions++;
+    return true;
+}
+
+// From the receive callback; update() sends it, sending here would race loop()
+// for the sequence numbers and the peer registrations
+void ESPNowManager::queueCommandAck(const uint8_t* mac, uint8_t originator, uint16_t seq) {
+    portENTER_CRITICAL(&reliable_lock);
+    bool queued = ack_count < COMMAND_ACK_QUEUE;
+    if (queued) {
+        QueuedAck& entry = ack_queue[ack_count++];
+        entry.direct = mac != nullptr;
+        if (mac) {
+            memcpy(entry.mac, mac, 6);
+        }
+        entry.originator = originator;
+        entry.seq = seq;
+    }
+    portEXIT_CRITICAL(&reliable_lock);
+    if (!queued) {
+        stats.reliable.acks_dropped++;
+    }
+}
+
+void ESPNowManager::sendCommandAck(const uint8_t* mac, uint8_t originator, uint16_t seq) {
+    AckPacket ack;
+    initPacketHeader(ack.header, ACK, sizeof(ack), config.network_id);
+    ack.ack_type = COMMAND;
+    ack.ack_id = originator;
+    ack.status = seq;
+    sealPacket((uint8_t*)&ack, sizeof(ack));
+
+    // A single attempt, no retry delay. The ACK only concerns the originator,
+    // so it goes to its radio when in range.
+    bool sent = mac && sendUnicast(mac, (const uint8_t*)&ack, sizeof(ack));
+    if (!sent) {
+        uint8_t frame[sizeof(AckPacket) + sizeof(AirTrailer)];
+        size_t frame_len = buildFrame(frame, (const uint8_t*)&ack, sizeof(ack), 0, nextFrameSeq());
+        sent = transmit(broadcastAddress, frame, frame_len, 1);
+    }
+    if (sent) {
+        stats.reliable.acks_sent++;
+    }
+}
+
+void ESPNowManager::handleCommandAck(const AckPacket& ack, uint8_t acker) {
+    if (ack.ack_id != node_id) return;  // Someone else's command
+    stats.reliable.acks_received++;
+
+    uint32_t now = millis();
+    uint32_t bit = 1u << (acker % 32);
+    portENTER_CRITICAL(&reliable_lock);
+    for (uint8_t i = 0; i < RELIABLE_MAX_PENDING; i++) {
+        PendingCommand& entry = pending[i];
+        if (!entry.in_use || entry.complete || entry.seq != ack.status) continue;
+        if ((entry.expected[acker / 32] & bit) && !(entry.acked[acker / 32] & bit)) {
+            entry.acked[acker / 32] |= bit;
+            entry.acked_count++;
+            entry.last_ack_ms = now;
+            entry.complete = entry.acked_count == entry.expected_count;
+        }
+        break;
+    }
+    portEXIT_CRITICAL(&reliable_lock);
+}
+
+bool ESPNowManager::isDuplicate(uint8_t originator, uint16_t seq) {
+    DuplicateWindow& w = dup_window[originator];
+    int16_t ahead = (int16_t)(seq - w.last_seq);
+
+    // First frame from this originator, or so far off that it restarted
+    if (!w.valid || ahead >= DUPLICATE_WINDOW || ahead <= -DUPLICATE_WINDOW) {
+        w.valid = true;
+        w.last_seq = seq;
+        w.mask = 1;
+        return false;
+    }
+    if (ahead > 0) {
+        w.mask = (w.mask << ahead) | 1;
+        w.last_seq = seq;
+        return false;
+    }
+    uint32_t bit = 1u << (-ahead);
+    if (w.mask & bit) {
+        return true;
+    }
+    w.mask |= bit;
+    return false;
+}
+
+void ESPNowManager::setFecGroupSize(uint8_t k) {
+    sendParity();
+    fec_encoder.setGroupSize(k);
+    if (k > 0) {
+        Serial.printf("FEC: on, 1 parity frame per %d frames\n", fec_encoder.getGroupSize());
+    } else {
+        Serial.println("FEC: off");
+    }
+}
+
+void ESPNowManager::sendParity() {
+    FecParityPacket parity;
+    size_t len = fec_encoder.buildParity(parity, config.network_id);
+    if (len == 0) {
+        return;
+    }
+    uint8_t frame[ESPNOW_MAX_FRAME_SIZE];
+    size_t frame_len = buildFrame(frame, (const uint8_t*)&parity, len, 0, nextFrameSeq());
+    if (transmit(broadcastAddress, frame, frame_len, 1)) {
+        stats.fec.parity_sent++;
+    }
+}
+
+void ESPNowManager::handleParity(const uint8_t* mac, uint8_t src_id, const FecParityPacket& parity, size_t len) {
+    stats.fec.parity_received++;
+
+    uint8_t frame[FEC_MAX_FRAME_SIZE + sizeof(AirTrailer)];
+    size_t frame_len = 0;
+    uint16_t seq = 0;
+    switch (fec_decoder.recover(src_id, parity, len, frame, frame_len, seq)) {
+        case FEC_RECOVERED: {
+            // A relay may have delivered it already
+            if (relay.checkDuplicate(src_id, 0, seq, millis())) {
+                break;
+            }
+            stats.fec.recovered++;
+            AirTrailer trailer;
+            trailer.src_id = src_id;
+            trailer.flags = 0;
+            trailer.seq = seq;
+            memcpy(frame + frame_len, &trailer, sizeof(trailer));
+            // From here on the frame is handled exactly as if it had arrived
+            onDataReceived(mac, frame, frame_len + sizeof(trailer));
+            break;
+        }
+        case FEC_UNRECOVERABLE:
+            stats.fec.unrecoverable++;
+            break;
+        default:
+            break;
+    }
+}
+
+bool ESPNowManager::handleRelay(const uint8_t* frame, size_t len, const AirTrailer& trailer) {
+    const PacketHeader* header = (const PacketHeader*)frame;
+    uint8_t space = trailer.flags & AIR_FLAG_ACK_REQUESTED;
+    
+    if (trailer.src_id == node_id) {
+        stats.relay.own_echoes++;
+        return false;
+    }
+    if (trailer.flags & AIR_FLAG_RELAYED) {
+        stats.relay.relayed_received++;
+    }
+    if (relay.checkDuplicate(trailer.src_id, space, trailer.seq, millis())) {
+        stats.relay.duplicates++;
+        // Copies of a reliable command still reach the ACK logic, which re-ACKs
+        // and suppresses them itself
+        return space != 0;
+    }
+    
+    // Nothing to carry further: out of hops, not ours to relay, or addressed to us
+    if (!relay.enabled() || airTtl(trailer.flags) == 0 || !relay.relays(header->packet_type)) {
+        return true;
+    }
+    if (header->packet_type == COMMAND && len == sizeof(CommandPacket) + sizeof(AirTrailer) &&
+        ((const CommandPacket*)frame)->target_id == node_id) {
+        return true;
+    }
+    
+    // Local delivery already happened, only the rebroadcast is policed
+    if (!rateLimiter.allowSource(trailer.src_id, millis())) {
+        stats.policing.relay_dropped++;
+        return true;
+    }
+    
+    uint8_t copy[ESPNOW_MTU];
+    memcpy(copy, frame, len);
+    AirTrailer* relayed = (AirTrailer*)(copy + len - sizeof(AirTrailer));
+    relayed->flags = (relayed->flags & ~AIR_TTL_MASK) | AIR_FLAG_RELAYED |
+                     ((airTtl(trailer.flags) - 1) << AIR_TTL_SHIFT);
+    relay.schedule(copy, len, trailer.src_id, space, trailer.seq, millis());
+    return true;
+}
+
+void ESPNowManager::update(uint32_t now_ms) {
+    // ACKs first, the originator's retransmission timer is running
+    QueuedAck acks[COMMAND_ACK_QUEUE];
+    portENTER_CRITICAL(&reliable_lock);
+    uint8_t ack_n = ack_count;
+    memcpy(acks, ack_queue, ack_n * sizeof(QueuedAck));
+    ack_count = 0;
+    portEXIT_CRITICAL(&reliable_lock);
+    for (uint8_t i = 0; i < ack_n; i++) {
+        sendCommandAck(acks[i].direct ? acks[i].mac : nullptr, acks[i].originator, acks[i].seq);
+    }
+
+    // Station a reply from the recv callback could not unicast to
+    uint8_t peer_mac[6];
+    portENTER_CRITICAL(&peer_lock);
+    bool register_peer = pending_peer_valid;
+    memcpy(peer_mac, pending_peer, 6);
+    pending_peer_valid = false;
+    portEXIT_CRITICAL(&peer_lock);
+    if (register_peer) {
+        ensurePeer(peer_mac);
+    }
+    
+    if (fec_encoder.flushDue(now_ms)) {
+        sendParity();
+    }
+    
+    uint8_t relay_frame[ESPNOW_MTU];
+    size_t relay_len = 0;
+    while (relay.popDue(now_ms, relay_frame, relay_len)) {
+        if (transmit(broadcastAddress, relay_frame, relay_len, 1)) {
+            stats.relay.rebroadcasts++;
+        }
+    }
+    
+    if (telemetry_held && tdma.enabled()) {
+        // Slots are laid out on the swarm clock; unsynchronized bridges use their own
+        int64_t now_us;
+        bool synced = timeSync.toMasterTime(esp_timer_get_time(), now_us);
+        if (tdma.canTransmit(now_us, node_id)) {
+            telemetry_held = false;
+            // One attempt, a retry would run past the slot
+            if (sendHeldTelemetry(1)) {
+                stats.tdma.sent++;
+                if (!synced) {
+                    stats.tdma.unsynced++;
+                }
+            }
+        }
+    } else if (telemetry_held && (int32_t)(now_ms - telemetry_due_ms) >= 0) {
+        telemetry_held = false;
+        sendHeldTelemetry(MAX_RETRY_COUNT);
+    }
+    
+    if (ping_interval_ms > 0 && (int32_t)(now_ms - next_ping_ms) >= 0) {
+        sendLatencyPing();
+        next_ping_ms = now_ms + ping_interval_ms;
+    }
+    expireLatencyPings();
+    
+    if (power.enabled() && (int32_t)(now_ms - next_power_ms) >= 0) {
+        adjustTxPower(now_ms);
+    }
+    
+    if (bench.running && (int32_t)(now_ms - bench.next_ms) >= 0) {
+        if (bench.next < bench.probes) {
+            sendProbe(bench.next++);
+            bench.next_ms = now_ms + (bench.next < bench.probes ? LINK_BENCH_INTERVAL_MS : LINK_BENCH_WAIT_MS);
+        } else {
+            finishBenchmark();
+        }
+    }
+    
+    for (uint8_t i = 0; i < RELIABLE_MAX_PENDING; i++) {
+        PendingCommand snapshot;
+        bool retransmit = false;
+        bool finished = false;
+        uint8_t result = DELIVERY_OK;
+
+        portENTER_CRITICAL(&reliable_lock);
+        PendingCommand& entry = pending[i];
+        if (entry.in_use) {
+            if (entry.complete) {
+                finished = true;
+            } else if ((int32_t)(now_ms - entry.next_retx_ms) >= 0) {
+                if (entry.retransmissions >= command_retries) {
+                    finished = true;
+                    result = entry.acked_count > 0 ? DELIVERY_PARTIAL : DELIVERY_FAILED;
+                } else {
+                    retransmit = true;
+                    entry.retransmissions++;
+                    entry.rto_ms = min(entry.rto_ms * 2, RELIABLE_MAX_RTO_MS);
+                    entry.next_retx_ms = now_ms + entry.rto_ms;
+                }
+            }
+            if (finished || retransmit) {
+                snapshot = entry;
+            }
+            if (finished) {
+                entry.in_use = false;
+            }
+        }
+        portEXIT_CRITICAL(&reliable_lock);
+
+        if (retransmit) {
+            // Receivers that already acknowledged drop the copy as a duplicate and re-ACK it
+            stats.reliable.retransmissions++;
+            if (!retransmitUnicast(snapshot)) {
+                transmit(broadcastAddress, snapshot.frame, sizeof(snapshot.frame), 1);
+            }
+        } else if (finished) {
+            reportDelivery(snapshot, result, result == DELIVERY_OK ? snapshot.last_ack_ms : now_ms);
+        }
+    }
+}
+
+void ESPNowManager::reportDelivery(const PendingCommand& entry, uint8_t result, uint32_t end_ms) {
+    const CommandPacket* command = (const CommandPacket*)entry.frame;
+    uint32_t latency = end_ms - entry.first_sent_ms;
+
+    switch (result) {
+        case DELIVERY_OK: stats.reliable.delivered++; break;
+        case DELIVERY_PARTIAL: stats.reliable.partial++; break;
+        default: stats.reliable.failed++; break;
+    }
+    if (result == DELIVERY_OK) {
+        stats.reliable.latency_total_ms += latency;
+        if (latency > stats.reliable.latency_max_ms) {
+            stats.reliable.latency_max_ms = latency;
+        }
+    }
+
+    DeliveryReportPacket report;
+    initPacketHeader(report.header, DELIVERY_REPORT, sizeof(report), config.network_id);
+    report.command_id = command->command_id;
+    report.target_id = command->target_id;
+    report.result = result;
+    report.retransmissions = entry.retransmissions;
+    report.expected = entry.expected_count;
+    report.acked = entry.acked_count;
+    report.latency_ms = latency > 0xFFFF ? 0xFFFF : latency;
+    sealPacket((uint8_t*)&report, sizeof(report));
+    sendToHost((uint8_t*)&report, sizeof(report));
+}
+
 bool ESPNowManager::sendStatusPacket(const StatusPacket& packet) {
     return sendWithRetry((uint8_t*)&packet, sizeof(StatusPacket));
 }
 
 bool ESPNowManager::removePeer(const uint8_t* peerAddress) {
+    portENTER_CRITICAL(&peer_lock);
+    for (uint8_t i = 0; i < UNICAST_PEER_SLOTS; i++) {
+        if (unicast_peers[i].used && memcmp(unicast_peers[i].mac, peerAddress, 6) == 0) {
+            unicast_peers[i].used = false;
+        }
+    }
+    portEXIT_CRITICAL(&peer_lock);
+    
     esp_err_t result = esp_now_del_peer(peerAddress);
     return (result == ESP_OK);
 }
 
+bool ESPNowManager::applyConfig(const ESPNowConfig& cfg) {
+    bool channel_changed = cfg.channel != config.channel;
+    bool power_changed = cfg.tx_power != config.tx_power;
+    bool network_changed = cfg.network_id != config.network_id;
+    if (!channel_changed && !power_changed && !network_changed) {
+        return false;
+    }
+    
+    if (channel_changed) {
+        config.channel = cfg.channel;
+        esp_wifi_set_channel(config.channel, WIFI_SECOND_CHAN_NONE);
+        peerInfo.channel = config.channel;
+        esp_now_mod_peer(&peerInfo);
+    }
+    if (power_changed) {
+        config.tx_power = cfg.tx_power;
+        // Under power control the configured power is only where control restarts
+        if (!power.enabled()) {
+            esp_wifi_set_max_tx_power(config.tx_power * 4);
+            stats.power.dbm = config.tx_power;
+        }
+    }
+    if (network_changed) {
+        config.network_id = cfg.network_id;
+        // Other drones behind other MACs: learn them anew
+        peerTable.clear();
+    }
+    
+    // Unicast peers are registered again on first use
+    if (channel_changed || network_changed) {
+        uint8_t macs[UNICAST_PEER_SLOTS][6];
+        uint8_t n = 0;
+        portENTER_CRITICAL(&peer_lock);
+        for (uint8_t i = 0; i < UNICAST_PEER_SLOTS; i++) {
+            if (unicast_peers[i].used) {
+                memcpy(macs[n++], unicast_peers[i].mac, 6);
+                unicast_peers[i].used = false;
+            }
+        }
+        portEXIT_CRITICAL(&peer_lock);
+        for (uint8_t i = 0; i < n; i++) {
+            esp_now_del_peer(macs[i]);
+        }
+    }
+    
+    Serial.printf("ESP-NOW reconfigured: network_id=%d, channel=%d, tx_power=%d dBm\n",
+                 config.network_id, config.channel, config.tx_power);
+    return true;
+}
+
+void ESPNowManager::startLinkBenchmark(uint8_t target_id, uint16_t probes) {
+    uint8_t mac[6];
+    if (probes == 0 || probes > LINK_BENCH_MAX_PROBES || target_id == node_id ||
+        !peerTable.lookup(target_id, mac)) {
+        Serial.printf("ERROR: Invalid link benchmark: %u probes to drone %u\n", probes, target_id);
+        return;
+    }
+
+    portENTER_CRITICAL(&bench_lock);
+    bench.running = true;
+    bench.target_id = target_id;
+    memcpy(bench.mac, mac, 6);
+    bench.probes = probes * 2;
+    bench.next = 0;
+    bench.next_ms = millis();
+    memset(bench.echoed, 0, sizeof(bench.echoed));
+    memset(bench.delivered, 0, sizeof(bench.delivered));
+    memset(bench.rtt_total_ms, 0, sizeof(bench.rtt_total_ms));
+    memset(bench.rtt_max_ms, 0, sizeof(bench.rtt_max_ms));
+    portEXIT_CRITICAL(&bench_lock);
+    Serial.printf("Link benchmark: %u probes each broadcast and unicast to drone %u\n", probes, target_id);
+}
+
+void ESPNowManager::sendProbe(uint16_t n) {
+    AckPacket probe;
+    initPacketHeader(probe.header, ACK, sizeof(probe), config.network_id);
+    probe.ack_type = PING;
+    probe.ack_id = bench.target_id;
+    probe.status = n;
+    sealPacket((uint8_t*)&probe, sizeof(probe));
+
+    uint8_t frame[sizeof(AckPacket) + sizeof(AirTrailer)];
+    size_t frame_len = buildFrame(frame, (const uint8_t*)&probe, sizeof(probe), AIR_FLAG_PROBE, n);
+    bool unicast = n % 2 == 1;
+    if (unicast && !ensurePeer(bench.mac)) {
+        return;  // Counts as lost
+    }
+    portENTER_CRITICAL(&bench_lock);
+    bench.sent_ms[n] = millis();
+    portEXIT_CRITICAL(&bench_lock);
+    transmit(unicast ? bench.mac : broadcastAddress, frame, frame_len, 1);
+}
+
+void ESPNowManager::handleProbe(const uint8_t* mac, const AckPacket& probe, uint8_t src_id, uint8_t flags) {
+    if (flags & AIR_FLAG_PROBE) {
+        // Echo probes meant for us straight back to the prober's radio
+        if (probe.ack_id != node_id) return;
+        AckPacket echo = probe;
+        echo.ack_id = src_id;
+        sealPacket((uint8_t*)&echo, sizeof(echo));
+        if (replyUnicast(mac, (const uint8_t*)&echo, sizeof(echo))) {
+            stats.unicast.probes_echoed++;
+        }
+        return;
+    }
+
+    // An echo of one of our probes
+    uint16_t n = probe.status;
+    if (probe.ack_id != node_id) return;
+    if (n & LINK_PING_FLAG) {
+        int64_t rtt_us = -1;
+        portENTER_CRITICAL(&bench_lock);
+        for (uint8_t i = 0; i < LINK_PING_SLOTS; i++) {
+            LatencyPing& ping = pings[i];
+            if (ping.used && ping.n == n && ping.target_id == src_id) {
+                rtt_us = esp_timer_get_time() - ping.sent_us;
+                ping.used = false;
+                break;
+            }
+        }
+        portEXIT_CRITICAL(&bench_lock);
+        if (rtt_us >= 0) {
+            stats.unicast.pings_answered++;
+            linkMonitor.recordRtt(src_id, (uint32_t)rtt_us, millis());
+        }
+        return;
+    }
+    uint32_t now = millis();
+    portENTER_CRITICAL(&bench_lock);
+    if (bench.running && src_id == bench.target_id && n < bench.next &&
+        !(bench.echoed[n / 32] & (1u << (n % 32)))) {
+        bench.echoed[n / 32] |= 1u << (n % 32);
+        uint32_t rtt = now - bench.sent_ms[n];
+        bench.delivered[n % 2]++;
+        bench.rtt_total_ms[n % 2] += rtt;
+        if (rtt > bench.rtt_max_ms[n % 2]) {
+            bench.rtt_max_ms[n % 2] = rtt;
+        }
+    }
+    portEXIT_CRITICAL(&bench_lock);
+}
+
+void ESPNowManager::setPingInterval(uint32_t interval_ms) {
+    ping_interval_ms = interval_ms > 0 ? max(interval_ms, (uint32_t)LINK_PING_MIN_INTERVAL_MS) : 0;
+    next_ping_ms = millis();
+    Serial.printf("Latency monitor: %s (%lu ms)\n", ping_interval_ms > 0 ? "on" : "off",
+                 (unsigned long)ping_interval_ms);
+}
+
+void ESPNowManager::sendLatencyPing() {
+    // Next peer whose MAC is known, round robin over drone ids
+    uint8_t target = ping_cursor;
+    uint8_t mac[6];
+    bool found = false;
+    for (uint16_t i = 0; i < 256 && !found; i++) {
+        target++;
+        found = target != node_id && peerTable.lookup(target, mac);
+    }
+    if (!found || !ensurePeer(mac)) return;
+    ping_cursor = target;
+
+    uint16_t n = LINK_PING_FLAG | (ping_seq++ & ~LINK_PING_FLAG);
+    AckPacket ping;
+    initPacketHeader(ping.header, ACK, sizeof(ping), config.network_id);
+    ping.ack_type = PING;
+    ping.ack_id = target;
+    ping.status = n;
+    sealPacket((uint8_t*)&ping, sizeof(ping));
+
+    uint8_t frame[sizeof(AckPacket) + sizeof(AirTrailer)];
+    size_t frame_len = buildFrame(frame, (const uint8_t*)&ping, sizeof(ping), AIR_FLAG_PROBE, n);
+
+    // A free slot; all busy means the link is already known to be bad
+    bool claimed = false;
+    portENTER_CRITICAL(&bench_lock);
+    for (uint8_t i = 0; i < LINK_PING_SLOTS; i++) {
+        LatencyPing& slot = pings[i];
+        if (!slot.used) {
+            slot.used = true;
+            slot.target_id = target;
+            slot.n = n;
+            slot.sent_us = esp_timer_get_time();
+            claimed = true;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&bench_lock);
+    if (!claimed) return;
+
+    transmit(mac, frame, frame_len, 1);
+    stats.unicast.pings_sent++;
+}
+
+void ESPNowManager::expireLatencyPings() {
+    int64_t cutoff_us = esp_timer_get_time() - (int64_t)LINK_PING_TIMEOUT_MS * 1000;
+    portENTER_CRITICAL(&bench_lock);
+    for (uint8_t i = 0; i < LINK_PING_SLOTS; i++) {
+        if (pings[i].used && pings[i].sent_us < cutoff_us) {
+            pings[i].used = false;
+            stats.unicast.pings_lost++;
+        }
+    }
+    portEXIT_CRITICAL(&bench_lock);
+}
+
+void ESPNowManager::finishBenchmark() {
+    portENTER_CRITICAL(&bench_lock);
+    bench.running = false;
+    LinkBenchmark result = bench;
+    portEXIT_CRITICAL(&bench_lock);
+
+    uint16_t per_mode = result.probes / 2;
+    stats.unicast.bench_probes = per_mode;
+    static const char* const modes[2] = {"broadcast", "unicast"};
+    for (uint8_t m = 0; m < 2; m++) {
+        stats.unicast.bench_delivered[m] = result.delivered[m];
+        stats.unicast.bench_rtt_ms[m] = result.delivered[m] > 0 ? (float)result.rtt_total_ms[m] / result.delivered[m] : 0.0f;
+        Serial.printf("Link benchmark %s: %u/%u delivered (%.1f%%), RTT avg %.1f ms, max %lu ms\n",
+                     modes[m], result.delivered[m], per_mode, result.delivered[m] * 100.0f / per_mode,
+                     stats.unicast.bench_rtt_ms[m], (unsigned long)result.rtt_max_ms[m]);
+    }
+}
+
 void ESPNowManager::setTxPower(int power) {
     config.tx_power = power;
     esp_wifi_set_max_tx_power(power * 4);
@@ -181,13 +1134,151 @@ bool ESPNowManager::sendBroadcast(const uint8_t* data, size_t len) {
     return (result == ESP_OK);
 }
 
+void ESPNowManager::setRxMeta(bool enabled) {
+    rx_meta_enabled = enabled;
+    updatePromiscuous();
+    Serial.printf("RX metadata %s\n", enabled ? "on" : "off");
+}
+
+bool ESPNowManager::setFilterRule(uint8_t index, const FilterRule& rule) {
+    portENTER_CRITICAL(&filter_lock);
+    bool ok = filter.setRule(index, rule);
+    portEXIT_CRITICAL(&filter_lock);
+    if (!ok) {
+        Serial.printf("ERROR: Invalid filter rule %d\n", index);
+    }
+    return ok;
+}
+
+void ESPNowManager::clearFilter() {
+    portENTER_CRITICAL(&filter_lock);
+    filter.clear();
+    portEXIT_CRITICAL(&filter_lock);
+    Serial.println("Host filter cleared");
+}
+
+uint32_t ESPNowManager::readFilterRule(uint8_t index, FilterRule& rule) {
+    uint32_t hits;
+    portENTER_CRITICAL(&filter_lock);
+    if (index < FILTER_MAX_RULES) {
+        rule = filter.getRule(index);
+        hits = filter.getHits(index);
+    } else {
+        rule = FilterRule();
+        hits = filter.getDefaultHits();
+    }
+    portEXIT_CRITICAL(&filter_lock);
+    return hits;
+}
+
+void ESPNowManager::subscribeNetwork(uint8_t network_id, bool subscribe) {
+    if (network_id == 0) {
+        memset(subscribed_networks, 0, sizeof(subscribed_networks));
+        Serial.println("Unsubscribed from all other networks");
+        return;
+    }
+    uint32_t bit = 1u << (network_id % 32);
+    if (subscribe) {
+        subscribed_networks[network_id / 32] |= bit;
+    } else {
+        subscribed_networks[network_id / 32] &= ~bit;
+    }
+    Serial.printf("Network %d %s\n", network_id, subscribe ? "subscribed" : "unsubscribed");
+}
+
+void ESPNowManager::setTxPowerControl(int8_t min_dbm, int8_t max_dbm) {
+    power.configure(min_dbm, max_dbm, config.tx_power);
+    updatePromiscuous();
+    if (power.enabled()) {
+        power_acked = stats.unicast.link_acked;
+        power_failed = stats.unicast.link_failed;
+        next_power_ms = millis() + TX_POWER_PERIOD_MS;
+        Serial.printf("TX power control: %d..%d dBm\n", power.getMin(), power.getMax());
+    } else {
+        Serial.printf("TX power control: off, %d dBm\n", config.tx_power);
+    }
+    esp_wifi_set_max_tx_power((power.enabled() ? power.getPower() : config.tx_power) * 4);
+    stats.power.dbm = power.enabled() ? power.getPower() : config.tx_power;
+}
+
+void ESPNowManager::updatePromiscuous() {
+    bool enabled = rx_meta_enabled || power.enabled();
+    if (enabled) {
+        // ESP-NOW travels in vendor-specific action frames
+        wifi_promiscuous_filter_t filter = {.filter_mask = WIFI_PROMIS_FILTER_MASK_MGMT};
+        esp_wifi_set_promiscuous_filter(&filter);
+        esp_wifi_set_promiscuous_rx_cb(onPromiscuousRx);
+    }
+    last_radio.valid = false;
+    esp_err_t result = esp_wifi_set_promiscuous(enabled);
+    if (result != ESP_OK) {
+        Serial.printf("Failed to switch promiscuous mode: 0x%X\n", result);
+    }
+}
+
+void ESPNowManager::adjustTxPower(uint32_t now_ms) {
+    next_power_ms = now_ms + TX_POWER_PERIOD_MS;
+    
+    // Frames from peers tell how well we hear them, link-layer ACKs of our
+    // unicast frames how well they hear us
+    LinkQuality quality;
+    linkMonitor.sampleQuality(quality);
+    unsigned long acked = stats.unicast.link_acked;
+    unsigned long failed = stats.unicast.link_failed;
+    quality.expected += (acked - power_acked) + (failed - power_failed);
+    quality.lost += failed - power_failed;
+    power_acked = acked;
+    power_failed = failed;
+    
+    int8_t previous = power.getPower();
+    int8_t dbm = power.evaluate(quality);
+    if (dbm != previous) {
+        esp_wifi_set_max_tx_power(dbm * 4);
+        if (dbm > previous) {
+            stats.power.raised++;
+        } else {
+            stats.power.lowered++;
+        }
+    }
+    stats.power.dbm = dbm;
+    stats.power.peers = quality.peers;
+    stats.power.min_rssi = quality.min_rssi;
+}
+
+void ESPNowManager::onPromiscuousRx(void* buf, wifi_promiscuous_pkt_type_t type) {
+    if (!instance || type != WIFI_PKT_MGMT) return;
+    const wifi_promiscuous_pkt_t* pkt = (const wifi_promiscuous_pkt_t*)buf;
+    const uint8_t* frame = pkt->payload;
+    // Action frame, category vendor specific, Espressif OUI
+    if (pkt->rx_ctrl.sig_len < 28 || frame[0] != 0xD0 || frame[24] != 0x7F ||
+        frame[25] != 0x18 || frame[26] != 0xFE || frame[27] != 0x34) {
+        return;
+    }
+    RadioSample& sample = instance->last_radio;
+    memcpy(sample.mac, frame + 10, 6);  // addr2, the transmitter
+    sample.rssi = pkt->rx_ctrl.rssi;
+    sample.noise_floor = pkt->rx_ctrl.noise_floor;
+    sample.valid = true;
+}
+
 void ESPNowManager::setChannel(int channel) {
     esp_wifi_set_channel(channel, WIFI_SECOND_CHAN_NONE);
 }
 
 void ESPNowManager::onDataSent(const uint8_t *mac_addr, esp_now_send_status_t status) {
     if (instance) {
+        // Only unicast frames are acknowledged by the receiving radio
+        if (memcmp(mac_addr, instance->broadcastAddress, 6) != 0) {
+            if (status == ESP_NOW_SEND_SUCCESS) {
+                stats.unicast.link_acked++;
+            } else {
+                stats.unicast.link_failed++;
+            }
+        }
         if (status != ESP_NOW_SEND_SUCCESS) {
+            if (memcmp(mac_addr, instance->broadcastAddress, 6) == 0) {
+                instance->noteChannelBusy();
+            }
             instance->send_failures++;
             Serial.printf("ERROR: ESP-NOW send failed to %02X:%02X:%02X:%02X:%02X:%02X\n",
                          mac_addr[0], mac_addr[1], mac_addr[2], 
@@ -198,6 +1289,7 @@ void ESPNowManager::onDataSent(const uint8_t *mac_addr, esp_now_send_status_t st
 
 void ESPNowManager::onDataReceived(const uint8_t *mac_addr, const uint8_t *incomingData, int len) {
     if (!instance) return;
+    int64_t rx_us = esp_timer_get_time();  // Arrival time for clock synchronization
     
     instance->packets_received++;
     
@@ -219,117 +1311,275 @@ void ESPNowManager::onDataReceived(const uint8_t *mac_addr, const uint8_t *incom
         return;
     }
     
-    // Filter by network_id
-    if (header->network_id != instance->config.network_id) {
-        // Silently drop packets from different networks
-        Serial.printf("DEBUG: Dropping packet from network %d (expected %d)\n", 
-                     header->network_id, instance->config.network_id);
+    // Filter by network_id; foreign traffic can be heavy, count it without logging
+    if (!instance->isSubscribed(header->network_id)) {
+        stats.networks.unsubscribed_dropped++;
         return;
     }
     
-    // Validate packet size
-    if (len != sizeof(PacketHeader) + header->payload_size) {
+    // Validate packet size, with or without the air trailer
+    int packet_len = sizeof(PacketHeader) + header->payload_size;
+    const AirTrailer* trailer = nullptr;
+    if (len == packet_len + (int)sizeof(AirTrailer)) {
+        trailer = (const AirTrailer*)(incomingData + packet_len);
+    } else if (len != packet_len) {
         instance->receive_errors++;
         stats.espnow.packets_corrupted++;
         Serial.printf("DEBUG: Packet size mismatch: %d != %d + %d\n", 
                      len, sizeof(PacketHeader), header->payload_size);
         return;
     }
+    len = packet_len;  // The trailer never reaches the host
+    
+    // Subscribed networks other than ours go straight to the host
+    if (header->network_id != instance->config.network_id) {
+        stats.networks.foreign_forwarded++;
+        if (!instance->forwardToHost(mac_addr, incomingData, len, trailer, rx_us)) {
+            instance->receive_errors++;
+        }
+        return;
+    }
     
-    // Validate CRC for packets that have it
-    if (header->packet_type == OTA_CONFIG && len >= sizeof(OtaConfigPacket)) {
-        const OtaConfigPacket* packet = (const OtaConfigPacket*)incomingData;
-        uint16_t calculated_crc = calculateCRC16(incomingData, len - 2);
-        if (calculated_crc != packet->crc) {
+    // Validate CRC for packets the bridge acts on itself
+    if (header->packet_type == OTA_CONFIG || header->packet_type == TELEMETRY ||
+        header->packet_type == DRONE_STATUS || header->packet_type == COMMAND ||
+        header->packet_type == ACK || header->packet_type == BULK_DATA ||
+        header->packet_type == STREAM_DATA || header->packet_type == STREAM_ACK ||
+        header->packet_type == FEC_PARITY || header->packet_type == TIME_SYNC ||
+        header->packet_type == CHANNEL_SWITCH || header->packet_type == STATS) {
+        // OTA_CONFIG has always left two more bytes out, the controller still does
+        size_t crc_span = header->packet_type == OTA_CONFIG ? len - 2 : len;
+        uint16_t calculated_crc = calculateCRC16(incomingData, crc_span);
+        uint16_t received_crc;
+        memcpy(&received_crc, incomingData + len - 2, sizeof(received_crc));
+        if (calculated_crc != received_crc) {
             instance->receive_errors++;
             stats.espnow.packets_corrupted++;
             Serial.printf("ERROR: ESP-NOW CRC mismatch - Type: %d, Calc: 0x%04X, Recv: 0x%04X\n",
-                header->packet_type, calculated_crc, packet->crc);
+                header->packet_type, calculated_crc, received_crc);
             return;
         }
     }
     
+    // Time to first frame after a channel switch
+    channelSwitch.onFrame(rx_us);
+    
+    // Mesh relay: drop copies, queue new frames that may travel further
+    if (trailer && (airTtl(trailer->flags) > 0 || (trailer->flags & AIR_FLAG_RELAYED))) {
+        if (!instance->handleRelay(incomingData, packet_len + sizeof(AirTrailer), *trailer)) {
+            return;
+        }
+    }
+    
+    // Remember who sits behind this MAC for unicast replies; a relay's MAC says
+    // nothing about the originator
+    if (trailer && !(trailer->flags & AIR_FLAG_RELAYED)) {
+        peerTable.learn(trailer->src_id, mac_addr);
+    }
+    
+    // Per-peer delivery ratio from the gaps in broadcast sequence numbers
+    if (trailer && airDirectBroadcast(trailer->flags)) {
+        linkMonitor.track(trailer->src_id, trailer->seq, millis());
+    }
+    
+    // Signal strength of this frame, when promiscuous mode caught it
+    const RadioSample& radio = instance->last_radio;
+    bool measured = radio.valid && memcmp(radio.mac, mac_addr, 6) == 0;
+    bool direct = measured && trailer && !(trailer->flags & AIR_FLAG_RELAYED);
+    if (direct) {
+        linkMonitor.recordRssi(trailer->src_id, radio.rssi);
+    }
+    if (trailer) {
+        swarmTable.recordFrame(trailer->src_id, direct, radio.rssi, millis());
+    }
+    
     // Update statistics for valid packets
     stats.espnow.packets_received++;
     stats.espnow.packets_received_last_interval++;
     stats.espnow.bytes_received += len;
-    stats.espnow.by_type[header->packet_type].packets_received++;
-    stats.espnow.by_type[header->packet_type].bytes_received += len;
+    if (header->packet_type < PACKET_TYPE_COUNT) {
+        stats.espnow.by_type[header->packet_type].packets_received++;
+        stats.espnow.by_type[header->packet_type].bytes_received += len;
+    }
+    
+    // Small plain broadcast frames are kept until their group's parity arrives
+    if (header->packet_type == FEC_PARITY) {
+        if (trailer && len > (int)(offsetof(FecParityPacket, parity) + sizeof(PacketHeader) + sizeof(uint16_t))) {
+            instance->handleParity(mac_addr, trailer->src_id, *(const FecParityPacket*)incomingData, len);
+        }
+        return;
+    }
+    if (trailer && airDirectBroadcast(trailer->flags)) {
+        instance->fec_decoder.remember(trailer->src_id, trailer->seq, incomingData, len, millis());
+    }
+    
+    // Bulk fragments reach the host only as complete blobs
+    if (header->packet_type == BULK_DATA) {
+        if (len >= (int)(offsetof(BulkDataPacket, data) + sizeof(uint16_t))) {
+            bulkTransfer.handleFragment(*(const BulkDataPacket*)incomingData, len, millis());
+        }
+        return;
+    }
+    
+    // Stream segments and their acknowledgements are addressed to us by MAC
+    if (header->packet_type == STREAM_DATA) {
+        if (trailer && len >= (int)(offsetof(StreamDataPacket, data) + sizeof(uint16_t))) {
+            streamManager.handleSegment(mac_addr, trailer->src_id, *(const StreamDataPacket*)incomingData, len);
+        }
+        return;
+    }
+    if (header->packet_type == STREAM_ACK) {
+        if (trailer && len == sizeof(StreamAckPacket)) {
+            streamManager.handleAck(trailer->src_id, *(const StreamAckPacket*)incomingData);
+        }
+        return;
+    }
+    
+    // Clock synchronization stays between the bridges
+    if (header->packet_type == TIME_SYNC) {
+        if (trailer && len == sizeof(TimeSyncPacket)) {
+            timeSync.handleAir(mac_addr, trailer->src_id, !(trailer->flags & AIR_FLAG_RELAYED),
+                               *(const TimeSyncPacket*)incomingData, rx_us);
+        }
+        return;
+    }
+    
+    // Channel switch announcements stay between the bridges, the host hears the report
+    if (header->packet_type == CHANNEL_SWITCH) {
+        if (len == sizeof(ChannelSwitchPacket)) {
+            channelSwitch.handleAir(*(const ChannelSwitchPacket*)incomingData, rx_us);
+        }
+        return;
+    }
+    
+    // Statistics requests are answered from loop(), replies go on to the host
+    if (header->packet_type == STATS && len == sizeof(StatsPacket)) {
+        const StatsPacket* packet = (const StatsPacket*)incomingData;
+        if (packet->op == STATS_REQUEST) {
+            remoteStats.handleAir(mac_addr, trailer, *packet);
+            return;
+        }
+        stats.remote.replies_received++;
+    }
+    
+    // Reliable command acknowledgements and link benchmark probes are consumed here
+    if (header->packet_type == ACK && len == sizeof(AckPacket) &&
+        ((const AckPacket*)incomingData)->ack_type == COMMAND) {
+        if (trailer) {
+            instance->handleCommandAck(*(const AckPacket*)incomingData, trailer->src_id);
+        }
+        return;
+    }
+    if (header->packet_type == ACK && len == sizeof(AckPacket) &&
+        ((const AckPacket*)incomingData)->ack_type == PING) {
+        if (trailer) {
+            instance->handleProbe(mac_addr, *(const AckPacket*)incomingData, trailer->src_id, trailer->flags);
+        }
+        return;
+    }
+    
+    // Acknowledge reliable commands meant for us, deliver each one only once
+    if (header->packet_type == COMMAND && len == sizeof(CommandPacket) &&
+        trailer && (trailer->flags & AIR_FLAG_ACK_REQUESTED)) {
+        const CommandPacket* packet = (const CommandPacket*)incomingData;
+        if (packet->target_id == COMMAND_TARGET_ALL || packet->target_id == instance->node_id) {
+            const uint8_t* reply_mac = (trailer->flags & AIR_FLAG_RELAYED) ? nullptr : mac_addr;
+            instance->queueCommandAck(reply_mac, trailer->src_id, trailer->seq);
+        }
+        if (instance->isDuplicate(trailer->src_id, trailer->seq)) {
+            stats.reliable.duplicates_suppressed++;
+            return;
+        }
+    }
     
-    // Handle OTA_CONFIG packets (приходят по ESP-NOW)
+    // Keep the swarm table current; in snapshot mode telemetry stops here
+    if (header->packet_type == TELEMETRY && len == sizeof(TelemetryPacket)) {
+        const TelemetryPacket* packet = (const TelemetryPacket*)incomingData;
+        uint32_t now = millis();
+        swarmTable.updateTelemetry(*packet, now);
+        // Conflict alerts go to the host before anything else, whatever the forwarding mode
+        swarmTable.checkConflict(packet->drone_id, now);
+        if (swarmTable.snapshotsEnabled()) {
+            stats.swarm.telemetry_absorbed++;
+            return;
+        }
+        if (swarmTable.interestEnabled()) {
+            if (!swarmTable.isOfInterest(packet->drone_id)) {
+                stats.swarm.interest_filtered++;
+                return;
+            }
+            stats.swarm.interest_forwarded++;
+        }
+    } else if (header->packet_type == DRONE_STATUS && len == sizeof(StatusPacket)) {
+        swarmTable.updateStatus(*(const StatusPacket*)incomingData, millis());
+    }
+    
+    // Handle OTA_CONFIG packets (приходят по ESP-NOW): saving and the restart
+    // take seconds, the control worker does them
     if (header->packet_type == OTA_CONFIG) {
         if (len >= sizeof(OtaConfigPacket)) {
             const OtaConfigPacket* packet = (const OtaConfigPacket*)incomingData;
-            Serial.printf("Received OTA_CONFIG via ESP-NOW for drone %d:\n", packet->drone_id);
-            Serial.printf("  Config flags: 0x%02X\n", packet->config_flags);
-            Serial.printf("  SSID: '%s' (length: %d)\n", packet->ssid, strlen(packet->ssid));
-            Serial.printf("  Password: '%s' (length: %d)\n", packet->password, strlen(packet->password));
-            Serial.printf("  OTA URL: '%s' (length: %d)\n", packet->ota_url, strlen(packet->ota_url));
-            
-            // Validate WiFi credentials
-            if (strlen(packet->ssid) == 0) {
-                Serial.println("ERROR: WiFi SSID is empty in OTA_CONFIG packet");
-                return;
-            }
-            
-            if (strlen(packet->ssid) > 23) {
-                Serial.printf("ERROR: WiFi SSID too long: %d characters (max 23)\n", strlen(packet->ssid));
-                return;
-            }
-            
-            if (strlen(packet->password) > 31) {
-                Serial.printf("ERROR: WiFi password too long: %d characters (max 31)\n", strlen(packet->password));
-                return;
-            }
-            
-            // Save all configuration data to SPIFFS
-            Serial.println("  -> Saving configuration data to SPIFFS...");
-            
-            // Save WiFi configuration
-            bool wifi_saved = updateWiFiConfig(packet->ssid, packet->password);
-            if (!wifi_saved) {
-                Serial.println("ERROR: Failed to save WiFi configuration");
-                return;
-            }
-            
-            // Save OTA URL if provided 
-            bool ota_saved = true;
-            if (strlen(packet->ota_url) > 0) {
-                ota_saved = saveOTAUrl(packet->ota_url);
-                if (!ota_saved) {
-                    Serial.println("ERROR: Failed to save OTA URL");
-                    return;
-                }
-            }
-            
-            // Create pending OTA file to trigger update after reboot
-            StaticJsonDocument<512> pending_doc;
-            pending_doc["pending_ota"] = true;
-            pending_doc["timestamp"] = millis();
-            
-            File pending_file = SPIFFS.open("/pending_ota.json", "w");
-            if (pending_file) {
-                serializeJson(pending_doc, pending_file);
-                pending_file.close();
-                Serial.println("  -> Pending OTA file created");
-            } else {
-                Serial.println("ERROR: Failed to create pending OTA file");
-                return;
-            }
-            
-            Serial.println("  -> All configuration saved successfully");
-            Serial.println("  -> Restarting device to apply configuration...");
-            delay(2000);
-            ESP.restart();
+            ControlItem item;
+            item.type = WORK_OTA_CONFIG;
+            item.drone_id = packet->drone_id;
+            strlcpy(item.ssid, packet->ssid, sizeof(item.ssid));
+            strlcpy(item.password, packet->password, sizeof(item.password));
+            strlcpy(item.ota_url, packet->ota_url, sizeof(item.ota_url));
+            controlWorker.post(item);
         }
+        return;
     }
     
     // Forward all other packets to UART (для ROS)
-    size_t written = Serial1.write(incomingData, len);
-    if (written == len) {
-        Serial1.flush();
-    } else {
+    if (!instance->forwardToHost(mac_addr, incomingData, len, trailer, rx_us)) {
         instance->receive_errors++;
-        Serial.println("ERROR: Failed to forward ESP-NOW packet to UART");
     }
-}
\ No newline at end of file
+}
+
+bool ESPNowManager::forwardToHost(const uint8_t* mac, const uint8_t* data, size_t len, const AirTrailer* trailer,
+                                  int64_t rx_us) {
+    // Host filter before anything is queued for the UART
+    uint32_t start = ESP.getCycleCount();
+    portENTER_CRITICAL(&filter_lock);
+    bool active = filter.active();
+    bool pass = !active || filter.pass(data, len);
+    portEXIT_CRITICAL(&filter_lock);
+    if (active) {
+        stats.filter.cycles += ESP.getCycleCount() - start;
+        stats.filter.evaluated++;
+        if (!pass) {
+            stats.filter.dropped++;
+            return true;
+        }
+    }
+    
+    if (!rx_meta_enabled) {
+        return sendToHost(data, len);
+    }
+    
+    RxMetaPacket meta;
+    memset(&meta, 0, sizeof(meta));
+    initPacketHeader(meta.header, RX_META, sizeof(meta), ((const PacketHeader*)data)->network_id);
+    if (last_radio.valid && memcmp(last_radio.mac, mac, 6) == 0) {
+        meta.rssi = last_radio.rssi;
+        meta.noise_floor = last_radio.noise_floor;
+        meta.flags |= RX_META_FLAG_RSSI;
+    }
+    int64_t swarm_us;
+    if (timeSync.toMasterTime(rx_us, swarm_us)) {
+        meta.rx_us = swarm_us;
+        meta.flags |= RX_META_FLAG_SWARM_TIME;
+    } else {
+        meta.rx_us = rx_us;
+    }
+    if (trailer) {
+        meta.src_id = trailer->src_id;
+        meta.flags |= RX_META_FLAG_SRC_ID;
+        if (trailer->flags & AIR_FLAG_RELAYED) {
+            meta.flags |= RX_META_FLAG_RELAYED;
+        }
+    }
+    memcpy(meta.mac, mac, 6);
+    sealPacket((uint8_t*)&meta, sizeof(meta));
+    return sendToHost((const uint8_t*)&meta, sizeof(meta), data, len);
+}
@@ -4,13 +4,42 @@
 #include <Arduino.h>
 #include <esp_now.h>
 #include <esp_wifi.h>
+#include <esp_timer.h>
 #include "Packet.h"
+#include "FecCodec.h"
+#include "MeshRelay.h"
+#include "TdmaScheduler.h"
+#include "TxJitter.h"
+#include "TxPowerController.h"
+#include "FrameFilter.h"
 
 #define MAX_PEERS 20
 #define BROADCAST_MAC {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}
 #define MAX_RETRY_COUNT 3
 #define SEND_TIMEOUT_MS 100
 
+// Reliable COMMAND delivery
+#define RELIABLE_MAX_PENDING 8
+#define RELIABLE_INITIAL_RTO_MS 30
+#define RELIABLE_MAX_RTO_MS 480
+#define DUPLICATE_WINDOW 32  // Reliable sequence numbers remembered per originator
+#define COMMAND_ACK_QUEUE 8  // ACKs waiting for loop()
+
+// Unicast peers
+#define UNICAST_PEER_SLOTS (MAX_PEERS - 1)  // The broadcast peer takes one ESP-NOW slot
+#define UNICAST_RETX_MAX_TARGETS 3          // More missing ackers than this: retransmit as broadcast
+
+// Link benchmark: probes alternate between broadcast and unicast
+#define LINK_BENCH_MAX_PROBES 100  // Per mode
+#define LINK_BENCH_INTERVAL_MS 10
+#define LINK_BENCH_WAIT_MS 500     // For late echoes after the last probe
+
+// Latency monitor: background unicast pings to one known peer after another
+#define LINK_PING_FLAG 0x8000          // In the probe number: a monitor ping, not a benchmark probe
+#define LINK_PING_SLOTS 4              // Pings awaiting their echo
+#define LINK_PING_TIMEOUT_MS 1000      // Unanswered this long: lost
+#define LINK_PING_MIN_INTERVAL_MS 20
+
 // Production ESP-NOW configuration
 struct ESPNowConfig {
     uint8_t channel = 1;
@@ -19,6 +48,80 @@ struct ESPNowConfig {
     uint8_t network_id = 0x12;
 };
 
+// A reliable COMMAND waiting for acknowledgements
+struct PendingCommand {
+    bool in_use = false;
+    bool complete = false;
+    bool unicast = false;  // Addressed to one drone whose MAC is known
+    uint8_t mac[6];
+    uint16_t seq = 0;
+    uint8_t frame[sizeof(CommandPacket) + sizeof(AirTrailer)];
+    uint32_t expected[8];  // Bitmap of drone ids that must acknowledge
+    uint32_t acked[8];
+    uint8_t expected_count = 0;
+    uint8_t acked_count = 0;
+    uint8_t retransmissions = 0;
+    uint16_t rto_ms = 0;
+    uint32_t first_sent_ms = 0;
+    uint32_t next_retx_ms = 0;
+    uint32_t last_ack_ms = 0;
+};
+
+// A station registered with ESP-NOW for unicast, evicted least recently used first
+struct UnicastPeer {
+    bool used = false;
+    bool ready = false;  // Registered with ESP-NOW, the recv callback may send to it
+    uint8_t mac[6];
+    uint32_t last_used_ms = 0;
+};
+
+// Broadcast vs unicast delivery ratio and round-trip time to one drone.
+// Probe n goes out as broadcast when n is even, as unicast when odd.
+struct LinkBenchmark {
+    bool running = false;
+    uint8_t target_id = 0;
+    uint8_t mac[6];
+    uint16_t probes = 0;   // Both modes together
+    uint16_t next = 0;
+    uint32_t next_ms = 0;
+    uint32_t sent_ms[2 * LINK_BENCH_MAX_PROBES];
+    uint32_t echoed[(2 * LINK_BENCH_MAX_PROBES + 31) / 32];
+    uint16_t delivered[2];  // Indexed by probe n % 2
+    uint32_t rtt_total_ms[2];
+    uint32_t rtt_max_ms[2];
+};
+
+// A latency monitor ping awaiting its echo
+struct LatencyPing {
+    bool used = false;
+    uint8_t target_id = 0;
+    uint16_t n = 0;
+    int64_t sent_us = 0;
+};
+
+// Radio measurements of the last ESP-NOW frame heard in promiscuous mode
+struct RadioSample {
+    bool valid = false;
+    uint8_t mac[6];
+    int8_t rssi = 0;
+    int8_t noise_floor = 0;
+};
+
+// Last reliable sequence numbers seen from one originator
+struct DuplicateWindow {
+    bool valid = false;
+    uint16_t last_seq = 0;
+    uint32_t mask = 0;  // Bit n set: last_seq - n already delivered
+};
+
+// ACK owed for a reliable COMMAND, queued in the recv callback
+struct QueuedAck {
+    bool direct = false;  // Heard straight from the originator, mac is its radio
+    uint8_t mac[6];
+    uint8_t originator = 0;
+    uint16_t seq = 0;
+};
+
 class ESPNowManager {
 private:
     uint8_t broadcastAddress[6] = BROADCAST_MAC;
@@ -31,18 +134,121 @@ private:
     uint32_t packets_received = 0;
     uint32_t send_failures = 0;
     uint32_t receive_errors = 0;
+
+    // Air framing; sequence numbers are taken under seq_lock
+    portMUX_TYPE seq_lock = portMUX_INITIALIZER_UNLOCKED;
+    uint8_t node_id = 0;
+    uint16_t frame_seq = 0;
+    uint16_t reliable_seq = 0;
+    uint16_t unicast_seq = 0;
+
+    // Reliable commands; the recv callback and loop() share these
+    portMUX_TYPE reliable_lock = portMUX_INITIALIZER_UNLOCKED;
+    uint8_t command_retries = 0;
+    PendingCommand pending[RELIABLE_MAX_PENDING];
+    DuplicateWindow dup_window[256];
+    QueuedAck ack_queue[COMMAND_ACK_QUEUE];
+    uint8_t ack_count = 0;
+
+    // Forward error correction on plain broadcast frames
+    FecEncoder fec_encoder;
+    FecDecoder fec_decoder;
+
+    // ESP-NOW peer registrations, made from loop() only; the recv callback
+    // looks them up and leaves a station it wants registered in pending_peer
+    portMUX_TYPE peer_lock = portMUX_INITIALIZER_UNLOCKED;
+    UnicastPeer unicast_peers[UNICAST_PEER_SLOTS];
+    bool pending_peer_valid = false;
+    uint8_t pending_peer[6];
+
+    // Multi-hop flooding of relayable broadcast frames
+    MeshRelay relay;
+
+    // Channel access for periodic traffic: the latest telemetry frame waits
+    // for our TDMA slot or its random jitter delay, loop() only
+    TdmaScheduler tdma;
+    TxJitter jitter;
+    // Broadcasts that could not go out, counted wherever they fail and
+    // handed to the jitter backoff by loop()
+    portMUX_TYPE busy_lock = portMUX_INITIALIZER_UNLOCKED;
+    uint16_t busy_count = 0;
+    TelemetryPacket held_telemetry;
+    bool telemetry_held = false;
+    uint32_t telemetry_due_ms = 0;
+
+    // RX_META for the host. The promiscuous callback sees every frame just
+    // before the ESP-NOW receive callback, both in the WiFi task.
+    bool rx_meta_enabled = false;
+    RadioSample last_radio;
+
+    // Other networks whose frames go to the host, bit n for network_id n.
+    // Written from loop(), read word by word in the recv callback.
+    uint32_t subscribed_networks[8] = {0};
+
+    // Frames forwarded to the host, rules set from loop()
+    portMUX_TYPE filter_lock = portMUX_INITIALIZER_UNLOCKED;
+    FrameFilter filter;
+    
+    // Closed-loop TX power, decided in loop() once per period
+    TxPowerController power;
+    uint32_t next_power_ms = 0;
+    unsigned long power_acked = 0;   // Unicast link-layer outcomes at the last decision
+    unsigned long power_failed = 0;
+
+    // Echoes arrive in the recv callback
+    portMUX_TYPE bench_lock = portMUX_INITIALIZER_UNLOCKED;
+    LinkBenchmark bench;
+    LatencyPing pings[LINK_PING_SLOTS];
+    uint32_t ping_interval_ms = 0;
+    uint32_t next_ping_ms = 0;
+    uint16_t ping_seq = 0;
+    uint8_t ping_cursor = 0;  // Last drone_id pinged
     
     static void onDataSent(const uint8_t *mac_addr, esp_now_send_status_t status);
     static void onDataReceived(const uint8_t *mac_addr, const uint8_t *incomingData, int len);
+    static void onPromiscuousRx(void* buf, wifi_promiscuous_pkt_type_t type);
     
     bool validatePacket(const uint8_t* data, size_t len);
     bool sendWithRetry(const uint8_t* data, size_t len, uint8_t retries = MAX_RETRY_COUNT);
+    size_t buildFrame(uint8_t* frame, const uint8_t* data, size_t len, uint8_t flags, uint16_t seq);
+    bool transmit(const uint8_t* dest, const uint8_t* frame, size_t len, uint8_t retries);
+    bool ensurePeer(const uint8_t* mac);
+    bool touchPeer(const uint8_t* mac);
+    uint16_t nextFrameSeq();
+    uint16_t nextUnicastSeq();
+
+    bool sendReliableCommand(const CommandPacket& packet);
+    void queueCommandAck(const uint8_t* mac, uint8_t originator, uint16_t seq);
+    void sendCommandAck(const uint8_t* mac, uint8_t originator, uint16_t seq);
+    void handleCommandAck(const AckPacket& ack, uint8_t acker);
+    bool isDuplicate(uint8_t originator, uint16_t seq);
+    void reportDelivery(const PendingCommand& entry, uint8_t result, uint32_t end_ms);
+    void sendParity();
+    void handleParity(const uint8_t* mac, uint8_t src_id, const FecParityPacket& parity, size_t len);
+    bool retransmitUnicast(const PendingCommand& entry);
+    // False when the frame is a copy that must go no further
+    bool handleRelay(const uint8_t* frame, size_t len, const AirTrailer& trailer);
+    void sendProbe(uint16_t n);
+    void handleProbe(const uint8_t* mac, const AckPacket& probe, uint8_t src_id, uint8_t flags);
+    void finishBenchmark();
+    void sendLatencyPing();
+    void releaseHeldTelemetry();
+    void noteChannelBusy();
+    void updateBackoff();
+    bool sendHeldTelemetry(uint8_t retries);
+    void expireLatencyPings();
+    void updatePromiscuous();
+    void adjustTxPower(uint32_t now_ms);
+    // Frame from the air to the host, behind its RX_META when enabled
+    bool forwardToHost(const uint8_t* mac, const uint8_t* data, size_t len, const AirTrailer* trailer, int64_t rx_us);
     
 public:
     ESPNowManager();
     bool init(const ESPNowConfig& cfg = ESPNowConfig());
     bool addPeer(const uint8_t* peerAddress);
     bool removePeer(const uint8_t* peerAddress);
+    // Switch channel, TX power and network_id in place; false when nothing changed
+    bool applyConfig(const ESPNowConfig& cfg);
     
     // Packet sending methods
     bool sendTelemetryPacket(const TelemetryPacket& packet);
@@ -50,6 +256,72 @@ public:
     bool sendCommandPacket(const CommandPacket& packet);
     bool sendStatusPacket(const StatusPacket& packet);
     bool sendBroadcast(const uint8_t* data, size_t len);
+    // Any complete packet (up to ESPNOW_MTU including the air trailer)
+    bool sendPacket(const uint8_t* data, size_t len);
+    // Any complete packet to one station, a single attempt; from loop() only.
+    // The station is registered with ESP-NOW on first use, evicting the least recently used one.
+    bool sendUnicast(const uint8_t* mac, const uint8_t* data, size_t len);
+    // Reply from the receive callback: unicast when the station is registered,
+    // else broadcast once while update() registers it for the next reply
+    bool replyUnicast(const uint8_t* mac, const uint8_t* data, size_t len);
+
+    // Retransmissions and delivery reports, called from loop()
+    void update(uint32_t now_ms);
+    
+    // Identity used as src_id on the air, follows the host's drone_id
+    void setNodeId(uint8_t id) { node_id = id; }
+    uint8_t getNodeId() const { return node_id; }
+    
+    // Retransmissions per COMMAND; 0 sends commands fire-and-forget
+    void setCommandRetries(uint8_t retries);
+    
+    // One XOR parity frame per k broadcast frames; 0 disables FEC
+    void setFecGroupSize(uint8_t k);
+    
+    // Send probes per mode to target_id as broadcast and as unicast, then report
+    // delivery ratio and round-trip time of each
+    void startLinkBenchmark(uint8_t target_id, uint16_t probes);
+    
+    // Ping one known peer per interval and keep its round-trip percentiles
+    // in the link monitor; 0 = off
+    void setPingInterval(uint32_t interval_ms);
+    
+    // Mesh relay: hops our frames may travel (0 = relaying off) and the
+    // packet types relayed, bit n for type n
+    void setRelayHops(uint8_t hops) { relay.setHops(hops); }
+    void setRelayPolicy(uint32_t mask) { relay.setPolicy(mask); }
+    
+    // Telemetry only in our slot of a slots-long frame on the swarm clock; 0 slots = off
+    void setTdma(uint8_t slots, uint32_t slot_us);
+    
+    // Telemetry waits a random 0..window_ms, doubled after send failures; 0 = off.
+    // Commands and all other traffic go out at once.
+    void setTxJitter(uint16_t window_ms);
+    
+    // RX_META with RSSI, noise floor, arrival time and transmitter ahead of
+    // every frame forwarded to the host. Puts the radio in promiscuous mode
+    // while on.
+    void setRxMeta(bool enabled);
+    
+    // Adapt TX power between min_dbm and max_dbm to the weakest peer's RSSI
+    // and the loss on all links; min_dbm = 0 returns to the configured power.
+    // Needs promiscuous mode for the RSSI while on.
+    void setTxPowerControl(int8_t min_dbm, int8_t max_dbm);
+    
+    // Host filter: false for an invalid rule. readFilterRule() fills in the
+    // slot and its hits; FILTER_ALL_RULES gives the frames no rule matched.
+    bool setFilterRule(uint8_t index, const FilterRule& rule);
+    void clearFilter();
+    uint32_t readFilterRule(uint8_t index, FilterRule& rule);
+    
+    // Forward frames of another network to the host as received, their
+    // header's network_id telling them apart. The bridge itself acts only on
+    // its own network. network_id 0 unsubscribes from all.
+    void subscribeNetwork(uint8_t network_id, bool subscribe);
+    bool isSubscribed(uint8_t network_id) const {
+        return network_id == config.network_id ||
+               (subscribed_networks[network_id / 32] & (1u << (network_id % 32)));
+    }
     
     // Configuration
     void setChannel(int channel);
@@ -0,0 +1,130 @@
+#include "FecCodec.h"
+#include "crc_utils.h"
+
+void FecEncoder::setGroupSize(uint8_t k) {
+    group_size = min(k, (uint8_t)FEC_MAX_GROUP);
+    count = 0;
+}
+
+void FecEncoder::add(const uint8_t* packet, size_t len, uint16_t seq, uint32_t now_ms) {
+    if (count == 0) {
+        first_seq = seq;
+        first_ms = now_ms;
+        member_mask = 0;
+        max_len = 0;
+        memset(parity, 0, sizeof(parity));
+    }
+    for (size_t i = 0; i < len; i++) {
+        parity[i] ^= packet[i];
+    }
+    member_mask |= 1u << (uint16_t)(seq - first_seq);
+    if (len > max_len) {
+        max_len = len;
+    }
+    count++;
+}
+
+size_t FecEncoder::buildParity(FecParityPacket& out, uint8_t network_id) {
+    if (count == 0) {
+        return 0;
+    }
+    size_t packet_len = offsetof(FecParityPacket, parity) + max_len + sizeof(uint16_t);
+    initPacketHeader(out.header, FEC_PARITY, packet_len, network_id);
+    out.first_seq = first_seq;
+    out.member_mask = member_mask;
+    memcpy(out.parity, parity, max_len);
+    sealPacket((uint8_t*)&out, packet_len);
+    count = 0;
+    return packet_len;
+}
+
+FecSourceCache* FecDecoder::find(uint8_t src_id) {
+    for (uint8_t i = 0; i < FEC_CACHE_SOURCES; i++) {
+        if (sources[i].used && sources[i].src_id == src_id) {
+            return &sources[i];
+        }
+    }
+    return nullptr;
+}
+
+void FecDecoder::remember(uint8_t src_id, uint16_t seq, const uint8_t* packet, size_t len, uint32_t now_ms) {
+    if (len > FEC_MAX_FRAME_SIZE) {
+        return;
+    }
+
+    FecSourceCache* cache = find(src_id);
+    if (!cache) {
+        // Take a free entry, else the sender heard from least recently
+        cache = &sources[0];
+        for (uint8_t i = 0; i < FEC_CACHE_SOURCES; i++) {
+            if (!sources[i].used) {
+                cache = &sources[i];
+                break;
+            }
+            if (sources[i].last_ms < cache->last_ms) {
+                cache = &sources[i];
+            }
+        }
+        cache->used = true;
+        cache->src_id = src_id;
+        memset(cache->valid, 0, sizeof(cache->valid));
+    }
+
+    uint8_t slot = seq % FEC_CACHE_DEPTH;
+    cache->last_ms = now_ms;
+    cache->valid[slot] = true;
+    cache->seq[slot] = seq;
+    cache->len[slot] = len;
+    memcpy(cache->data[slot], packet, len);
+}
+
+FecResult FecDecoder::recover(uint8_t src_id, const FecParityPacket& parity, size_t len,
+                              uint8_t* out, size_t& out_len, uint16_t& out_seq) {
+    size_t parity_len = len - offsetof(FecParityPacket, parity) - sizeof(uint16_t);
+    FecSourceCache* cache = find(src_id);
+    if (!cache) {
+        return FEC_UNRECOVERABLE;
+    }
+
+    uint8_t missing = 0;
+    uint8_t missing_bit = 0;
+    for (uint8_t bit = 0; bit < FEC_MAX_GROUP; bit++) {
+        if (!(parity.member_mask & (1u << bit))) continue;
+        uint16_t seq = parity.first_seq + bit;
+        uint8_t slot = seq % FEC_CACHE_DEPTH;
+        if (!cache->valid[slot] || cache->seq[slot] != seq) {
+            missing++;
+            missing_bit = bit;
+        }
+    }
+    if (missing == 0) {
+        return FEC_NOTHING_MISSING;
+    }
+    if (missing > 1) {
+        return FEC_UNRECOVERABLE;
+    }
+
+    // The missing frame is the parity XOR every member we have
+    memcpy(out, parity.parity, parity_len);
+    for (uint8_t bit = 0; bit < FEC_MAX_GROUP; bit++) {
+        if (!(parity.member_mask & (1u << bit)) || bit == missing_bit) continue;
+        uint8_t slot = (uint16_t)(parity.first_seq + bit) % FEC_CACHE_DEPTH;
+        for (uint8_t i = 0; i < cache->len[slot] && i < parity_len; i++) {
+            out[i] ^= cache->data[slot][i];
+        }
+    }
+
+    // The rebuilt packet describes its own length; its CRC proves the rebuild
+    const PacketHeader* header = (const PacketHeader*)out;
+    out_len = sizeof(PacketHeader) + header->payload_size;
+    if (parity_len < sizeof(PacketHeader) || header->preamble != PACKET_PREAMBLE || out_len > parity_len) {
+        return FEC_UNRECOVERABLE;
+    }
+    uint16_t crc;
+    memcpy(&crc, out + out_len - 2, sizeof(crc));
+    if (calculateCRC16(out, out_len) != crc) {
+        return FEC_UNRECOVERABLE;
+    }
+    out_seq = parity.first_seq + missing_bit;
+    return FEC_RECOVERED;
+}
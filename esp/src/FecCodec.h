@@ -0,0 +1,78 @@
+#ifndef FEC_CODEC_H
+#define FEC_CODEC_H
+
+#include <Arduino.h>
+#include "Packet.h"
+
+#define FEC_FLUSH_MS 20         // A partial group gets its parity after this long
+#define FEC_CACHE_SOURCES 8     // Senders whose recent frames are kept for recovery
+#define FEC_CACHE_DEPTH FEC_MAX_GROUP
+
+// Sender side: accumulates the XOR of outgoing broadcast frames. Used from
+// loop() only.
+class FecEncoder {
+public:
+    // Frames per parity frame, 0 disables FEC (overhead is 1/k)
+    void setGroupSize(uint8_t k);
+    uint8_t getGroupSize() const { return group_size; }
+    bool enabled() const { return group_size > 0; }
+
+    // Only small frames are protected, larger ones go out without parity
+    bool protects(size_t len) const { return len <= FEC_MAX_FRAME_SIZE; }
+    // A group spans at most FEC_MAX_GROUP seqs; flush before sending a frame beyond
+    bool fits(uint16_t seq) const { return count == 0 || (uint16_t)(seq - first_seq) < FEC_MAX_GROUP; }
+
+    void add(const uint8_t* packet, size_t len, uint16_t seq, uint32_t now_ms);
+    bool full() const { return count >= group_size; }
+    bool flushDue(uint32_t now_ms) const { return count > 0 && now_ms - first_ms >= FEC_FLUSH_MS; }
+
+    // Seal the parity of the current group into out and start a new group;
+    // returns the packet length, 0 for an empty group
+    size_t buildParity(FecParityPacket& out, uint8_t network_id);
+
+private:
+    uint8_t group_size = 0;
+    uint8_t count = 0;
+    uint16_t first_seq = 0;
+    uint16_t member_mask = 0;
+    uint8_t max_len = 0;
+    uint32_t first_ms = 0;
+    uint8_t parity[FEC_MAX_FRAME_SIZE];
+};
+
+// Recent small broadcast frames of one sender, slot seq % FEC_CACHE_DEPTH
+struct FecSourceCache {
+    bool used = false;
+    uint8_t src_id = 0;
+    uint32_t last_ms = 0;
+    bool valid[FEC_CACHE_DEPTH];
+    uint16_t seq[FEC_CACHE_DEPTH];
+    uint8_t len[FEC_CACHE_DEPTH];
+    uint8_t data[FEC_CACHE_DEPTH][FEC_MAX_FRAME_SIZE];
+};
+
+enum FecResult : uint8_t {
+    FEC_NOTHING_MISSING = 0,
+    FEC_RECOVERED,
+    FEC_UNRECOVERABLE  // More than one member missing, or the sender was never cached
+};
+
+// Receiver side: remembers frames per sender and rebuilds a single missing
+// group member from a parity frame. Used from the ESP-NOW receive callback
+// only.
+class FecDecoder {
+public:
+    void remember(uint8_t src_id, uint16_t seq, const uint8_t* packet, size_t len, uint32_t now_ms);
+
+    // On FEC_RECOVERED, out holds the rebuilt packet (CRC verified), out_len
+    // its length and out_seq its air seq
+    FecResult recover(uint8_t src_id, const FecParityPacket& parity, size_t len,
+                      uint8_t* out, size_t& out_len, uint16_t& out_seq);
+
+private:
+    FecSourceCache* find(uint8_t src_id);
+
+    FecSourceCache sources[FEC_CACHE_SOURCES];
+};
+
+#endif // FEC_CODEC_H
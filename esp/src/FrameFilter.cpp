@@ -0,0 +1,72 @@
+#include "FrameFilter.h"
+
+#define FILTER_HEADER_TYPE_OFFSET 3  // packet_type in PacketHeader
+#define FILTER_CRC_SIZE 2
+
+bool FrameFilter::setRule(uint8_t index, const FilterRule& rule) {
+    if (index >= FILTER_MAX_RULES || rule.op > FILTER_MASK || rule.action > FILTER_DROP ||
+        (rule.width != 1 && rule.width != 2 && rule.width != 4)) {
+        return false;
+    }
+
+    bool was_used = rules[index].op != FILTER_OFF;
+    rules[index] = rule;
+    hits[index] = 0;
+    bool used = rule.op != FILTER_OFF;
+    if (used != was_used) {
+        rule_count += used ? 1 : -1;
+    }
+
+    last_used = 0;
+    for (uint8_t i = 0; i < FILTER_MAX_RULES; i++) {
+        if (rules[i].op != FILTER_OFF) {
+            last_used = i + 1;
+        }
+    }
+    return true;
+}
+
+void FrameFilter::clear() {
+    for (uint8_t i = 0; i < FILTER_MAX_RULES; i++) {
+        rules[i] = FilterRule();
+        hits[i] = 0;
+    }
+    default_hits = 0;
+    rule_count = 0;
+    last_used = 0;
+}
+
+bool FrameFilter::pass(const uint8_t* frame, size_t len) {
+    if (len <= FILTER_HEADER_TYPE_OFFSET) return true;
+    uint8_t type = frame[FILTER_HEADER_TYPE_OFFSET];
+
+    for (uint8_t i = 0; i < last_used; i++) {
+        const FilterRule& rule = rules[i];
+        if (rule.op == FILTER_OFF) continue;
+        if (rule.packet_type != FILTER_ANY_TYPE && rule.packet_type != type) continue;
+
+        bool match = rule.op == FILTER_ALWAYS;
+        if (!match) {
+            if ((size_t)rule.offset + rule.width + FILTER_CRC_SIZE > len) continue;
+            const uint8_t* p = frame + rule.offset;
+            uint32_t field = p[0];
+            if (rule.width >= 2) field |= (uint32_t)p[1] << 8;
+            if (rule.width == 4) field |= (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+
+            switch (rule.op) {
+                case FILTER_EQ: match = field == rule.lo; break;
+                case FILTER_NE: match = field != rule.lo; break;
+                case FILTER_RANGE: match = field >= rule.lo && field <= rule.hi; break;
+                case FILTER_OUTSIDE: match = field < rule.lo || field > rule.hi; break;
+                case FILTER_MASK: match = (field & rule.lo) != 0; break;
+                default: break;
+            }
+        }
+        if (match) {
+            hits[i]++;
+            return rule.action == FILTER_PASS;
+        }
+    }
+    default_hits++;
+    return true;
+}
@@ -0,0 +1,64 @@
+#ifndef FRAME_FILTER_H
+#define FRAME_FILTER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define FILTER_MAX_RULES 16
+#define FILTER_ANY_TYPE 0       // Rule packet_type matching every type
+
+enum FilterOp : uint8_t {
+    FILTER_OFF = 0,      // Empty slot
+    FILTER_ALWAYS = 1,   // Every frame of the type
+    FILTER_EQ = 2,       // field == lo
+    FILTER_NE = 3,       // field != lo
+    FILTER_RANGE = 4,    // lo <= field <= hi
+    FILTER_OUTSIDE = 5,  // field < lo or field > hi
+    FILTER_MASK = 6      // field & lo != 0
+};
+
+enum FilterAction : uint8_t {
+    FILTER_PASS = 0,
+    FILTER_DROP = 1
+};
+
+struct FilterRule {
+    uint8_t op = FILTER_OFF;
+    uint8_t action = FILTER_PASS;
+    uint8_t packet_type = FILTER_ANY_TYPE;
+    uint8_t offset = 0;     // Of the field from the start of the frame, header included
+    uint8_t width = 1;      // 1, 2 or 4 bytes, little-endian
+    uint32_t lo = 0;
+    uint32_t hi = 0;
+};
+
+// Rule table deciding which frames from the air reach the host. Rules are
+// tried in slot order and the first match decides; a frame no rule matches
+// passes. A rule matches frames of its packet type whose field compares
+// true; a field that does not fit in front of the CRC never matches.
+// "Telemetry from drones 1-8 only" is a PASS on the drone_id RANGE 1..8
+// followed by an ALWAYS DROP for telemetry. Plain table walk without Arduino
+// dependencies, so the native benchmark measures the same code.
+class FrameFilter {
+public:
+    // False for a bad slot, op, width or action; FILTER_OFF empties the slot
+    bool setRule(uint8_t index, const FilterRule& rule);
+    void clear();
+    bool active() const { return rule_count > 0; }
+
+    // Complete frame without the air trailer; counts the hit of the deciding rule
+    bool pass(const uint8_t* frame, size_t len);
+
+    const FilterRule& getRule(uint8_t index) const { return rules[index]; }
+    uint32_t getHits(uint8_t index) const { return hits[index]; }
+    uint32_t getDefaultHits() const { return default_hits; }
+
+private:
+    FilterRule rules[FILTER_MAX_RULES];
+    uint32_t hits[FILTER_MAX_RULES] = {0};
+    uint32_t default_hits = 0;
+    uint8_t rule_count = 0;
+    uint8_t last_used = 0;  // One past the highest slot in use, bounds the walk
+};
+
+#endif // FRAME_FILTER_H
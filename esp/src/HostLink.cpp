@@ -0,0 +1,53 @@
+#include "HostLink.h"
+#include "Packet.h"
+#include "Statistics.h"
+
+extern Statistics stats;
+
+static void countSent(const uint8_t* data, size_t len) {
+    const PacketHeader* header = (const PacketHeader*)data;
+    stats.uart.packets_sent++;
+    stats.uart.packets_sent_last_interval++;
+    stats.uart.bytes_sent += len;
+    if (header->packet_type < PACKET_TYPE_COUNT) {
+        stats.uart.by_type[header->packet_type].packets_sent++;
+        stats.uart.by_type[header->packet_type].bytes_sent += len;
+    }
+}
+
+bool sendToHost(const uint8_t* data, size_t len) {
+    if (!data || len < sizeof(PacketHeader)) {
+        return false;
+    }
+    
+    size_t written = Serial1.write(data, len);
+    if (written != len) {
+        Serial.println("ERROR: Failed to forward packet to UART");
+        return false;
+    }
+    Serial1.flush();
+    
+    countSent(data, len);
+    return true;
+}
+
+bool sendToHost(const uint8_t* first, size_t first_len, const uint8_t* data, size_t len) {
+    uint8_t buffer[2 * (sizeof(PacketHeader) + MAX_PAYLOAD_SIZE)];
+    if (!first || !data || first_len < sizeof(PacketHeader) || len < sizeof(PacketHeader) ||
+        first_len + len > sizeof(buffer)) {
+        return false;
+    }
+    
+    memcpy(buffer, first, first_len);
+    memcpy(buffer + first_len, data, len);
+    size_t written = Serial1.write(buffer, first_len + len);
+    if (written != first_len + len) {
+        Serial.println("ERROR: Failed to forward packet to UART");
+        return false;
+    }
+    Serial1.flush();
+    
+    countSent(first, first_len);
+    countSent(data, len);
+    return true;
+}
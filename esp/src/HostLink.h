@@ -0,0 +1,15 @@
+#ifndef HOST_LINK_H
+#define HOST_LINK_H
+
+#include <Arduino.h>
+
+// Write one complete packet to the host over UART1.
+// Each packet goes out in a single write() so that frames forwarded from the
+// ESP-NOW callback and packets generated in loop() never interleave.
+bool sendToHost(const uint8_t* data, size_t len);
+
+// Two complete packets back to back in a single write(), e.g. RX_META and
+// the frame it describes
+bool sendToHost(const uint8_t* first, size_t first_len, const uint8_t* data, size_t len);
+
+#endif // HOST_LINK_H
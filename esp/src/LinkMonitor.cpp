@@ -0,0 +1,220 @@
+#include "LinkMonitor.h"
+#include "ESPNowManager.h"
+#include "HostLink.h"
+#include "crc_utils.h"
+
+extern ESPNowManager espNowManager;
+
+void LinkMonitor::track(uint8_t src_id, uint16_t seq, uint32_t now_ms) {
+    portENTER_CRITICAL(&lock);
+    PeerSequence& peer = peers[src_id];
+    int16_t ahead = (int16_t)(seq - peer.highest);
+
+    if (!peer.valid || ahead >= LINK_RESYNC_GAP || ahead <= -LINK_RESYNC_GAP) {
+        // First frame, or the sender restarted: the gap says nothing about the link
+        if (peer.valid) {
+            peer.resyncs++;
+        }
+        peer.valid = true;
+        peer.highest = seq;
+        peer.window = 1;
+        peer.expected++;
+        peer.received++;
+    } else if (ahead > 0) {
+        peer.window = ahead >= LINK_WINDOW ? 1 : (peer.window << ahead) | 1;
+        peer.highest = seq;
+        peer.expected += ahead;
+        peer.received++;
+    } else if (-ahead >= LINK_WINDOW) {
+        // Too late to tell a duplicate from a straggler, count it as the latter
+        peer.received++;
+        peer.reordered++;
+    } else {
+        uint64_t bit = 1ULL << (-ahead);
+        if (peer.window & bit) {
+            peer.duplicates++;
+        } else {
+            peer.window |= bit;
+            peer.received++;
+            peer.reordered++;
+        }
+    }
+    peer.last_ms = now_ms;
+    portEXIT_CRITICAL(&lock);
+}
+
+void LinkMonitor::recordRtt(uint8_t drone_id, uint32_t rtt_us, uint32_t now_ms) {
+    portENTER_CRITICAL(&lock);
+    PeerRtt* slot = nullptr;
+    PeerRtt* oldest = &rtt[0];
+    for (uint8_t i = 0; i < LINK_RTT_PEERS && !slot; i++) {
+        if (rtt[i].used && rtt[i].drone_id == drone_id) {
+            slot = &rtt[i];
+        } else if (!rtt[i].used || (oldest->used && now_ms - rtt[i].last_ms > now_ms - oldest->last_ms)) {
+            oldest = &rtt[i];
+        }
+    }
+    if (!slot) {
+        slot = oldest;
+        slot->used = true;
+        slot->drone_id = drone_id;
+        slot->count = 0;
+        slot->next = 0;
+    }
+    slot->samples_us[slot->next] = rtt_us;
+    slot->next = (slot->next + 1) % LINK_RTT_SAMPLES;
+    if (slot->count < LINK_RTT_SAMPLES) slot->count++;
+    slot->last_ms = now_ms;
+    portEXIT_CRITICAL(&lock);
+}
+
+void LinkMonitor::recordRssi(uint8_t src_id, int8_t rssi) {
+    portENTER_CRITICAL(&lock);
+    PeerSequence& peer = peers[src_id];
+    if (peer.rssi_count < UINT16_MAX) {
+        peer.rssi_sum += rssi;
+        peer.rssi_count++;
+    }
+    portEXIT_CRITICAL(&lock);
+}
+
+void LinkMonitor::sampleQuality(LinkQuality& quality) {
+    quality = LinkQuality();
+    portENTER_CRITICAL(&lock);
+    for (uint16_t i = 0; i < 256; i++) {
+        PeerSequence& peer = peers[i];
+        if (peer.valid && peer.rssi_count > 0) {
+            int8_t mean = peer.rssi_sum / peer.rssi_count;
+            if (quality.peers == 0 || mean < quality.min_rssi) {
+                quality.min_rssi = mean;
+            }
+            quality.peers++;
+            uint32_t expected = peer.expected - peer.sampled_expected;
+            uint32_t received = peer.received - peer.sampled_received;
+            quality.expected += expected;
+            quality.lost += expected > received ? expected - received : 0;
+        }
+        peer.sampled_expected = peer.expected;
+        peer.sampled_received = peer.received;
+        peer.rssi_sum = 0;
+        peer.rssi_count = 0;
+    }
+    portEXIT_CRITICAL(&lock);
+}
+
+// Nearest-rank percentiles of the peer's window, 0.1 ms units; caller holds the lock
+void LinkMonitor::rttPercentiles(uint8_t drone_id, LinkStatsEntry& entry) {
+    entry.rtt_p50 = entry.rtt_p90 = entry.rtt_p99 = 0;
+    for (uint8_t i = 0; i < LINK_RTT_PEERS; i++) {
+        const PeerRtt& peer = rtt[i];
+        if (!peer.used || peer.drone_id != drone_id || peer.count == 0) continue;
+
+        uint32_t sorted[LINK_RTT_SAMPLES];
+        uint8_t n = peer.count;
+        for (uint8_t j = 0; j < n; j++) {
+            uint32_t value = peer.samples_us[j];
+            uint8_t k = j;
+            for (; k > 0 && sorted[k - 1] > value; k--) {
+                sorted[k] = sorted[k - 1];
+            }
+            sorted[k] = value;
+        }
+        auto rank = [&](uint8_t percent) -> uint16_t {
+            uint8_t index = (n * percent + 99) / 100 - 1;
+            return (uint16_t)min(sorted[index] / 100, (uint32_t)UINT16_MAX);
+        };
+        entry.rtt_p50 = max(rank(50), (uint16_t)1);  // 0 is reserved for no samples
+        entry.rtt_p90 = max(rank(90), (uint16_t)1);
+        entry.rtt_p99 = max(rank(99), (uint16_t)1);
+        break;
+    }
+}
+
+void LinkMonitor::setReportInterval(uint32_t interval_ms) {
+    report_interval_ms = interval_ms;
+    Serial.printf("Link reports: %s (%lu ms)\n", interval_ms > 0 ? "on" : "on request",
+                 (unsigned long)interval_ms);
+}
+
+void LinkMonitor::update(uint32_t now_ms) {
+    if (report_interval_ms > 0 && now_ms - last_report_ms >= report_interval_ms) {
+        publish(report_id++, 0, now_ms);
+        last_report_ms = now_ms;
+    }
+}
+
+bool LinkMonitor::snapshot(uint8_t drone_id, LinkStatsEntry& entry) {
+    portENTER_CRITICAL(&lock);
+    const PeerSequence& peer = peers[drone_id];
+    bool valid = peer.valid;
+    if (valid) {
+        entry.drone_id = drone_id;
+        entry.expected = peer.expected;
+        entry.received = peer.received;
+        entry.lost = peer.expected > peer.received ? peer.expected - peer.received : 0;
+        entry.duplicates = peer.duplicates;
+        entry.reordered = peer.reordered;
+        rttPercentiles(drone_id, entry);
+    }
+    portEXIT_CRITICAL(&lock);
+    return valid;
+}
+
+void LinkMonitor::publish(uint8_t id, uint8_t flags, uint32_t now_ms) {
+    uint8_t ids[256];
+    uint16_t n = 0;
+    portENTER_CRITICAL(&lock);
+    for (uint16_t i = 0; i < 256; i++) {
+        if (peers[i].valid) ids[n++] = i;
+    }
+    portEXIT_CRITICAL(&lock);
+
+    uint8_t network_id = espNowManager.getConfig().network_id;
+    uint8_t part = 0;
+    uint16_t done = 0;
+
+    // No peers yet still produces one (empty) last part
+    do {
+        LinkStatsPacket packet;
+        uint8_t count = 0;
+        while (done < n && count < LINK_STATS_ENTRIES_PER_PACKET) {
+            if (snapshot(ids[done++], packet.entries[count])) {
+                count++;
+            }
+        }
+
+        size_t len = offsetof(LinkStatsPacket, entries) + count * sizeof(LinkStatsEntry) + sizeof(uint16_t);
+        initPacketHeader(packet.header, LINK_STATS, len, network_id);
+        packet.timestamp_ms = now_ms;
+        packet.report_id = id;
+        packet.part = part++;
+        packet.count = count;
+        packet.flags = flags;
+        if (done == n) {
+            packet.flags |= LINK_STATS_FLAG_LAST_PART;
+        }
+        sealPacket((uint8_t*)&packet, len);
+        sendToHost((uint8_t*)&packet, len);
+    } while (done < n);
+}
+
+void LinkMonitor::print() {
+    bool header = false;
+    for (uint16_t i = 0; i < 256; i++) {
+        LinkStatsEntry entry;
+        if (!snapshot(i, entry)) continue;
+        if (!header) {
+            Serial.println("\n--- LINK QUALITY ---");
+            header = true;
+        }
+        Serial.printf("drone_%u: %lu/%lu received (%.1f%%), lost %lu, dup %lu, reordered %lu, restarts %lu\n",
+                     entry.drone_id, (unsigned long)entry.received, (unsigned long)entry.expected,
+                     entry.expected > 0 ? entry.received * 100.0f / entry.expected : 0.0f,
+                     (unsigned long)entry.lost, (unsigned long)entry.duplicates, (unsigned long)entry.reordered,
+                     (unsigned long)peers[i].resyncs);
+        if (entry.rtt_p50 > 0) {
+            Serial.printf("  RTT p50 %.1f ms, p90 %.1f ms, p99 %.1f ms\n",
+                         entry.rtt_p50 / 10.0f, entry.rtt_p90 / 10.0f, entry.rtt_p99 / 10.0f);
+        }
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef LINK_MONITOR_H
+#define LINK_MONITOR_H
+
+#include <Arduino.h>
+#include "Packet.h"
+#include "TxPowerController.h"
+
+#define LINK_WINDOW 64          // Recent sequence numbers remembered per peer, bits in PeerSequence::window
+#define LINK_RESYNC_GAP 1024    // A jump this far either way means the sender restarted
+#define LINK_RTT_PEERS 16       // Peers with latency samples, the one pinged longest ago makes room
+#define LINK_RTT_SAMPLES 32     // Latest round trips kept per peer
+
+// Sequence state and counters of one peer
+struct PeerSequence {
+    bool valid = false;
+    uint16_t highest = 0;
+    uint64_t window = 0;     // Bit n: highest - n was received
+    uint32_t last_ms = 0;
+    uint32_t expected = 0;
+    uint32_t received = 0;
+    uint32_t duplicates = 0;
+    uint32_t reordered = 0;
+    uint32_t resyncs = 0;
+    // Since the last quality sample
+    uint32_t sampled_expected = 0;
+    uint32_t sampled_received = 0;
+    int32_t rssi_sum = 0;
+    uint16_t rssi_count = 0;
+};
+
+// Latest latency monitor round trips of one peer
+struct PeerRtt {
+    bool used = false;
+    uint8_t drone_id = 0;
+    uint8_t count = 0;
+    uint8_t next = 0;
+    uint32_t last_ms = 0;
+    uint32_t samples_us[LINK_RTT_SAMPLES];
+};
+
+// Delivery ratio per peer, measured on the broadcast sequence numbers of
+// frames heard directly (reliable, unicast and relayed frames have their
+// own sequence spaces). Frames rebuilt by FEC count as received, late.
+// Round-trip percentiles come from the latency monitor pings, RSSI from
+// promiscuous mode while something needs it.
+// Tracked from the ESP-NOW receive callback, reported from loop().
+class LinkMonitor {
+public:
+    void track(uint8_t src_id, uint16_t seq, uint32_t now_ms);
+    void recordRtt(uint8_t drone_id, uint32_t rtt_us, uint32_t now_ms);
+    void recordRssi(uint8_t src_id, int8_t rssi);
+
+    // Peers heard directly since the last call: weakest average RSSI and
+    // the frames expected and lost from them
+    void sampleQuality(LinkQuality& quality);
+
+    // Periodic LINK_STATS reports to the host, 0 = only on request
+    void setReportInterval(uint32_t interval_ms);
+    void publish(uint8_t report_id, uint8_t flags, uint32_t now_ms);
+    void update(uint32_t now_ms);
+
+    // Per-peer table on the debug console
+    void print();
+
+private:
+    bool snapshot(uint8_t drone_id, LinkStatsEntry& entry);
+    void rttPercentiles(uint8_t drone_id, LinkStatsEntry& entry);
+
+    portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+    PeerSequence peers[256];
+    PeerRtt rtt[LINK_RTT_PEERS];
+    uint32_t report_interval_ms = 0;
+    uint32_t last_report_ms = 0;
+    uint8_t report_id = 0;
+};
+
+#endif // LINK_MONITOR_H
@@ -0,0 +1,108 @@
+#include "MeshRelay.h"
+#include "Statistics.h"
+
+extern Statistics stats;
+
+void MeshRelay::setHops(uint8_t h) {
+    hops = min(h, (uint8_t)AIR_MAX_TTL);
+    if (hops > 0) {
+        Serial.printf("Mesh relay: on, %d hops, policy 0x%08lX\n", hops, (unsigned long)policy);
+    } else {
+        Serial.println("Mesh relay: off");
+    }
+}
+
+void MeshRelay::setPolicy(uint32_t mask) {
+    policy = mask;
+    Serial.printf("Mesh relay policy: 0x%08lX\n", (unsigned long)policy);
+}
+
+bool MeshRelay::checkDuplicate(uint8_t src_id, uint8_t space, uint16_t seq, uint32_t now_ms) {
+    bool duplicate = false;
+    portENTER_CRITICAL(&lock);
+    for (uint8_t i = 0; i < RELAY_CACHE_SIZE; i++) {
+        const RelayCacheEntry& entry = cache[i];
+        if (entry.used && entry.src_id == src_id && entry.space == space && entry.seq == seq &&
+            now_ms - entry.seen_ms < RELAY_DUPLICATE_MS) {
+            duplicate = true;
+            break;
+        }
+    }
+
+    if (duplicate) {
+        for (uint8_t i = 0; i < RELAY_QUEUE_SIZE; i++) {
+            RelayQueueEntry& entry = queue[i];
+            if (entry.used && entry.src_id == src_id && entry.space == space && entry.seq == seq) {
+                // Enough neighbours already carried it further
+                if (++entry.copies >= RELAY_SUPPRESS_COPIES) {
+                    entry.used = false;
+                    stats.relay.suppressed++;
+                }
+                break;
+            }
+        }
+    } else {
+        // The oldest entry makes room
+        RelayCacheEntry& entry = cache[cache_next];
+        cache_next = (cache_next + 1) % RELAY_CACHE_SIZE;
+        entry.used = true;
+        entry.src_id = src_id;
+        entry.space = space;
+        entry.seq = seq;
+        entry.seen_ms = now_ms;
+    }
+    portEXIT_CRITICAL(&lock);
+    return duplicate;
+}
+
+bool MeshRelay::schedule(const uint8_t* frame, size_t len, uint8_t src_id, uint8_t space, uint16_t seq, uint32_t now_ms) {
+    if (len > ESPNOW_MTU) {
+        return false;
+    }
+    // Neighbours that heard the same frame pick different delays, the first one
+    // to go silences the rest
+    uint32_t jitter = RELAY_MIN_JITTER_MS + esp_random() % (RELAY_MAX_JITTER_MS - RELAY_MIN_JITTER_MS + 1);
+
+    bool queued = false;
+    portENTER_CRITICAL(&lock);
+    for (uint8_t i = 0; i < RELAY_QUEUE_SIZE; i++) {
+        RelayQueueEntry& entry = queue[i];
+        if (!entry.used) {
+            entry.used = true;
+            entry.src_id = src_id;
+            entry.space = space;
+            entry.seq = seq;
+            entry.copies = 0;
+            entry.due_ms = now_ms + jitter;
+            entry.len = len;
+            memcpy(entry.frame, frame, len);
+            queued = true;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&lock);
+
+    if (queued) {
+        stats.relay.scheduled++;
+    } else {
+        stats.relay.queue_overflows++;
+    }
+    return queued;
+}
+
+bool MeshRelay::popDue(uint32_t now_ms, uint8_t* frame, size_t& len) {
+    bool found = false;
+    portENTER_CRITICAL(&lock);
+    for (uint8_t i = 0; i < RELAY_QUEUE_SIZE; i++) {
+        RelayQueueEntry& entry = queue[i];
+        if (entry.used && (int32_t)(now_ms - entry.due_ms) >= 0) {
+            memcpy(frame, entry.frame, entry.len);
+            len = entry.len;
+            entry.used = false;
+            found = true;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&lock);
+    return found;
+}
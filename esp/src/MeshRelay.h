@@ -0,0 +1,79 @@
+#ifndef MESH_RELAY_H
+#define MESH_RELAY_H
+
+#include <Arduino.h>
+#include "Packet.h"
+
+#define RELAY_CACHE_SIZE 64
+#define RELAY_QUEUE_SIZE 8
+#define RELAY_MIN_JITTER_MS 1
+#define RELAY_MAX_JITTER_MS 10
+// Long enough for every copy of a frame to die out across AIR_MAX_TTL hops;
+// a reliable retransmission after this is relayed again
+#define RELAY_DUPLICATE_MS (2 * RELAY_MAX_JITTER_MS * AIR_MAX_TTL)
+#define RELAY_SUPPRESS_COPIES 2  // Copies overheard while waiting that make our own rebroadcast redundant
+
+// Commands, their ACKs, status and custom messages cross the mesh; telemetry,
+// bulk fragments, parity and stream traffic stay local
+#define RELAY_DEFAULT_POLICY ((1u << COMMAND) | (1u << ACK) | (1u << DRONE_STATUS) | \
+                              (1u << CUSTOM_MESSAGE) | (1u << OTA_CONFIG))
+
+// A frame identity: originator, sequence space and sequence number
+struct RelayCacheEntry {
+    bool used = false;
+    uint8_t src_id = 0;
+    uint8_t space = 0;
+    uint16_t seq = 0;
+    uint32_t seen_ms = 0;
+};
+
+struct RelayQueueEntry {
+    bool used = false;
+    uint8_t src_id = 0;
+    uint8_t space = 0;
+    uint16_t seq = 0;
+    uint8_t copies = 0;  // Overheard from other relays since it was queued
+    uint32_t due_ms = 0;
+    uint8_t len = 0;
+    uint8_t frame[ESPNOW_MTU];
+};
+
+// Optional multi-hop flooding. Originators stamp relayable frames with a
+// TTL; bridges with relaying on rebroadcast each new frame once, after a
+// random jitter, with the TTL decremented. A small cache of recently seen
+// (source, sequence) pairs drops copies, and a queued rebroadcast is
+// cancelled when enough neighbours were heard relaying the same frame.
+// The cache and queue are filled from the receive callback and drained
+// from loop().
+class MeshRelay {
+public:
+    // Hops frames originated here may travel, also turns relaying on; 0 = off
+    void setHops(uint8_t hops);
+    uint8_t getHops() const { return hops; }
+    bool enabled() const { return hops > 0; }
+
+    // Bit n set: packets of type n are relayed
+    void setPolicy(uint32_t mask);
+    bool relays(uint8_t packet_type) const { return packet_type < 32 && (policy & (1u << packet_type)); }
+
+    // True if the frame was seen within RELAY_DUPLICATE_MS, otherwise it is
+    // recorded. A copy of a frame waiting in the queue counts towards
+    // suppressing its rebroadcast.
+    bool checkDuplicate(uint8_t src_id, uint8_t space, uint16_t seq, uint32_t now_ms);
+
+    // Queue a complete air frame (trailer already rewritten) for rebroadcast
+    bool schedule(const uint8_t* frame, size_t len, uint8_t src_id, uint8_t space, uint16_t seq, uint32_t now_ms);
+
+    // Next frame whose jitter has elapsed, from loop()
+    bool popDue(uint32_t now_ms, uint8_t* frame, size_t& len);
+
+private:
+    portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+    uint8_t hops = 0;
+    uint32_t policy = RELAY_DEFAULT_POLICY;
+    RelayCacheEntry cache[RELAY_CACHE_SIZE];
+    uint8_t cache_next = 0;
+    RelayQueueEntry queue[RELAY_QUEUE_SIZE];
+};
+
+#endif // MESH_RELAY_H
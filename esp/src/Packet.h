@@ -7,6 +7,7 @@
 #define PACKET_PREAMBLE 0xAA55
 #define MAX_PAYLOAD_SIZE 128
 #define RX_BUFFER_SIZE 256
+#define PACKET_TYPE_COUNT 26  // One past the highest PacketType value
 
 // Packet header structure
 struct PacketHeader {
@@ -27,9 +28,90 @@ enum PacketType {
     PING = 7,
     ACK = 8,
     CUSTOM_MESSAGE = 9,
-    OTA_CONFIG = 10  // Объединенный пакет для OTA и конфигурации
+    OTA_CONFIG = 10,  // Объединенный пакет для OTA и конфигурации
+    BRIDGE_CONTROL = 11,  // Host -> bridge control, never sent over ESP-NOW
+    SWARM_SNAPSHOT = 12,  // Bridge -> host compact swarm state
+    CONFLICT_ALERT = 13,  // Bridge -> host predicted near-miss, sent ahead of other traffic
+    DELIVERY_REPORT = 14, // Bridge -> host outcome of a reliable COMMAND
+    STREAM_DATA = 15,     // Stream bytes: host <-> bridge, and unicast segments on the air
+    STREAM_ACK = 16,      // Air only, cumulative + selective acknowledgement of segments
+    STREAM_CONTROL = 17,  // Host <-> bridge stream open/close/status
+    FEC_PARITY = 18,      // Air only, XOR parity over a group of broadcast frames
+    LINK_STATS = 19,      // Bridge -> host per-peer delivery counters
+    TIME_SYNC = 20,       // Clock synchronization on the air, synchronized time to the host
+    RX_META = 21,         // Bridge -> host radio metadata of the frame that follows it
+    CHANNEL_SWITCH = 22,  // Swarm-wide channel change: host request, air announcement, report to the host
+    FILTER_RULE = 23,     // Host <-> bridge rule of the filter on frames forwarded to the host
+    NEIGHBOR = 24,        // Bridge -> host neighbour joined or left, or one entry of the neighbour table
+    STATS = 25            // Statistics snapshot of a bridge, requested over the air and unicast back
 };
 
+// BridgeControlPacket commands
+enum BridgeCommand {
+    CTRL_SET_SNAPSHOT_INTERVAL = 1,  // value: ms between snapshots, 0 = forward every telemetry frame
+    CTRL_SET_INTEREST_RADIUS = 2,    // value: cm, 0 = no distance limit
+    CTRL_SET_INTEREST_K = 3,         // value: k nearest neighbours, 0 = no limit
+    CTRL_SET_CONFLICT_RADIUS = 4,    // value: cm, 0 = conflict detection off
+    CTRL_SET_CONFLICT_HORIZON = 5,   // value: ms of look-ahead
+    CTRL_REQUEST_POSITIONS = 6,      // arg: query id, value: ms ahead of now; reply is an extrapolated snapshot
+    CTRL_SET_COMMAND_RETRIES = 7,    // value: retransmissions per reliable COMMAND, 0 = fire-and-forget
+    CTRL_BULK_BENCHMARK = 8,         // arg: blob count, value: blob size in bytes
+    CTRL_SET_FEC_GROUP = 9,          // value: broadcast frames per parity frame, 0 = FEC off
+    CTRL_LINK_BENCHMARK = 10,        // arg: target drone_id, value: probes per mode (broadcast, unicast)
+    CTRL_SET_RELAY_HOPS = 11,        // value: hops our frames may travel, also turns relaying on; 0 = off
+    CTRL_SET_RELAY_POLICY = 12,      // value: bit n set relays packets of type n
+    CTRL_SET_LINK_REPORT_INTERVAL = 13,  // value: ms between LINK_STATS reports, 0 = only on request
+    CTRL_REQUEST_LINK_STATS = 14,    // arg: report id, echoed in the reply
+    CTRL_SET_TIME_SYNC = 15,         // value: TimeSyncRole
+    CTRL_SET_PING_INTERVAL = 16,     // value: ms between latency monitor pings, 0 = off
+    CTRL_SET_TDMA = 17,              // arg: slots per frame, 0 = off; value: slot length in us
+    CTRL_SET_TX_JITTER = 18,         // value: telemetry jitter window in ms, 0 = off
+    CTRL_SET_RATE_LIMIT = 19,        // arg: packet type, 0xFF = relay per source; value: rate/s | burst << 16, 0 = off
+    CTRL_SET_RX_META = 20,           // value: 1 = RX_META ahead of every frame forwarded from the air, 0 = off
+    CTRL_SET_TX_POWER_CONTROL = 21,  // arg: lowest dBm, 0 = fixed configured power; value: highest dBm
+    CTRL_SUBSCRIBE_NETWORK = 22,     // arg: network_id, 0 = all; value: 1 = forward its frames, 0 = stop
+    CTRL_SET_NEIGHBOR_EVENTS = 23,   // value: 1 = push NEIGHBOR join/leave events, 0 = off
+    CTRL_REQUEST_NEIGHBORS = 24      // arg: query id; reply is one NEIGHBOR per entry, then NEIGHBOR_END
+};
+
+// Fill in a header for a packet built on the bridge
+inline void initPacketHeader(PacketHeader& header, uint8_t packet_type, size_t packet_size, uint8_t network_id) {
+    header.preamble = PACKET_PREAMBLE;
+    header.payload_size = packet_size - sizeof(PacketHeader);
+    header.packet_type = packet_type;
+    header.network_id = network_id;
+}
+
+// Appended to every ESP-NOW frame after the packet CRC and stripped before
+// the packet is forwarded to the host. Frames without it (older firmware,
+// esp_controller) are still accepted.
+#define AIR_FLAG_ACK_REQUESTED 0x01  // Reliable COMMAND, seq is from the reliable sequence space
+#define AIR_FLAG_UNICAST 0x02        // Sent to one MAC, seq is from the unicast sequence space
+#define AIR_FLAG_PROBE 0x04          // Link benchmark probe, seq is the probe number
+#define AIR_FLAG_RELAYED 0x08        // Rebroadcast by a relay, the sender MAC is not the originator's
+#define AIR_TTL_SHIFT 4
+#define AIR_TTL_MASK 0x30            // Hops left for relays, 0 = not relayed any further
+#define AIR_MAX_TTL 3
+
+struct AirTrailer {
+    uint8_t src_id;  // Originating node (drone_id of its host)
+    uint8_t flags;   // AIR_FLAG_*
+    uint16_t seq;    // Per-originator sequence number
+} __attribute__((packed));
+
+inline uint8_t airTtl(uint8_t flags) {
+    return (flags & AIR_TTL_MASK) >> AIR_TTL_SHIFT;
+}
+
+// seq is from the originator's broadcast sequence space and the frame came
+// straight from it
+inline bool airDirectBroadcast(uint8_t flags) {
+    return !(flags & (AIR_FLAG_ACK_REQUESTED | AIR_FLAG_UNICAST | AIR_FLAG_PROBE | AIR_FLAG_RELAYED));
+}
+
+#define ESPNOW_MTU 250  // ESP_NOW_MAX_DATA_LEN
+#define ESPNOW_MAX_FRAME_SIZE ESPNOW_MTU
+
 // Packet structures
 struct ConfigPacket {
     PacketHeader header;
@@ -57,10 +139,12 @@ struct TelemetryPacket {
     uint16_t crc;
 } __attribute__((packed));
 
+#define COMMAND_TARGET_ALL 0xFF
+
 struct CommandPacket {
     PacketHeader header;
     uint8_t command_id;
-    uint8_t target_id;
+    uint8_t target_id;  // drone_id or COMMAND_TARGET_ALL
     uint16_t param;
     uint16_t crc;
 } __attribute__((packed));
@@ -89,6 +173,11 @@ struct PingPacket {
     uint16_t crc;
 } __attribute__((packed));
 
+// For reliable commands ack_type = COMMAND, ack_id = the originator's src_id
+// and status = the acknowledged sequence number; such ACKs stay on the air.
+// Link benchmark probes and their echoes have ack_type = PING, ack_id = the
+// drone asked to echo (probe) or the prober (echo), status = probe number.
+// Latency monitor pings are probes too, with LINK_PING_FLAG in status.
 struct AckPacket {
     PacketHeader header;
     uint8_t ack_type;
@@ -108,4 +197,355 @@ struct OtaConfigPacket {
     uint16_t crc;
 } __attribute__((packed));
 
+struct BridgeControlPacket {
+    PacketHeader header;
+    uint8_t command;  // BridgeCommand
+    uint8_t arg;
+    int32_t value;
+    uint16_t crc;
+} __attribute__((packed));
+
+// Swarm snapshot: variable number of entries, CRC follows the last entry
+#define SNAPSHOT_ENTRIES_PER_PACKET 7
+#define SNAPSHOT_FLAG_LAST_PART 0x01
+#define SNAPSHOT_FLAG_INTEREST_FILTERED 0x02  // Only neighbours of interest are listed
+#define SNAPSHOT_FLAG_EXTRAPOLATED 0x04       // Reply to a position query, snapshot_id echoes the query id
+
+struct SnapshotEntry {
+    uint8_t drone_id;
+    uint8_t status_code;
+    uint16_t age_ms;  // Time since last telemetry, saturates at 65535
+    int16_t x_cm;
+    int16_t y_cm;
+    int16_t z_cm;
+    int16_t vx_cms;
+    int16_t vy_cms;
+    int16_t vz_cms;
+} __attribute__((packed));
+
+struct SwarmSnapshotPacket {
+    PacketHeader header;
+    uint32_t timestamp_ms;  // Bridge millis() at snapshot time
+    uint8_t snapshot_id;
+    uint8_t flags;
+    uint8_t part;
+    uint8_t count;
+    SnapshotEntry entries[SNAPSHOT_ENTRIES_PER_PACKET];
+    uint16_t crc;
+} __attribute__((packed));
+
+// Closest-point-of-approach conflict with a neighbour
+#define CONFLICT_PREDICTED 1  // Separation will drop below the radius within the horizon
+#define CONFLICT_INSIDE 2     // Already closer than the radius
+
+struct ConflictAlertPacket {
+    PacketHeader header;
+    uint8_t drone_id;         // Neighbour in conflict
+    uint8_t severity;
+    uint16_t time_to_cpa_ms;  // Time until closest approach, 0 if diverging
+    uint16_t min_distance_cm; // Predicted separation at closest approach
+    uint16_t distance_cm;     // Current separation
+    uint16_t crc;
+} __attribute__((packed));
+
+// Neighbour table: a drone joins with its first telemetry frame and leaves
+// when nothing was heard from it for SWARM_ENTRY_TIMEOUT_MS or it is evicted
+enum NeighborEvent : uint8_t {
+    NEIGHBOR_JOIN = 1,
+    NEIGHBOR_LEAVE = 2,
+    NEIGHBOR_STATE = 3,  // Entry of a table dump
+    NEIGHBOR_END = 4     // Last packet of a dump, drone_id holds the number of entries
+};
+
+#define NEIGHBOR_FLAG_RSSI 0x01  // rssi holds a value, some frame was heard directly
+
+struct NeighborPacket {
+    PacketHeader header;
+    uint8_t event;        // NeighborEvent
+    uint8_t drone_id;
+    uint8_t status_code;  // From its latest DRONE_STATUS
+    int8_t rssi;          // dBm, moving average over frames heard directly
+    uint8_t flags;
+    uint8_t query_id;     // Dump: echoed from the request
+    uint16_t rate_dpps;   // Frames per second heard from it, in tenths
+    uint16_t age_ms;      // Since the last frame, saturates at 65535
+    uint16_t crc;
+} __attribute__((packed));
+
+// Remote statistics: a REQUEST from the host (or any ESP-NOW station) asks one
+// bridge or all of them; each answers with a REPLY unicast to whoever asked,
+// which the requesting bridge forwards to its host
+enum StatsOp : uint8_t {
+    STATS_REQUEST = 1,
+    STATS_REPLY = 2
+};
+
+#define STATS_TARGET_ALL 0xFF
+
+struct StatsPacket {
+    PacketHeader header;
+    uint8_t op;               // StatsOp
+    uint8_t target_id;        // REQUEST: drone_id asked, or STATS_TARGET_ALL
+    uint8_t src_id;           // REPLY: drone_id of the bridge
+    uint8_t query_id;         // Echoed in the reply
+    uint32_t uptime_s;
+    uint32_t air_sent;        // ESP-NOW frames
+    uint32_t air_received;
+    uint32_t air_corrupted;
+    uint32_t send_failures;
+    uint32_t host_sent;       // UART packets
+    uint32_t host_received;
+    uint32_t policed;         // Host packets and relays dropped over their rate
+    uint32_t free_heap;
+    uint16_t air_tx_pps;      // Current rates, in tenths
+    uint16_t air_rx_pps;
+    uint8_t neighbors;        // Entries of the swarm table
+    int8_t tx_power;          // dBm
+    uint8_t channel;
+    uint8_t time_master;      // drone_id of the swarm clock master, 0 = not synced
+    uint16_t crc;
+} __attribute__((packed));
+
+// Per-peer delivery counters over the broadcast sequence space of frames
+// heard directly, and round-trip percentiles over the latest latency monitor
+// pings; variable number of entries, CRC follows the last one.
+// Counters are cumulative since the bridge started.
+#define LINK_STATS_ENTRIES_PER_PACKET 4
+#define LINK_STATS_FLAG_LAST_PART 0x01
+#define LINK_STATS_FLAG_REPLY 0x02  // Answer to a request, report_id echoes its id
+
+struct LinkStatsEntry {
+    uint8_t drone_id;
+    uint32_t expected;    // Span of sequence numbers seen
+    uint32_t received;    // Distinct frames
+    uint32_t lost;        // expected - received
+    uint32_t duplicates;
+    uint32_t reordered;   // Arrived after a later frame
+    uint16_t rtt_p50;     // 0.1 ms units, 0 = never pinged
+    uint16_t rtt_p90;
+    uint16_t rtt_p99;
+} __attribute__((packed));
+
+struct LinkStatsPacket {
+    PacketHeader header;
+    uint32_t timestamp_ms;  // Bridge millis() at report time
+    uint8_t report_id;
+    uint8_t flags;
+    uint8_t part;
+    uint8_t count;
+    LinkStatsEntry entries[LINK_STATS_ENTRIES_PER_PACKET];
+    uint16_t crc;
+} __attribute__((packed));
+
+// Time synchronization: followers run NTP-style four-timestamp exchanges
+// against the master (the lowest drone_id among the bridges that volunteer);
+// all times are esp_timer microseconds. A host PING is answered with a
+// STATUS carrying the synchronized clock.
+enum TimeSyncRole : uint8_t {
+    TIME_SYNC_OFF = 0,
+    TIME_SYNC_FOLLOWER = 1,
+    TIME_SYNC_CANDIDATE = 2  // Becomes master unless a lower drone_id already is
+};
+
+enum TimeSyncOp : uint8_t {
+    TIME_SYNC_BEACON = 1,    // Master -> all, announces the master
+    TIME_SYNC_REQUEST = 2,   // Follower -> master, unicast
+    TIME_SYNC_RESPONSE = 3,  // Master -> follower, unicast
+    TIME_SYNC_STATUS = 4     // Bridge -> host, reply to a host PING
+};
+
+#define TIME_SYNC_FLAG_SYNCED 0x01  // t3 of a STATUS is master time
+#define TIME_SYNC_FLAG_MASTER 0x02
+
+struct TimeSyncPacket {
+    PacketHeader header;
+    uint8_t op;          // TimeSyncOp
+    uint8_t master_id;
+    uint8_t flags;       // TIME_SYNC_FLAG_*
+    int32_t drift_ppb;   // STATUS: rate of our clock against the master's
+    uint16_t error_us;   // STATUS: bound on the offset error, half the best round trip
+    uint64_t t1;         // REQUEST/RESPONSE: follower send time; STATUS: echoed host PING timestamp
+    uint64_t t2;         // RESPONSE: master receive time; STATUS: bridge local time
+    uint64_t t3;         // RESPONSE: master send time; BEACON/STATUS: synchronized time
+    uint16_t crc;
+} __attribute__((packed));
+
+// FILTER_RULE: the host sets one slot of the bridge's frame filter (see
+// FrameFilter.h for op and action); the bridge answers every request with
+// the slot as it now stands and the frames it decided since it was set
+#define FILTER_ALL_RULES 0xFF    // index: with op FILTER_OFF empties every slot; query: frames no rule matched
+#define FILTER_RULE_QUERY 0xFF   // op: read the slot without changing it
+
+struct FilterRulePacket {
+    PacketHeader header;
+    uint8_t index;
+    uint8_t op;
+    uint8_t action;
+    uint8_t packet_type;  // 0 = any
+    uint8_t offset;       // Of the field from the start of the frame
+    uint8_t width;        // 1, 2 or 4 bytes
+    uint32_t lo;
+    uint32_t hi;
+    uint32_t hits;        // Reply only
+    uint16_t crc;
+} __attribute__((packed));
+
+#define RX_META_FLAG_RSSI 0x01        // rssi and noise_floor were measured for this frame
+#define RX_META_FLAG_SWARM_TIME 0x02  // rx_us is on the swarm clock, else the bridge's own
+#define RX_META_FLAG_SRC_ID 0x04      // src_id comes from the air trailer
+#define RX_META_FLAG_RELAYED 0x08     // mac is the last relay's, not the originator's
+
+// RX_META: written in the same UART write as the forwarded frame, directly
+// ahead of it, and describes only that frame
+struct RxMetaPacket {
+    PacketHeader header;
+    int8_t rssi;          // dBm
+    int8_t noise_floor;   // dBm
+    uint8_t flags;        // RX_META_FLAG_*
+    uint8_t src_id;
+    uint8_t mac[6];       // Transmitter address
+    uint64_t rx_us;       // Arrival time
+    uint16_t crc;
+} __attribute__((packed));
+
+enum ChannelSwitchOp : uint8_t {
+    CHANNEL_SWITCH_REQUEST = 1,   // Host -> bridge, starts a switch
+    CHANNEL_SWITCH_ANNOUNCE = 2,  // Bridge -> all, repeated and passed on by every bridge
+    CHANNEL_SWITCH_REPORT = 3     // Bridge -> host, after the switch
+};
+
+enum ChannelSwitchStatus : uint8_t {
+    CHANNEL_SWITCH_OK = 1,        // Switched at the announced swarm time
+    CHANNEL_SWITCH_UNSYNCED = 2,  // Switched on the countdown, without the swarm clock
+    CHANNEL_SWITCH_REJECTED = 3   // Invalid channel or countdown
+};
+
+struct ChannelSwitchPacket {
+    PacketHeader header;
+    uint8_t op;               // ChannelSwitchOp
+    uint8_t channel;
+    uint8_t status;           // REPORT: ChannelSwitchStatus
+    uint16_t switch_id;       // Chosen by the host, the same on every bridge
+    uint64_t switch_at_us;    // Swarm time of the switch, 0 = unknown to the sender
+    uint32_t countdown_us;    // Time left when sent; REQUEST: delay before the switch
+    uint32_t first_frame_us;  // REPORT: switch to first frame heard on the new channel, 0 = none
+    uint16_t crc;
+} __attribute__((packed));
+
+// BULK_DATA: one chunk of a blob of up to BULK_MAX_BLOB_SIZE bytes.
+// Host and bridge exchange chunks of up to BULK_UART_CHUNK_SIZE bytes; on the
+// air the bridge re-fragments into BULK_AIR_FRAGMENT_SIZE pieces. Only
+// complete blobs are delivered to the host, always as consecutive chunks.
+#define BULK_MAX_BLOB_SIZE 4096
+#define BULK_AIR_FRAGMENT_SIZE 224
+#define BULK_FLAG_BENCHMARK 0x01  // Counted by receivers, never delivered to the host
+
+struct BulkHeader {
+    uint8_t src_id;      // Originating node, filled in by the sending bridge
+    uint8_t blob_id;
+    uint8_t flags;       // BULK_FLAG_*
+    uint16_t total_len;  // Whole blob
+    uint16_t offset;     // Of this chunk within the blob
+} __attribute__((packed));
+
+#define BULK_UART_CHUNK_SIZE (MAX_PAYLOAD_SIZE - sizeof(BulkHeader) - sizeof(uint16_t))
+
+struct BulkDataPacket {
+    PacketHeader header;
+    BulkHeader bulk;
+    uint8_t data[BULK_AIR_FRAGMENT_SIZE];  // CRC follows the last used byte
+    uint16_t crc;
+} __attribute__((packed));
+
+// Streams: a reliable byte stream to one peer over ESP-NOW unicast.
+// On the air, STREAM_DATA carries segment seq numbers; on UART the host
+// writes bytes (seq ignored) within the credit announced in STREAM_CONTROL
+// status packets, and receives in-order segments of incoming streams.
+#define STREAM_SEGMENT_SIZE 200
+#define STREAM_FLAG_SYN 0x01  // First segment of a stream
+#define STREAM_FLAG_FIN 0x02  // Last segment, carries no data
+
+struct StreamHeader {
+    uint8_t stream_id;
+    uint8_t flags;  // STREAM_FLAG_*
+    uint16_t seq;
+} __attribute__((packed));
+
+#define STREAM_UART_CHUNK_SIZE (MAX_PAYLOAD_SIZE - sizeof(StreamHeader) - sizeof(uint16_t))
+
+struct StreamDataPacket {
+    PacketHeader header;
+    StreamHeader stream;
+    uint8_t data[STREAM_SEGMENT_SIZE];  // CRC follows the last used byte
+    uint16_t crc;
+} __attribute__((packed));
+
+struct StreamAckPacket {
+    PacketHeader header;
+    uint8_t stream_id;
+    uint8_t reserved;
+    uint16_t cum_seq;     // Next segment expected in order
+    uint32_t sack_mask;   // Bit n: segment cum_seq + 1 + n received
+    uint16_t window_end;  // Segments from here on would not fit the receiver
+    uint16_t crc;
+} __attribute__((packed));
+
+enum StreamOp {
+    STREAM_OP_OPEN = 1,      // Host -> bridge: open stream_id to peer_id
+    STREAM_OP_CLOSE = 2,     // Host -> bridge: finish once everything written is acknowledged
+    STREAM_OP_STATUS = 3,    // Bridge -> host: outgoing stream state and credit
+    STREAM_OP_INCOMING = 4,  // Bridge -> host: peer_id opened stream_id to us
+    STREAM_OP_FINISHED = 5   // Bridge -> host: incoming stream complete (state) after bytes
+};
+
+enum StreamState {
+    STREAM_IDLE = 0,
+    STREAM_OPEN = 1,
+    STREAM_CLOSING = 2,
+    STREAM_CLOSED = 3,  // Every byte acknowledged
+    STREAM_FAILED = 4   // Peer unknown or no progress
+};
+
+struct StreamControlPacket {
+    PacketHeader header;
+    uint8_t op;         // StreamOp
+    uint8_t stream_id;
+    uint8_t peer_id;
+    uint8_t state;      // StreamState
+    uint16_t credit;    // Bytes the host may still write
+    uint32_t bytes;     // Accepted from the host (outgoing) or delivered to it (incoming) so far
+    uint16_t crc;
+} __attribute__((packed));
+
+// Forward error correction: after a group of small broadcast frames the
+// sender adds one XOR parity frame, from which a receiver that missed
+// exactly one member rebuilds it. Members are identified by air seq.
+#define FEC_MAX_GROUP 16        // Bits in member_mask
+#define FEC_MAX_FRAME_SIZE 160  // Larger packets are sent unprotected
+
+struct FecParityPacket {
+    PacketHeader header;
+    uint16_t first_seq;                  // Air seq of member bit 0
+    uint16_t member_mask;                // Bit n: frame first_seq + n is a member
+    uint8_t parity[FEC_MAX_FRAME_SIZE];  // XOR of the members zero-padded to the longest; CRC follows
+    uint16_t crc;
+} __attribute__((packed));
+
+// Outcome of a reliable COMMAND once every expected receiver acknowledged or retries ran out
+#define DELIVERY_OK 0       // All expected receivers acknowledged
+#define DELIVERY_PARTIAL 1  // Retries exhausted, some receivers acknowledged
+#define DELIVERY_FAILED 2   // Retries exhausted, no acknowledgement
+
+struct DeliveryReportPacket {
+    PacketHeader header;
+    uint8_t command_id;
+    uint8_t target_id;
+    uint8_t result;           // DELIVERY_*
+    uint8_t retransmissions;
+    uint8_t expected;         // Receivers that had to acknowledge
+    uint8_t acked;
+    uint16_t latency_ms;      // First transmission to last ACK (or to giving up)
+    uint16_t crc;
+} __attribute__((packed));
+
 #endif // PACKET_H
\ No newline at end of file
@@ -2,11 +2,27 @@
 #include "Statistics.h"
 #include "ESPNowManager.h"
 #include "ConfigManager.h"
+#include "SwarmTable.h"
+#include "BulkTransfer.h"
+#include "StreamManager.h"
+#include "LinkMonitor.h"
+#include "TimeSync.h"
+#include "RateLimiter.h"
+#include "ChannelSwitch.h"
+#include "RemoteStats.h"
+#include "HostLink.h"
 #include "crc_utils.h"
 
 extern Statistics stats;
 extern ESPNowManager espNowManager;
-extern void saveESPNowConfigAndRestart(uint8_t network_id, uint8_t wifi_channel, uint8_t tx_power);
+extern SwarmTable swarmTable;
+extern BulkTransfer bulkTransfer;
+extern StreamManager streamManager;
+extern LinkMonitor linkMonitor;
+extern TimeSync timeSync;
+extern RateLimiter rateLimiter;
+extern ChannelSwitch channelSwitch;
+extern RemoteStats remoteStats;
 
 void PacketDeserializer::processReceivedData() {
     while (Serial1.available()) {
@@ -83,8 +99,20 @@ void PacketDeserializer::processReceivedData() {
 }
 
 void PacketDeserializer::handleReceivedPacket(const uint8_t* data, size_t length, uint8_t packet_type) {
-    stats.uart.by_type[packet_type].packets_received++;
-    stats.uart.by_type[packet_type].bytes_received += length;
+    if (packet_type < PACKET_TYPE_COUNT) {
+        stats.uart.by_type[packet_type].packets_received++;
+        stats.uart.by_type[packet_type].bytes_received += length;
+    }
+
+    // Police what goes on the air; local control is never limited, nor are
+    // transfers that pace themselves and would lose chunks without a trace
+    if (packet_type != CONFIG && packet_type != BRIDGE_CONTROL && packet_type != PING &&
+        packet_type != CHANNEL_SWITCH && packet_type != FILTER_RULE &&
+        packet_type != STREAM_DATA && packet_type != STREAM_CONTROL && packet_type != BULK_DATA &&
+        !rateLimiter.allowType(packet_type, millis())) {
+        stats.policing.dropped[packet_type]++;
+        return;
+    }
 
     switch(packet_type) {
         case CONFIG: {
@@ -93,14 +121,43 @@ void PacketDeserializer::handleReceivedPacket(const uint8_t* data, size_t length
                 Serial.printf("Received CONFIG packet: network_id=%d, wifi_channel=%d, tx_power=%d\n", 
                              packet->network_id, packet->wifi_channel, packet->tx_power);
                 
-                // Save configuration and restart ESP32
-                saveESPNowConfigAndRestart(packet->network_id, packet->wifi_channel, packet->tx_power);
+                // Switch the radio in place, saved in the background
+                applyESPNowConfig(packet->network_id, packet->wifi_channel, packet->tx_power);
+            }
+            break;
+        }
+        case CHANNEL_SWITCH: {
+            if (length >= sizeof(ChannelSwitchPacket)) {
+                const ChannelSwitchPacket* packet = (const ChannelSwitchPacket*)data;
+                if (packet->op == CHANNEL_SWITCH_REQUEST) {
+                    channelSwitch.handleHost(*packet);
+                }
+            }
+            break;
+        }
+        case STATS: {
+            if (length >= sizeof(StatsPacket)) {
+                remoteStats.handleHost(*(const StatsPacket*)data);
+            }
+            break;
+        }
+        case FILTER_RULE: {
+            if (length >= sizeof(FilterRulePacket)) {
+                handleFilterRule(*(const FilterRulePacket*)data);
+            }
+            break;
+        }
+        case BRIDGE_CONTROL: {
+            if (length >= sizeof(BridgeControlPacket)) {
+                handleBridgeControl(*(const BridgeControlPacket*)data);
             }
             break;
         }
         case TELEMETRY: {
             if (length >= sizeof(TelemetryPacket)) {
                 const TelemetryPacket* packet = (const TelemetryPacket*)data;
+                swarmTable.updateSelf(*packet, millis());
+                espNowManager.setNodeId(packet->drone_id);
                 
                 if (!espNowManager.sendTelemetryPacket(*packet)) {
                     Serial.println("ERROR: Failed to forward telemetry via ESP-NOW");
@@ -143,6 +200,10 @@ void PacketDeserializer::handleReceivedPacket(const uint8_t* data, size_t length
             break;
         }
         case PING: {
+            // Answered with the local and synchronized swarm clock
+            if (length >= sizeof(PingPacket)) {
+                timeSync.handleHostPing(*(const PingPacket*)data);
+            }
             break;
         }
         case ACK: {
@@ -151,6 +212,21 @@ void PacketDeserializer::handleReceivedPacket(const uint8_t* data, size_t length
         }
         case BULK_DATA: {
             // No logging for bulk data - too verbose
+            if (length >= offsetof(BulkDataPacket, data) + sizeof(uint16_t)) {
+                bulkTransfer.handleHostChunk(*(const BulkDataPacket*)data, length, millis());
+            }
+            break;
+        }
+        case STREAM_DATA: {
+            if (length >= offsetof(StreamDataPacket, data) + sizeof(uint16_t)) {
+                streamManager.handleHostData(*(const StreamDataPacket*)data, length, millis());
+            }
+            break;
+        }
+        case STREAM_CONTROL: {
+            if (length == sizeof(StreamControlPacket)) {
+                streamManager.handleHostControl(*(const StreamControlPacket*)data, millis());
+            }
             break;
         }
         default: {
@@ -158,4 +234,150 @@ void PacketDeserializer::handleReceivedPacket(const uint8_t* data, size_t length
             break;
         }
     }
-}
\ No newline at end of file
+}
+
+void PacketDeserializer::handleBridgeControl(const BridgeControlPacket& packet) {
+    switch (packet.command) {
+        case CTRL_SET_SNAPSHOT_INTERVAL: {
+            swarmTable.setSnapshotInterval(packet.value > 0 ? (uint32_t)packet.value : 0);
+            break;
+        }
+        case CTRL_SET_INTEREST_RADIUS: {
+            swarmTable.setInterestRadius(packet.value);
+            break;
+        }
+        case CTRL_SET_INTEREST_K: {
+            swarmTable.setInterestK(constrain(packet.value, (int32_t)0, (int32_t)255));
+            break;
+        }
+        case CTRL_SET_CONFLICT_RADIUS: {
+            swarmTable.setConflictRadius(packet.value);
+            break;
+        }
+        case CTRL_SET_CONFLICT_HORIZON: {
+            swarmTable.setConflictHorizon(packet.value > 0 ? (uint32_t)packet.value : 0);
+            break;
+        }
+        case CTRL_REQUEST_POSITIONS: {
+            swarmTable.publishPositions(packet.arg, packet.value > 0 ? (uint32_t)packet.value : 0, millis());
+            break;
+        }
+        case CTRL_SET_NEIGHBOR_EVENTS: {
+            swarmTable.setNeighborEvents(packet.value != 0);
+            break;
+        }
+        case CTRL_REQUEST_NEIGHBORS: {
+            swarmTable.publishNeighbors(packet.arg, millis());
+            break;
+        }
+        case CTRL_SET_COMMAND_RETRIES: {
+            espNowManager.setCommandRetries(constrain(packet.value, (int32_t)0, (int32_t)15));
+            break;
+        }
+        case CTRL_BULK_BENCHMARK: {
+            bulkTransfer.startBenchmark(constrain(packet.value, (int32_t)0, (int32_t)BULK_MAX_BLOB_SIZE), packet.arg);
+            break;
+        }
+        case CTRL_SET_FEC_GROUP: {
+            espNowManager.setFecGroupSize(constrain(packet.value, (int32_t)0, (int32_t)FEC_MAX_GROUP));
+            break;
+        }
+        case CTRL_LINK_BENCHMARK: {
+            espNowManager.startLinkBenchmark(packet.arg, constrain(packet.value, (int32_t)0, (int32_t)LINK_BENCH_MAX_PROBES));
+            break;
+        }
+        case CTRL_SET_RELAY_HOPS: {
+            espNowManager.setRelayHops(constrain(packet.value, (int32_t)0, (int32_t)AIR_MAX_TTL));
+            break;
+        }
+        case CTRL_SET_RELAY_POLICY: {
+            espNowManager.setRelayPolicy((uint32_t)packet.value);
+            break;
+        }
+        case CTRL_SET_LINK_REPORT_INTERVAL: {
+            linkMonitor.setReportInterval(packet.value > 0 ? (uint32_t)packet.value : 0);
+            break;
+        }
+        case CTRL_REQUEST_LINK_STATS: {
+            linkMonitor.publish(packet.arg, LINK_STATS_FLAG_REPLY, millis());
+            break;
+        }
+        case CTRL_SET_PING_INTERVAL: {
+            espNowManager.setPingInterval(constrain(packet.value, (int32_t)0, (int32_t)60000));
+            break;
+        }
+        case CTRL_SET_TDMA: {
+            espNowManager.setTdma(packet.arg, packet.value > 0 ? (uint32_t)packet.value : TDMA_DEFAULT_SLOT_US);
+            break;
+        }
+        case CTRL_SET_TX_JITTER: {
+            espNowManager.setTxJitter(constrain(packet.value, (int32_t)0, (int32_t)TX_JITTER_MAX_WINDOW_MS));
+            break;
+        }
+        case CTRL_SET_RATE_LIMIT: {
+            uint16_t rate = (uint32_t)packet.value & 0xFFFF;
+            uint16_t burst = (uint32_t)packet.value >> 16;
+            if (packet.arg == RATE_LIMIT_RELAY) {
+                rateLimiter.setSourceLimit(rate, burst);
+            } else {
+                rateLimiter.setTypeLimit(packet.arg, rate, burst);
+            }
+            break;
+        }
+        case CTRL_SET_RX_META: {
+            espNowManager.setRxMeta(packet.value != 0);
+            break;
+        }
+        case CTRL_SUBSCRIBE_NETWORK: {
+            espNowManager.subscribeNetwork(packet.arg, packet.value != 0);
+            break;
+        }
+        case CTRL_SET_TX_POWER_CONTROL: {
+            espNowManager.setTxPowerControl(packet.arg, constrain(packet.value, (int32_t)0, (int32_t)TX_POWER_MAX_DBM));
+            break;
+        }
+        case CTRL_SET_TIME_SYNC: {
+            timeSync.setRole(constrain(packet.value, (int32_t)TIME_SYNC_OFF, (int32_t)TIME_SYNC_CANDIDATE));
+            break;
+        }
+        default: {
+            Serial.printf("Unknown bridge control command: %d\n", packet.command);
+            break;
+        }
+    }
+}
+
+void PacketDeserializer::handleFilterRule(const FilterRulePacket& packet) {
+    if (packet.op != FILTER_RULE_QUERY) {
+        if (packet.index == FILTER_ALL_RULES && packet.op == FILTER_OFF) {
+            espNowManager.clearFilter();
+        } else {
+            FilterRule rule;
+            rule.op = packet.op;
+            rule.action = packet.action;
+            rule.packet_type = packet.packet_type;
+            rule.offset = packet.offset;
+            rule.width = packet.width;
+            rule.lo = packet.lo;
+            rule.hi = packet.hi;
+            espNowManager.setFilterRule(packet.index, rule);
+        }
+    }
+
+    // The slot as it now stands, a rejected rule leaves it unchanged
+    FilterRule rule;
+    FilterRulePacket reply;
+    memset(&reply, 0, sizeof(reply));
+    reply.hits = espNowManager.readFilterRule(packet.index, rule);
+    initPacketHeader(reply.header, FILTER_RULE, sizeof(reply), espNowManager.getConfig().network_id);
+    reply.index = packet.index;
+    reply.op = rule.op;
+    reply.action = rule.action;
+    reply.packet_type = rule.packet_type;
+    reply.offset = rule.offset;
+    reply.width = rule.width;
+    reply.lo = rule.lo;
+    reply.hi = rule.hi;
+    sealPacket((uint8_t*)&reply, sizeof(reply));
+    sendToHost((uint8_t*)&reply, sizeof(reply));
+}
@@ -12,6 +12,8 @@ public:
 
 private:
     void handleReceivedPacket(const uint8_t* data, size_t length, uint8_t packet_type);
+    void handleBridgeControl(const BridgeControlPacket& packet);
+    void handleFilterRule(const FilterRulePacket& packet);
 
     uint8_t rx_buffer[RX_BUFFER_SIZE];
     int rx_buffer_pos = 0;
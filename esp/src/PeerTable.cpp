@@ -0,0 +1,28 @@
+#include "PeerTable.h"
+
+PeerTable::PeerTable() {
+    memset(known, 0, sizeof(known));
+}
+
+void PeerTable::learn(uint8_t id, const uint8_t* mac) {
+    portENTER_CRITICAL(&lock);
+    memcpy(mac_by_id[id], mac, 6);
+    known[id] = true;
+    portEXIT_CRITICAL(&lock);
+}
+
+void PeerTable::clear() {
+    portENTER_CRITICAL(&lock);
+    memset(known, 0, sizeof(known));
+    portEXIT_CRITICAL(&lock);
+}
+
+bool PeerTable::lookup(uint8_t id, uint8_t* mac) {
+    portENTER_CRITICAL(&lock);
+    bool found = known[id];
+    if (found) {
+        memcpy(mac, mac_by_id[id], 6);
+    }
+    portEXIT_CRITICAL(&lock);
+    return found;
+}
@@ -0,0 +1,25 @@
+#ifndef PEER_TABLE_H
+#define PEER_TABLE_H
+
+#include <Arduino.h>
+
+// drone_id -> MAC address, learned from the air trailer of every frame
+// received. ESP-NOW addresses unicast frames by MAC only, so this is what
+// lets the bridge talk to one drone directly. Written from the receive
+// callback, read from loop().
+class PeerTable {
+public:
+    PeerTable();
+
+    void learn(uint8_t drone_id, const uint8_t* mac);
+    bool lookup(uint8_t drone_id, uint8_t* mac);
+    // Forget everyone, e.g. after switching to another network
+    void clear();
+
+private:
+    portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+    bool known[256];
+    uint8_t mac_by_id[256][6];
+};
+
+#endif // PEER_TABLE_H
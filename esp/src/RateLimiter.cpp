@@ -0,0 +1,77 @@
+#include "RateLimiter.h"
+
+void TokenBucket::configure(uint16_t r, uint16_t b, uint32_t now_ms) {
+    rate = r;
+    burst = r > 0 ? max(b, (uint16_t)1) : 0;
+    milli_tokens = (uint32_t)burst * 1000;  // Start full
+    last_ms = now_ms;
+}
+
+bool TokenBucket::take(uint32_t now_ms) {
+    if (rate == 0) return true;
+    // rate tokens per second is rate milli-tokens per millisecond
+    uint64_t refilled = milli_tokens + (uint64_t)(now_ms - last_ms) * rate;
+    milli_tokens = (uint32_t)min(refilled, (uint64_t)burst * 1000);
+    last_ms = now_ms;
+    if (milli_tokens < 1000) return false;
+    milli_tokens -= 1000;
+    return true;
+}
+
+void RateLimiter::setTypeLimit(uint8_t packet_type, uint16_t rate, uint16_t burst) {
+    if (packet_type >= PACKET_TYPE_COUNT) {
+        Serial.printf("ERROR: Rate limit for unknown packet type %u\n", packet_type);
+        return;
+    }
+    types[packet_type].configure(rate, burst, millis());
+    if (rate > 0) {
+        Serial.printf("Rate limit type %u: %u/s, burst %u\n", packet_type, rate, types[packet_type].burst);
+    } else {
+        Serial.printf("Rate limit type %u: off\n", packet_type);
+    }
+}
+
+void RateLimiter::setSourceLimit(uint16_t rate, uint16_t burst) {
+    portENTER_CRITICAL(&lock);
+    source_rate = rate;
+    source_burst = burst;
+    for (uint8_t i = 0; i < RATE_LIMIT_SOURCES; i++) {
+        sources[i].used = false;
+    }
+    portEXIT_CRITICAL(&lock);
+    if (rate > 0) {
+        Serial.printf("Relay rate limit per source: %u/s, burst %u\n", rate, max(burst, (uint16_t)1));
+    } else {
+        Serial.println("Relay rate limit per source: off");
+    }
+}
+
+bool RateLimiter::allowType(uint8_t packet_type, uint32_t now_ms) {
+    return packet_type >= PACKET_TYPE_COUNT || types[packet_type].take(now_ms);
+}
+
+bool RateLimiter::allowSource(uint8_t src_id, uint32_t now_ms) {
+    bool allowed = true;
+    portENTER_CRITICAL(&lock);
+    if (source_rate > 0) {
+        SourceBucket* slot = nullptr;
+        SourceBucket* idlest = &sources[0];
+        for (uint8_t i = 0; i < RATE_LIMIT_SOURCES && !slot; i++) {
+            SourceBucket& entry = sources[i];
+            if (entry.used && entry.src_id == src_id) {
+                slot = &entry;
+            } else if (!entry.used || (idlest->used && now_ms - entry.bucket.last_ms > now_ms - idlest->bucket.last_ms)) {
+                idlest = &entry;
+            }
+        }
+        if (!slot) {
+            slot = idlest;
+            slot->used = true;
+            slot->src_id = src_id;
+            slot->bucket.configure(source_rate, source_burst, now_ms);
+        }
+        allowed = slot->bucket.take(now_ms);
+    }
+    portEXIT_CRITICAL(&lock);
+    return allowed;
+}
@@ -0,0 +1,50 @@
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include <Arduino.h>
+#include "Packet.h"
+
+#define RATE_LIMIT_SOURCES 16    // Originators with a relay bucket, the idlest one makes room
+#define RATE_LIMIT_RELAY 0xFF    // CTRL_SET_RATE_LIMIT arg for the per-source relay buckets
+
+// rate tokens per second up to burst tokens; a packet takes one
+struct TokenBucket {
+    uint16_t rate = 0;          // 0 = unlimited
+    uint16_t burst = 0;
+    uint32_t milli_tokens = 0;
+    uint32_t last_ms = 0;
+
+    void configure(uint16_t rate, uint16_t burst, uint32_t now_ms);
+    bool take(uint32_t now_ms);
+};
+
+struct SourceBucket {
+    bool used = false;
+    uint8_t src_id = 0;
+    TokenBucket bucket;
+};
+
+// Policing of what this bridge puts on the air, so one misbehaving host or
+// node cannot take the shared channel. Packets from the host are policed
+// per type before they are forwarded, rebroadcasts of the mesh relay per
+// originator. Everything is unlimited until configured.
+class RateLimiter {
+public:
+    void setTypeLimit(uint8_t packet_type, uint16_t rate, uint16_t burst);
+    void setSourceLimit(uint16_t rate, uint16_t burst);
+
+    // Host packets, from loop()
+    bool allowType(uint8_t packet_type, uint32_t now_ms);
+    // Relayed frames, from the ESP-NOW receive callback
+    bool allowSource(uint8_t src_id, uint32_t now_ms);
+
+private:
+    TokenBucket types[PACKET_TYPE_COUNT];
+
+    portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+    uint16_t source_rate = 0;
+    uint16_t source_burst = 0;
+    SourceBucket sources[RATE_LIMIT_SOURCES];
+};
+
+#endif // RATE_LIMITER_H
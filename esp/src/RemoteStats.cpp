@@ -0,0 +1,126 @@
+#include "RemoteStats.h"
+#include "ESPNowManager.h"
+#include "PeerTable.h"
+#include "SwarmTable.h"
+#include "Statistics.h"
+#include "HostLink.h"
+#include "crc_utils.h"
+
+extern ESPNowManager espNowManager;
+extern PeerTable peerTable;
+extern SwarmTable swarmTable;
+extern Statistics stats;
+
+void RemoteStats::handleHost(const StatsPacket& packet) {
+    if (packet.op != STATS_REQUEST) return;
+    uint8_t own_id = espNowManager.getNodeId();
+
+    if (packet.target_id == own_id || packet.target_id == STATS_TARGET_ALL) {
+        StatsPacket reply;
+        fill(reply, packet.query_id);
+        sendToHost((uint8_t*)&reply, sizeof(reply));
+    }
+    if (packet.target_id == own_id) return;
+
+    StatsPacket request;
+    memset(&request, 0, sizeof(request));
+    request.op = STATS_REQUEST;
+    request.target_id = packet.target_id;
+    request.src_id = own_id;
+    request.query_id = packet.query_id;
+    initPacketHeader(request.header, STATS, sizeof(request), espNowManager.getConfig().network_id);
+    sealPacket((uint8_t*)&request, sizeof(request));
+
+    uint8_t mac[6];
+    bool sent = packet.target_id != STATS_TARGET_ALL && peerTable.lookup(packet.target_id, mac)
+                    ? espNowManager.sendUnicast(mac, (uint8_t*)&request, sizeof(request))
+                    : espNowManager.sendPacket((uint8_t*)&request, sizeof(request));
+    if (sent) {
+        stats.remote.requests_sent++;
+    }
+}
+
+void RemoteStats::handleAir(const uint8_t* mac, const AirTrailer* trailer, const StatsPacket& packet) {
+    uint8_t own_id = espNowManager.getNodeId();
+    if (packet.target_id != own_id && packet.target_id != STATS_TARGET_ALL) return;
+
+    // A relay's MAC is not the one that asked
+    uint8_t reply_to[6];
+    if (trailer && (trailer->flags & AIR_FLAG_RELAYED)) {
+        if (!peerTable.lookup(trailer->src_id, reply_to)) {
+            stats.remote.unreachable++;
+            return;
+        }
+    } else {
+        memcpy(reply_to, mac, 6);
+    }
+
+    uint32_t now = millis();
+    portENTER_CRITICAL(&lock);
+    bool limited = pending || (replied && now - last_reply_ms < STATS_REPLY_MIN_INTERVAL_MS);
+    if (!limited) {
+        pending = true;
+        memcpy(reply_mac, reply_to, 6);
+        reply_query = packet.query_id;
+        reply_due_ms = now;
+        if (packet.target_id == STATS_TARGET_ALL) {
+            reply_due_ms += (own_id % STATS_REPLY_SLOTS) * STATS_REPLY_SLOT_MS;
+        }
+    }
+    portEXIT_CRITICAL(&lock);
+
+    if (limited) {
+        stats.remote.rate_limited++;
+    }
+}
+
+void RemoteStats::update(uint32_t now_ms) {
+    if (!pending || (int32_t)(now_ms - reply_due_ms) < 0) return;
+
+    uint8_t mac[6];
+    portENTER_CRITICAL(&lock);
+    memcpy(mac, reply_mac, 6);
+    uint8_t query_id = reply_query;
+    pending = false;
+    replied = true;
+    last_reply_ms = now_ms;
+    portEXIT_CRITICAL(&lock);
+
+    StatsPacket reply;
+    fill(reply, query_id);
+    if (espNowManager.sendUnicast(mac, (uint8_t*)&reply, sizeof(reply))) {
+        stats.remote.replies_sent++;
+    }
+}
+
+void RemoteStats::fill(StatsPacket& packet, uint8_t query_id) {
+    ESPNowConfig config = espNowManager.getConfig();
+    unsigned long policed = stats.policing.relay_dropped;
+    for (uint8_t i = 0; i < PACKET_TYPE_COUNT; i++) {
+        policed += stats.policing.dropped[i];
+    }
+
+    memset(&packet, 0, sizeof(packet));
+    packet.op = STATS_REPLY;
+    packet.target_id = STATS_TARGET_ALL;
+    packet.src_id = espNowManager.getNodeId();
+    packet.query_id = query_id;
+    packet.uptime_s = millis() / 1000;
+    packet.air_sent = stats.espnow.packets_sent;
+    packet.air_received = stats.espnow.packets_received;
+    packet.air_corrupted = stats.espnow.packets_corrupted;
+    packet.send_failures = espNowManager.getSendFailures();
+    packet.host_sent = stats.uart.packets_sent;
+    packet.host_received = stats.uart.packets_received;
+    packet.policed = policed;
+    packet.free_heap = ESP.getFreeHeap();
+    packet.air_tx_pps = (uint16_t)constrain(stats.espnow.current_tx_pps * 10.0f, 0.0f, 65535.0f);
+    packet.air_rx_pps = (uint16_t)constrain(stats.espnow.current_rx_pps * 10.0f, 0.0f, 65535.0f);
+    packet.neighbors = swarmTable.size();
+    packet.tx_power = stats.power.dbm != 0 ? stats.power.dbm : (int8_t)config.tx_power;
+    packet.channel = config.channel;
+    packet.time_master = stats.time.synced || stats.time.is_master ? stats.time.master_id : 0;
+
+    initPacketHeader(packet.header, STATS, sizeof(packet), config.network_id);
+    sealPacket((uint8_t*)&packet, sizeof(packet));
+}
@@ -0,0 +1,43 @@
+#ifndef REMOTE_STATS_H
+#define REMOTE_STATS_H
+
+#include <Arduino.h>
+#include "Packet.h"
+
+#define STATS_REPLY_MIN_INTERVAL_MS 500  // A bridge answers at most this often, later requests are dropped
+#define STATS_REPLY_SLOT_MS 4            // Replies to a swarm-wide request are spread by drone_id
+#define STATS_REPLY_SLOTS 32
+
+// Pull of statistics snapshots over ESP-NOW, so a ground bridge or the
+// controller can watch every bridge of the swarm without a USB cable. A
+// REQUEST names one drone_id or all of them; each bridge asked answers once
+// per STATS_REPLY_MIN_INTERVAL_MS with a REPLY unicast to the station that
+// asked. Replies to a swarm-wide request leave in slots by drone_id rather
+// than all at once. The reply is built and sent from loop(), never from the
+// receive callback.
+class RemoteStats {
+public:
+    // REQUEST from the host: our own snapshot goes straight back, other
+    // drones are asked on the air (unicast when their MAC is known)
+    void handleHost(const StatsPacket& packet);
+
+    // REQUEST from the ESP-NOW receive callback; trailer is null for stations
+    // that send plain packets, like the controller
+    void handleAir(const uint8_t* mac, const AirTrailer* trailer, const StatsPacket& packet);
+
+    // Reply due, called from loop()
+    void update(uint32_t now_ms);
+
+private:
+    void fill(StatsPacket& packet, uint8_t query_id);
+
+    portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+    bool pending = false;
+    uint8_t reply_mac[6];
+    uint8_t reply_query = 0;
+    uint32_t reply_due_ms = 0;
+    bool replied = false;
+    uint32_t last_reply_ms = 0;
+};
+
+#endif // REMOTE_STATS_H
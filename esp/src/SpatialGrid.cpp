@@ -0,0 +1,140 @@
+#include "SpatialGrid.h"
+
+#define GRID_MAX_NEAREST 64
+
+void SpatialGrid::setCellSize(int32_t size_cm) {
+    cell_cm = size_cm > 0 ? size_cm : GRID_DEFAULT_CELL_CM;
+}
+
+int32_t SpatialGrid::cellOf(int32_t v) const {
+    // Floor division so that cells are uniform across zero
+    return v >= 0 ? v / cell_cm : -((-v + cell_cm - 1) / cell_cm);
+}
+
+uint8_t SpatialGrid::bucketOf(int32_t cx, int32_t cy, int32_t cz) {
+    uint32_t h = (uint32_t)cx * 73856093u ^ (uint32_t)cy * 19349663u ^ (uint32_t)cz * 83492791u;
+    return h & (GRID_BUCKETS - 1);
+}
+
+int64_t SpatialGrid::distance2(uint8_t slot, int32_t px, int32_t py, int32_t pz) const {
+    int64_t dx = xs[slot] - px;
+    int64_t dy = ys[slot] - py;
+    int64_t dz = zs[slot] - pz;
+    return dx * dx + dy * dy + dz * dz;
+}
+
+void SpatialGrid::rebuild(const bool* active_slots, const int32_t* x, const int32_t* y, const int32_t* z,
+                          uint8_t capacity) {
+    active = active_slots;
+    xs = x;
+    ys = y;
+    zs = z;
+    slot_count = capacity;
+    memset(head, GRID_SLOT_NONE, sizeof(head));
+
+    for (uint8_t i = 0; i < capacity; i++) {
+        if (!active[i]) continue;
+        uint8_t b = bucketOf(cellOf(x[i]), cellOf(y[i]), cellOf(z[i]));
+        next[i] = head[b];
+        head[b] = i;
+    }
+}
+
+uint8_t SpatialGrid::queryRadius(int32_t px, int32_t py, int32_t pz, int32_t radius_cm,
+                                 uint8_t* out, uint8_t max_out) const {
+    if (!active || radius_cm <= 0) return 0;
+
+    int64_t r2 = (int64_t)radius_cm * radius_cm;
+    int32_t reach = (radius_cm + cell_cm - 1) / cell_cm;
+    int32_t cx = cellOf(px), cy = cellOf(py), cz = cellOf(pz);
+    uint64_t visited = 0;
+    uint8_t n = 0;
+
+    // Large radii cover every bucket anyway
+    if ((2 * reach + 1) * (2 * reach + 1) * (2 * reach + 1) >= GRID_BUCKETS) {
+        for (uint8_t i = 0; i < slot_count && n < max_out; i++) {
+            if (active[i] && distance2(i, px, py, pz) <= r2) out[n++] = i;
+        }
+        return n;
+    }
+
+    for (int32_t dx = -reach; dx <= reach; dx++) {
+        for (int32_t dy = -reach; dy <= reach; dy++) {
+            for (int32_t dz = -reach; dz <= reach; dz++) {
+                uint8_t b = bucketOf(cx + dx, cy + dy, cz + dz);
+                if (visited & (1ULL << b)) continue;
+                visited |= 1ULL << b;
+
+                for (uint8_t s = head[b]; s != GRID_SLOT_NONE; s = next[s]) {
+                    if (n < max_out && distance2(s, px, py, pz) <= r2) out[n++] = s;
+                }
+            }
+        }
+    }
+    return n;
+}
+
+uint8_t SpatialGrid::queryNearest(int32_t px, int32_t py, int32_t pz, uint8_t k, int32_t radius_cm,
+                                  uint8_t* out) const {
+    if (!active || k == 0) return 0;
+    if (k > GRID_MAX_NEAREST) k = GRID_MAX_NEAREST;
+
+    // Best candidates so far, kept sorted by distance
+    int64_t best_d2[GRID_MAX_NEAREST];
+    uint8_t best_slot[GRID_MAX_NEAREST];
+    uint8_t found = 0;
+    int64_t r2 = radius_cm > 0 ? (int64_t)radius_cm * radius_cm : INT64_MAX;
+
+    auto consider = [&](uint8_t s) {
+        int64_t d2 = distance2(s, px, py, pz);
+        if (d2 > r2) return;
+        if (found == k && d2 >= best_d2[k - 1]) return;
+        uint8_t pos = found < k ? found++ : k - 1;
+        while (pos > 0 && best_d2[pos - 1] > d2) {
+            best_d2[pos] = best_d2[pos - 1];
+            best_slot[pos] = best_slot[pos - 1];
+            pos--;
+        }
+        best_d2[pos] = d2;
+        best_slot[pos] = s;
+    };
+
+    int32_t cx = cellOf(px), cy = cellOf(py), cz = cellOf(pz);
+    uint64_t visited = 0;
+    bool done = false;
+
+    // Expand shells of cells around the query until the k-th candidate is
+    // provably closer than anything in the unvisited shells
+    for (int32_t ring = 0; ring <= GRID_MAX_RING && !done; ring++) {
+        for (int32_t dx = -ring; dx <= ring; dx++) {
+            for (int32_t dy = -ring; dy <= ring; dy++) {
+                for (int32_t dz = -ring; dz <= ring; dz++) {
+                    if (abs(dx) != ring && abs(dy) != ring && abs(dz) != ring) continue;
+                    uint8_t b = bucketOf(cx + dx, cy + dy, cz + dz);
+                    if (visited & (1ULL << b)) continue;
+                    visited |= 1ULL << b;
+                    for (uint8_t s = head[b]; s != GRID_SLOT_NONE; s = next[s]) {
+                        consider(s);
+                    }
+                }
+            }
+        }
+
+        int64_t covered = (int64_t)ring * cell_cm;
+        if (found == k && best_d2[k - 1] <= covered * covered) done = true;
+        if (radius_cm > 0 && covered >= radius_cm) done = true;
+    }
+
+    // Sparse swarm: scan whatever buckets the shells did not reach
+    if (!done) {
+        for (uint8_t b = 0; b < GRID_BUCKETS; b++) {
+            if (visited & (1ULL << b)) continue;
+            for (uint8_t s = head[b]; s != GRID_SLOT_NONE; s = next[s]) {
+                consider(s);
+            }
+        }
+    }
+
+    memcpy(out, best_slot, found);
+    return found;
+}
@@ -0,0 +1,46 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <Arduino.h>
+
+#define GRID_BUCKETS 64            // Power of two, cells are hashed into buckets
+#define GRID_DEFAULT_CELL_CM 500
+#define GRID_MAX_RING 3            // kNN falls back to a full scan beyond this
+#define GRID_SLOT_NONE 0xFF
+
+// Uniform grid over slot positions (centimetres). Cells are hashed into a
+// fixed bucket array with intrusive per-slot links, so rebuilding is O(n)
+// and needs no allocation. Holds slot indices only; the caller owns the
+// position arrays and keeps them stable while querying.
+class SpatialGrid {
+public:
+    void setCellSize(int32_t cell_cm);
+    int32_t getCellSize() const { return cell_cm; }
+
+    void rebuild(const bool* active, const int32_t* x, const int32_t* y, const int32_t* z, uint8_t capacity);
+
+    // Slots within radius_cm of the point, returns number written to out
+    uint8_t queryRadius(int32_t px, int32_t py, int32_t pz, int32_t radius_cm,
+                        uint8_t* out, uint8_t max_out) const;
+
+    // Up to k nearest slots, nearest first, optionally limited to radius_cm (0 = unlimited)
+    uint8_t queryNearest(int32_t px, int32_t py, int32_t pz, uint8_t k, int32_t radius_cm,
+                         uint8_t* out) const;
+
+private:
+    int32_t cellOf(int32_t v) const;
+    static uint8_t bucketOf(int32_t cx, int32_t cy, int32_t cz);
+    int64_t distance2(uint8_t slot, int32_t px, int32_t py, int32_t pz) const;
+
+    int32_t cell_cm = GRID_DEFAULT_CELL_CM;
+    uint8_t head[GRID_BUCKETS];
+    uint8_t next[256];
+    uint8_t slot_count = 0;
+
+    const bool* active = nullptr;
+    const int32_t* xs = nullptr;
+    const int32_t* ys = nullptr;
+    const int32_t* zs = nullptr;
+};
+
+#endif // SPATIAL_GRID_H
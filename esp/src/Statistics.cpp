@@ -94,6 +94,218 @@ void Statistics::print() {
             Serial.printf("ESP-NOW Error Rate: %.2f%%\n", espnow_error_rate);
         }
         
+        // Swarm table
+        if (swarm.snapshots_sent > 0 || swarm.telemetry_absorbed > 0 || swarm.position_queries > 0 ||
+            swarm.interest_forwarded > 0 || swarm.interest_filtered > 0 || swarm.cpa_checks > 0 ||
+            swarm.neighbor_events > 0) {
+            Serial.println("\n--- SWARM TABLE ---");
+            Serial.printf("Snapshots: %lu (%lu packets), position queries: %lu, telemetry absorbed: %lu\n",
+                         swarm.snapshots_sent, swarm.snapshot_packets, swarm.position_queries,
+                         swarm.telemetry_absorbed);
+            Serial.printf("Entries expired: %lu, evicted: %lu\n",
+                         swarm.entries_expired, swarm.entries_evicted);
+            if (swarm.neighbor_events + swarm.neighbor_events_dropped > 0) {
+                Serial.printf("Neighbour events: %lu sent, %lu dropped\n",
+                             swarm.neighbor_events, swarm.neighbor_events_dropped);
+            }
+            if (swarm.interest_forwarded + swarm.interest_filtered > 0) {
+                Serial.printf("Interest: %lu forwarded, %lu filtered (%.1f%% filtered)\n",
+                             swarm.interest_forwarded, swarm.interest_filtered,
+                             swarm.interest_filtered * 100.0f / (swarm.interest_forwarded + swarm.interest_filtered));
+            }
+            if (swarm.cpa_checks > 0) {
+                Serial.printf("CPA: %lu checks, %lu conflicts, %lu alerts sent\n",
+                             swarm.cpa_checks, swarm.conflicts_detected, swarm.alerts_sent);
+            }
+        }
+        
+        // Reliable commands
+        if (reliable.commands_sent > 0 || reliable.acks_sent > 0) {
+            Serial.println("\n--- RELIABLE COMMANDS ---");
+            Serial.printf("Sent: %lu, delivered: %lu, partial: %lu, failed: %lu, overflow: %lu\n",
+                         reliable.commands_sent, reliable.delivered, reliable.partial, reliable.failed,
+                         reliable.pending_overflows);
+            Serial.printf("Retransmissions: %lu (%.2f per command)\n", reliable.retransmissions,
+                         reliable.commands_sent > 0 ? (float)reliable.retransmissions / reliable.commands_sent : 0.0f);
+            if (reliable.delivered > 0) {
+                Serial.printf("Delivery latency: avg %lu ms, max %lu ms\n",
+                             reliable.latency_total_ms / reliable.delivered, reliable.latency_max_ms);
+            }
+            Serial.printf("ACKs sent: %lu (%lu dropped), received: %lu, duplicates suppressed: %lu\n",
+                         reliable.acks_sent, reliable.acks_dropped, reliable.acks_received,
+                         reliable.duplicates_suppressed);
+        }
+        
+        // Bulk transfers
+        if (bulk.blobs_sent > 0 || bulk.fragments_received > 0) {
+            Serial.println("\n--- BULK DATA ---");
+            Serial.printf("TX: %lu blobs, %lu fragments, %lu bytes, %lu failures\n",
+                         bulk.blobs_sent, bulk.fragments_sent, bulk.bytes_sent, bulk.send_failures);
+            Serial.printf("RX: %lu blobs, %lu fragments, %lu bytes, %.1f KB/s during reassembly\n",
+                         bulk.blobs_received, bulk.fragments_received, bulk.bytes_received,
+                         bulk.reassembly_ms > 0 ? (float)bulk.bytes_received / bulk.reassembly_ms : 0.0f);
+            Serial.printf("Duplicates: %lu, timeouts: %lu, slot overflows: %lu, rejected: %lu\n",
+                         bulk.duplicate_fragments, bulk.timeouts, bulk.slot_overflows, bulk.rejected);
+            if (bulk.benchmark_kbps > 0.0f) {
+                Serial.printf("Last benchmark: %.1f KB/s\n", bulk.benchmark_kbps);
+            }
+        }
+        
+        // Streams
+        if (stream.streams_opened > 0 || stream.rx_streams > 0) {
+            Serial.println("\n--- STREAMS ---");
+            Serial.printf("TX: %lu opened, %lu closed, %lu failed, %lu bytes acked\n",
+                         stream.streams_opened, stream.streams_closed, stream.streams_failed, stream.bytes_acked);
+            Serial.printf("Goodput: %.1f KB/s average, %.1f KB/s last stream\n",
+                         stream.active_ms > 0 ? (float)stream.bytes_acked / stream.active_ms : 0.0f,
+                         stream.last_goodput_kbps);
+            Serial.printf("Segments: %lu sent, %lu retransmitted (%.1f%%), %lu fast, %lu timeouts\n",
+                         stream.segments_sent, stream.retransmissions,
+                         stream.segments_sent > 0 ? stream.retransmissions * 100.0f / stream.segments_sent : 0.0f,
+                         stream.fast_retransmits, stream.timeouts);
+            Serial.printf("RX: %lu streams, %lu segments, %lu bytes, %lu duplicates, %lu out of window\n",
+                         stream.rx_streams, stream.rx_segments, stream.rx_bytes,
+                         stream.rx_duplicates, stream.rx_out_of_window);
+            if (stream.host_overflows > 0) {
+                Serial.printf("Host overflows: %lu\n", stream.host_overflows);
+            }
+        }
+        
+        // Forward error correction
+        if (fec.parity_sent > 0 || fec.parity_received > 0) {
+            Serial.println("\n--- FEC ---");
+            Serial.printf("TX: %lu frames protected by %lu parity frames\n",
+                         fec.protected_frames, fec.parity_sent);
+            Serial.printf("RX: %lu parity frames, %lu frames recovered, %lu groups unrecoverable\n",
+                         fec.parity_received, fec.recovered, fec.unrecoverable);
+        }
+        
+        // Unicast
+        if (unicast.frames_sent > 0 || unicast.probes_echoed > 0) {
+            Serial.println("\n--- UNICAST ---");
+            Serial.printf("Frames: %lu sent, %lu link-acked, %lu failed (%.1f%% acked)\n",
+                         unicast.frames_sent, unicast.link_acked, unicast.link_failed,
+                         unicast.link_acked + unicast.link_failed > 0 ?
+                             unicast.link_acked * 100.0f / (unicast.link_acked + unicast.link_failed) : 0.0f);
+            Serial.printf("Peers added: %lu, evicted: %lu, broadcast fallbacks: %lu, retransmissions: %lu\n",
+                         unicast.peers_added, unicast.peers_evicted, unicast.broadcast_fallbacks,
+                         unicast.unicast_retransmissions);
+            if (unicast.bench_probes > 0) {
+                Serial.printf("Last benchmark: broadcast %lu/%lu (%.1f ms RTT), unicast %lu/%lu (%.1f ms RTT)\n",
+                             unicast.bench_delivered[0], unicast.bench_probes, unicast.bench_rtt_ms[0],
+                             unicast.bench_delivered[1], unicast.bench_probes, unicast.bench_rtt_ms[1]);
+            }
+            if (unicast.probes_echoed > 0) {
+                Serial.printf("Probes echoed: %lu\n", unicast.probes_echoed);
+            }
+            if (unicast.pings_sent > 0) {
+                Serial.printf("Latency pings: %lu sent, %lu answered, %lu lost\n",
+                             unicast.pings_sent, unicast.pings_answered, unicast.pings_lost);
+            }
+        }
+        
+        // Mesh relay
+        if (relay.scheduled > 0 || relay.relayed_received > 0) {
+            Serial.println("\n--- MESH RELAY ---");
+            Serial.printf("Rebroadcasts: %lu of %lu queued, %lu suppressed (%.1f%%), %lu overflows\n",
+                         relay.rebroadcasts, relay.scheduled, relay.suppressed,
+                         relay.scheduled > 0 ? relay.suppressed * 100.0f / relay.scheduled : 0.0f,
+                         relay.queue_overflows);
+            Serial.printf("RX: %lu via relays, %lu duplicates dropped, %lu own frames heard back\n",
+                         relay.relayed_received, relay.duplicates, relay.own_echoes);
+        }
+        
+        // Slotted telemetry
+        if (tdma.sent > 0 || tdma.superseded > 0) {
+            Serial.println("\n--- TDMA ---");
+            Serial.printf("Telemetry: %lu sent in slot (%lu unsynchronized), %lu superseded\n",
+                         tdma.sent, tdma.unsynced, tdma.superseded);
+        }
+        
+        // Randomized telemetry start
+        if (jitter.delayed > 0) {
+            Serial.println("\n--- TX JITTER ---");
+            Serial.printf("Telemetry: %lu delayed, avg %.1f ms, %lu after backoff, %lu superseded\n",
+                         jitter.delayed, (float)jitter.total_delay_ms / jitter.delayed, jitter.backed_off,
+                         jitter.superseded);
+        }
+        
+        // Background control-plane work
+        if (control.posted > 0 || control.dropped > 0) {
+            Serial.println("\n--- CONTROL WORKER ---");
+            Serial.printf("%lu posted, %lu dropped, %lu done, %lu failed\n", control.posted, control.dropped,
+                         control.completed, control.failed);
+            Serial.printf("Longest item: %lu ms, %lu over budget\n", control.max_ms, control.overruns);
+        }
+        
+        // Host filter
+        if (filter.evaluated > 0) {
+            Serial.println("\n--- HOST FILTER ---");
+            Serial.printf("%lu frames, %lu dropped, %.0f cycles per frame\n", filter.evaluated, filter.dropped,
+                         (double)filter.cycles / filter.evaluated);
+        }
+        
+        // Traffic of other networks
+        if (networks.foreign_forwarded > 0 || networks.unsubscribed_dropped > 0) {
+            Serial.println("\n--- NETWORKS ---");
+            Serial.printf("Other networks: %lu forwarded, %lu dropped\n",
+                         networks.foreign_forwarded, networks.unsubscribed_dropped);
+        }
+        
+        // Channel migrations
+        if (channel.switches > 0 || channel.announced > 0) {
+            Serial.println("\n--- CHANNEL SWITCH ---");
+            Serial.printf("%lu switches (%lu without swarm clock), %lu announcements\n",
+                         channel.switches, channel.unsynced, channel.announced);
+            Serial.printf("Last: %ld us late, first frame after %lu us\n", channel.late_us, channel.first_frame_us);
+        }
+        
+        // Statistics pulled over the air
+        if (remote.requests_sent > 0 || remote.replies_sent > 0 || remote.rate_limited > 0) {
+            Serial.println("\n--- REMOTE STATS ---");
+            Serial.printf("Requests sent: %lu, replies received: %lu\n", remote.requests_sent, remote.replies_received);
+            Serial.printf("Replies sent: %lu, rate limited: %lu, unreachable: %lu\n",
+                         remote.replies_sent, remote.rate_limited, remote.unreachable);
+        }
+        
+        // Adaptive TX power
+        if (power.raised > 0 || power.lowered > 0) {
+            Serial.println("\n--- TX POWER ---");
+            Serial.printf("%d dBm, %lu raises, %lu reductions; weakest of %u peers %d dBm\n",
+                         power.dbm, power.raised, power.lowered, power.peers, power.min_rssi);
+        }
+        
+        // Rate limits
+        unsigned long policed = policing.relay_dropped;
+        for (int i = 0; i < PACKET_TYPE_COUNT; i++) {
+            policed += policing.dropped[i];
+        }
+        if (policed > 0) {
+            Serial.println("\n--- POLICING ---");
+            for (int i = 0; i < PACKET_TYPE_COUNT; i++) {
+                if (policing.dropped[i] > 0) {
+                    Serial.printf("Type %d: %lu dropped\n", i, policing.dropped[i]);
+                }
+            }
+            if (policing.relay_dropped > 0) {
+                Serial.printf("Relay: %lu rebroadcasts dropped\n", policing.relay_dropped);
+            }
+        }
+        
+        // Swarm time
+        if (time.is_master || time.beacons_received > 0) {
+            Serial.println("\n--- TIME SYNC ---");
+            if (time.is_master) {
+                Serial.printf("Master: %lu beacons, %lu responses\n", time.beacons_sent, time.responses_sent);
+            } else {
+                Serial.printf("Following drone_%u: %s, offset %ld us, drift %ld ppb, error %lu us\n",
+                             time.master_id, time.synced ? "synced" : "not synced",
+                             time.offset_us, time.drift_ppb, time.error_us);
+                Serial.printf("Exchanges: %lu requests, %lu samples, %lu rejected, %lu master changes\n",
+                             time.requests_sent, time.samples, time.samples_rejected, time.master_changes);
+            }
+        }
+        
         Serial.println("================================");
         
         // Reset accumulated data for next period
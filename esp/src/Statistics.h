@@ -2,6 +2,7 @@
 #define STATISTICS_H
 
 #include <Arduino.h>
+#include "Packet.h"
 
 struct InterfaceStats {
     unsigned long packets_sent = 0;
@@ -27,12 +28,209 @@ struct InterfaceStats {
         unsigned long packets_received = 0;
         unsigned long bytes_sent = 0;
         unsigned long bytes_received = 0;
-    } by_type[9];
+    } by_type[PACKET_TYPE_COUNT];
+};
+
+struct SwarmStats {
+    unsigned long telemetry_absorbed = 0;  // Telemetry frames kept on the bridge instead of forwarded
+    unsigned long snapshots_sent = 0;
+    unsigned long snapshot_packets = 0;
+    unsigned long entries_expired = 0;
+    unsigned long entries_evicted = 0;
+    unsigned long interest_forwarded = 0;  // Telemetry frames of neighbours of interest
+    unsigned long interest_filtered = 0;   // Telemetry frames dropped as out of interest
+    unsigned long cpa_checks = 0;
+    unsigned long conflicts_detected = 0;
+    unsigned long alerts_sent = 0;
+    unsigned long position_queries = 0;    // Extrapolated snapshots sent on request
+    unsigned long neighbor_events = 0;     // NEIGHBOR join/leave pushed to the host
+    unsigned long neighbor_events_dropped = 0;
+};
+
+struct ReliabilityStats {
+    unsigned long commands_sent = 0;       // Reliable COMMANDs originated here
+    unsigned long delivered = 0;
+    unsigned long partial = 0;
+    unsigned long failed = 0;
+    unsigned long retransmissions = 0;
+    unsigned long pending_overflows = 0;   // Sent best-effort because too many were in flight
+    unsigned long acks_sent = 0;
+    unsigned long acks_dropped = 0;        // Owed while the ACK queue was full
+    unsigned long acks_received = 0;
+    unsigned long duplicates_suppressed = 0;
+    unsigned long latency_total_ms = 0;    // Over delivered commands
+    unsigned long latency_max_ms = 0;
+};
+
+struct BulkStats {
+    unsigned long blobs_sent = 0;
+    unsigned long fragments_sent = 0;
+    unsigned long bytes_sent = 0;
+    unsigned long send_failures = 0;
+    unsigned long blobs_received = 0;      // Reassembled and handed to the host
+    unsigned long fragments_received = 0;
+    unsigned long bytes_received = 0;
+    unsigned long reassembly_ms = 0;       // First to last fragment, summed over blobs
+    unsigned long duplicate_fragments = 0;
+    unsigned long timeouts = 0;            // Incomplete blobs dropped
+    unsigned long slot_overflows = 0;      // Fragments dropped with every slot busy
+    unsigned long rejected = 0;            // Malformed chunks
+    float benchmark_kbps = 0.0f;           // Last benchmark run on this bridge
+};
+
+struct StreamStats {
+    unsigned long streams_opened = 0;
+    unsigned long streams_closed = 0;      // Every byte acknowledged
+    unsigned long streams_failed = 0;
+    unsigned long segments_sent = 0;       // Including retransmissions
+    unsigned long retransmissions = 0;
+    unsigned long fast_retransmits = 0;    // Resent on SACK evidence, before the timer
+    unsigned long timeouts = 0;
+    unsigned long bytes_acked = 0;
+    unsigned long active_ms = 0;           // Open to finished, summed over outgoing streams
+    unsigned long host_overflows = 0;      // Host bytes dropped beyond the announced credit
+    unsigned long rx_streams = 0;
+    unsigned long rx_segments = 0;
+    unsigned long rx_duplicates = 0;
+    unsigned long rx_out_of_window = 0;
+    unsigned long rx_bytes = 0;
+    float last_goodput_kbps = 0.0f;        // Last finished outgoing stream
+};
+
+struct FecStats {
+    unsigned long protected_frames = 0;    // Outgoing frames covered by a parity frame
+    unsigned long parity_sent = 0;
+    unsigned long parity_received = 0;
+    unsigned long recovered = 0;           // Frames rebuilt from parity
+    unsigned long unrecoverable = 0;       // Groups missing more than one frame
+};
+
+struct UnicastStats {
+    unsigned long frames_sent = 0;
+    unsigned long link_acked = 0;          // 802.11 ACK from the receiving radio
+    unsigned long link_failed = 0;         // No ACK after the radio's own retries
+    unsigned long broadcast_fallbacks = 0; // Targeted commands or replies broadcast, the MAC was unknown or unregistered
+    unsigned long unicast_retransmissions = 0;  // Reliable retransmissions to missing ackers only
+    unsigned long peers_added = 0;
+    unsigned long peers_evicted = 0;
+    unsigned long probes_echoed = 0;
+    unsigned long pings_sent = 0;          // Latency monitor
+    unsigned long pings_answered = 0;
+    unsigned long pings_lost = 0;
+    // Last link benchmark run on this bridge, index 0 = broadcast, 1 = unicast
+    unsigned long bench_probes = 0;        // Per mode
+    unsigned long bench_delivered[2] = {0, 0};
+    float bench_rtt_ms[2] = {0.0f, 0.0f};  // Average over delivered probes
+};
+
+struct RelayStats {
+    unsigned long relayed_received = 0;    // Frames that reached us through a relay
+    unsigned long scheduled = 0;           // New frames queued for rebroadcast
+    unsigned long rebroadcasts = 0;
+    unsigned long suppressed = 0;          // Cancelled after overhearing enough copies
+    unsigned long duplicates = 0;          // Copies of frames already seen, dropped
+    unsigned long own_echoes = 0;          // Our own frames heard back from a relay
+    unsigned long queue_overflows = 0;
+};
+
+struct TdmaStats {
+    unsigned long sent = 0;                // Telemetry frames sent in our slot
+    unsigned long superseded = 0;          // Replaced by newer telemetry before the slot came
+    unsigned long unsynced = 0;            // Sent without a swarm clock, slots not aligned
+};
+
+struct JitterStats {
+    unsigned long delayed = 0;             // Telemetry frames given a random delay
+    unsigned long total_delay_ms = 0;
+    unsigned long backed_off = 0;          // Drawn from a widened window, the channel was busy
+    unsigned long superseded = 0;          // Replaced by newer telemetry while waiting
+};
+
+struct ControlStats {
+    unsigned long posted = 0;
+    unsigned long dropped = 0;     // Queue full
+    unsigned long completed = 0;
+    unsigned long failed = 0;
+    unsigned long overruns = 0;    // Items over CONTROL_ITEM_BUDGET_MS
+    unsigned long max_ms = 0;
+};
+
+struct FilterStats {
+    unsigned long evaluated = 0;   // Frames the host filter looked at
+    unsigned long dropped = 0;
+    unsigned long long cycles = 0;  // CPU cycles spent on them
+};
+
+struct NetworkStats {
+    unsigned long foreign_forwarded = 0;     // Frames of subscribed other networks
+    unsigned long unsubscribed_dropped = 0;
+};
+
+struct RemoteStatsStats {
+    unsigned long requests_sent = 0;     // Asked on the air for the host
+    unsigned long replies_sent = 0;
+    unsigned long replies_received = 0;  // From other bridges, passed to the host
+    unsigned long rate_limited = 0;      // Requests within STATS_REPLY_MIN_INTERVAL_MS of a reply
+    unsigned long unreachable = 0;       // Relayed requests from a station without a known MAC
+};
+
+struct ChannelSwitchStats {
+    unsigned long announced = 0;     // Announcements sent, ours and passed on
+    unsigned long switches = 0;
+    unsigned long unsynced = 0;      // Switched on the countdown, without the swarm clock
+    long late_us = 0;                // Last switch behind its scheduled time
+    unsigned long first_frame_us = 0;  // Last switch to first frame on the new channel, 0 = none
+};
+
+struct TxPowerStats {
+    int8_t dbm = 0;              // Current TX power
+    unsigned long raised = 0;
+    unsigned long lowered = 0;
+    uint8_t peers = 0;           // Heard directly in the last period
+    int8_t min_rssi = 0;         // Weakest of them, dBm
+};
+
+struct PolicingStats {
+    unsigned long dropped[PACKET_TYPE_COUNT] = {0};  // Host packets over their type's rate
+    unsigned long relay_dropped = 0;                 // Rebroadcasts over the originator's rate
+};
+
+struct TimeSyncStats {
+    bool is_master = false;
+    bool synced = false;
+    uint8_t master_id = 0;
+    long offset_us = 0;                    // Master minus local, from the best exchange
+    long drift_ppb = 0;
+    unsigned long error_us = 0;
+    unsigned long master_changes = 0;
+    unsigned long beacons_sent = 0;
+    unsigned long beacons_received = 0;
+    unsigned long requests_sent = 0;
+    unsigned long responses_sent = 0;
+    unsigned long samples = 0;
+    unsigned long samples_rejected = 0;    // Round trip too long or negative
 };
 
 struct Statistics {
     InterfaceStats uart;
     InterfaceStats espnow;
+    NetworkStats networks;
+    FilterStats filter;
+    ControlStats control;
+    SwarmStats swarm;
+    ReliabilityStats reliable;
+    BulkStats bulk;
+    StreamStats stream;
+    FecStats fec;
+    UnicastStats unicast;
+    RelayStats relay;
+    TimeSyncStats time;
+    TdmaStats tdma;
+    JitterStats jitter;
+    PolicingStats policing;
+    TxPowerStats power;
+    ChannelSwitchStats channel;
+    RemoteStatsStats remote;
     unsigned long start_time = 0;
     unsigned long last_stats_time = 0;
     unsigned long last_pps_update = 0;
@@ -0,0 +1,607 @@
+#include "StreamManager.h"
+#include "ESPNowManager.h"
+#include "PeerTable.h"
+#include "HostLink.h"
+#include "Statistics.h"
+#include "crc_utils.h"
+
+extern Statistics stats;
+extern ESPNowManager espNowManager;
+extern PeerTable peerTable;
+
+// Sequence comparison that survives 16-bit wrap-around
+static inline bool seqBefore(uint16_t a, uint16_t b) {
+    return (int16_t)(a - b) < 0;
+}
+
+static size_t segmentLength(size_t packet_len) {
+    size_t overhead = offsetof(StreamDataPacket, data) + sizeof(uint16_t);
+    return packet_len > overhead ? packet_len - overhead : 0;
+}
+
+void StreamManager::handleHostControl(const StreamControlPacket& packet, uint32_t now_ms) {
+    switch (packet.op) {
+        case STREAM_OP_OPEN: {
+            if (tx.state == STREAM_OPEN || tx.state == STREAM_CLOSING) {
+                Serial.printf("ERROR: Stream %d still active, cannot open stream %d\n",
+                             tx.stream_id, packet.stream_id);
+                sendControl(STREAM_OP_STATUS, packet.stream_id, packet.peer_id, STREAM_FAILED, 0, 0);
+                break;
+            }
+            openTx(packet.stream_id, packet.peer_id, now_ms);
+            if (!peerTable.lookup(packet.peer_id, tx.mac)) {
+                Serial.printf("ERROR: Stream %d: drone %d never heard, MAC unknown\n",
+                             packet.stream_id, packet.peer_id);
+                finishTx(STREAM_FAILED, now_ms);
+                break;
+            }
+            sendStatus(now_ms);
+            break;
+        }
+        case STREAM_OP_CLOSE: {
+            if (tx.state == STREAM_OPEN && packet.stream_id == tx.stream_id) {
+                tx.state = STREAM_CLOSING;
+                sendStatus(now_ms);
+            }
+            break;
+        }
+        default:
+            Serial.printf("ERROR: Unknown stream operation %d\n", packet.op);
+            break;
+    }
+}
+
+void StreamManager::handleHostData(const StreamDataPacket& packet, size_t len, uint32_t now_ms) {
+    size_t n = segmentLength(len);
+    if (tx.state != STREAM_OPEN || packet.stream.stream_id != tx.stream_id) {
+        stats.stream.host_overflows += n;
+        return;
+    }
+
+    // Host bytes are coalesced into full segments
+    const uint8_t* p = packet.data;
+    while (n > 0) {
+        TxSegment* seg = openSegment();
+        if (!seg) {
+            seg = appendSegment(0);
+        }
+        if (!seg) {
+            // Host wrote past its credit
+            stats.stream.host_overflows += n;
+            break;
+        }
+        size_t take = min(n, (size_t)(STREAM_SEGMENT_SIZE - seg->len));
+        memcpy(seg->data + seg->len, p, take);
+        seg->len += take;
+        seg->sealed = seg->len == STREAM_SEGMENT_SIZE;
+        tx.bytes_written += take;
+        p += take;
+        n -= take;
+    }
+    tx.last_write_ms = now_ms;
+}
+
+void StreamManager::handleAck(uint8_t src_id, const StreamAckPacket& packet) {
+    if (src_id != tx.peer_id) {
+        return;
+    }
+    portENTER_CRITICAL(&ack_lock);
+    if (ack_count == STREAM_ACK_QUEUE) {
+        // Newer acknowledgements carry everything the oldest one did
+        ack_head = (ack_head + 1) % STREAM_ACK_QUEUE;
+        ack_count--;
+    }
+    ack_queue[(ack_head + ack_count) % STREAM_ACK_QUEUE] = packet;
+    ack_count++;
+    portEXIT_CRITICAL(&ack_lock);
+}
+
+void StreamManager::update(uint32_t now_ms) {
+    while (true) {
+        StreamAckPacket ack;
+        bool have_ack = false;
+        portENTER_CRITICAL(&ack_lock);
+        if (ack_count > 0) {
+            ack = ack_queue[ack_head];
+            ack_head = (ack_head + 1) % STREAM_ACK_QUEUE;
+            ack_count--;
+            have_ack = true;
+        }
+        portEXIT_CRITICAL(&ack_lock);
+        if (!have_ack) break;
+        processAck(ack, now_ms);
+    }
+
+    updateTx(now_ms);
+    updateRx(now_ms);
+}
+
+void StreamManager::openTx(uint8_t stream_id, uint8_t peer_id, uint32_t now_ms) {
+    tx.state = STREAM_OPEN;
+    tx.stream_id = stream_id;
+    tx.peer_id = peer_id;
+    tx.una = 0;
+    tx.next = 0;
+    tx.end = 0;
+    tx.peer_window_end = STREAM_WINDOW;
+    tx.fin_queued = false;
+    tx.in_recovery = false;
+    tx.cwnd = STREAM_INITIAL_CWND;
+    tx.ssthresh = STREAM_WINDOW;
+    tx.srtt_ms = 0;
+    tx.rttvar_ms = 0;
+    tx.rto_ms = STREAM_INITIAL_RTO_MS;
+    tx.opened_ms = now_ms;
+    tx.last_progress_ms = now_ms;
+    tx.last_write_ms = now_ms;
+    tx.bytes_written = 0;
+    tx.bytes_acked = 0;
+    stats.stream.streams_opened++;
+}
+
+TxSegment* StreamManager::openSegment() {
+    if (tx.una == tx.end) {
+        return nullptr;
+    }
+    TxSegment& seg = tx.segments[(uint16_t)(tx.end - 1) % STREAM_WINDOW];
+    return seg.sealed ? nullptr : &seg;
+}
+
+TxSegment* StreamManager::appendSegment(uint8_t flags) {
+    if ((uint16_t)(tx.end - tx.una) >= STREAM_WINDOW) {
+        return nullptr;
+    }
+    TxSegment& seg = tx.segments[tx.end % STREAM_WINDOW];
+    seg.sealed = false;
+    seg.sacked = false;
+    seg.lost = false;
+    seg.flags = flags | (tx.end == 0 ? STREAM_FLAG_SYN : 0);
+    seg.len = 0;
+    seg.transmissions = 0;
+    tx.end++;
+    return &seg;
+}
+
+void StreamManager::processAck(const StreamAckPacket& ack, uint32_t now_ms) {
+    if ((tx.state != STREAM_OPEN && tx.state != STREAM_CLOSING) || ack.stream_id != tx.stream_id) {
+        return;
+    }
+    uint16_t cum = ack.cum_seq;
+    // Stale (reordered) or acknowledging segments never sent
+    if (seqBefore(cum, tx.una) || seqBefore(tx.next, cum)) {
+        return;
+    }
+    tx.peer_window_end = ack.window_end;
+
+    bool have_sample = false;
+    uint32_t sample_ms = 0;
+    while (seqBefore(tx.una, cum)) {
+        TxSegment& seg = tx.segments[tx.una % STREAM_WINDOW];
+        // Karn: retransmitted segments give ambiguous round trips, and a
+        // segment SACKed earlier was timed when it was SACKed
+        if (seg.transmissions == 1 && !seg.sacked) {
+            have_sample = true;
+            sample_ms = now_ms - seg.sent_ms;
+        }
+        tx.bytes_acked += seg.len;
+        stats.stream.bytes_acked += seg.len;
+        tx.una++;
+        tx.last_progress_ms = now_ms;
+
+        if (tx.in_recovery && !seqBefore(tx.una, tx.recovery_seq)) {
+            tx.in_recovery = false;
+        } else if (!tx.in_recovery) {
+            // Slow start up to ssthresh, then one segment per window
+            tx.cwnd += tx.cwnd < tx.ssthresh ? 1.0f : 1.0f / tx.cwnd;
+            if (tx.cwnd > STREAM_WINDOW) tx.cwnd = STREAM_WINDOW;
+        }
+    }
+
+    // Bit n of the SACK mask covers cum + 1 + n
+    bool any_sacked = false;
+    uint16_t highest = cum;
+    for (uint8_t i = 0; i < 32; i++) {
+        uint16_t seq = cum + 1 + i;
+        if (!seqBefore(seq, tx.next)) break;
+        if (ack.sack_mask & (1UL << i)) {
+            TxSegment& seg = tx.segments[seq % STREAM_WINDOW];
+            if (!seg.sacked && seg.transmissions == 1) {
+                have_sample = true;
+                sample_ms = now_ms - seg.sent_ms;
+            }
+            seg.sacked = true;
+            highest = seq;
+            any_sacked = true;
+        }
+    }
+    if (have_sample) {
+        updateRtt(sample_ms);
+    }
+    if (!any_sacked) {
+        return;
+    }
+
+    // A hole with enough later segments SACKed is lost: queue it for resend
+    // without waiting for the timer, at most once per round trip
+    uint32_t guard_ms = max(tx.srtt_ms, (uint32_t)STREAM_MIN_RTO_MS);
+    uint8_t later = 0;
+    for (uint16_t seq = highest; ; seq--) {
+        TxSegment& seg = tx.segments[seq % STREAM_WINDOW];
+        if (seg.sacked) {
+            later++;
+        } else if (later >= STREAM_SACK_THRESHOLD && !seg.lost && now_ms - seg.sent_ms >= guard_ms) {
+            if (!tx.in_recovery) {
+                enterRecovery(false);
+            }
+            seg.lost = true;
+            stats.stream.fast_retransmits++;
+        }
+        if (seq == cum) break;
+    }
+}
+
+void StreamManager::updateRtt(uint32_t sample_ms) {
+    // RFC 6298 smoothing, in milliseconds
+    if (tx.srtt_ms == 0) {
+        tx.srtt_ms = sample_ms;
+        tx.rttvar_ms = sample_ms / 2;
+    } else {
+        uint32_t err = sample_ms > tx.srtt_ms ? sample_ms - tx.srtt_ms : tx.srtt_ms - sample_ms;
+        tx.rttvar_ms = (3 * tx.rttvar_ms + err) / 4;
+        tx.srtt_ms = (7 * tx.srtt_ms + sample_ms) / 8;
+    }
+    tx.rto_ms = constrain(tx.srtt_ms + 4 * tx.rttvar_ms, (uint32_t)STREAM_MIN_RTO_MS, (uint32_t)STREAM_MAX_RTO_MS);
+}
+
+void StreamManager::enterRecovery(bool timeout) {
+    // Multiplicative decrease; a timeout restarts from the minimum window
+    tx.ssthresh = max(tx.cwnd / 2.0f, STREAM_MIN_CWND);
+    tx.cwnd = timeout ? STREAM_MIN_CWND : tx.ssthresh;
+    tx.in_recovery = true;
+    tx.recovery_seq = tx.next;
+}
+
+void StreamManager::transmitSegment(uint16_t seq, uint32_t now_ms) {
+    TxSegment& seg = tx.segments[seq % STREAM_WINDOW];
+
+    StreamDataPacket packet;
+    size_t packet_len = offsetof(StreamDataPacket, data) + seg.len + sizeof(uint16_t);
+    initPacketHeader(packet.header, STREAM_DATA, packet_len, espNowManager.getConfig().network_id);
+    packet.stream.stream_id = tx.stream_id;
+    packet.stream.flags = seg.flags;
+    packet.stream.seq = seq;
+    memcpy(packet.data, seg.data, seg.len);
+    sealPacket((uint8_t*)&packet, packet_len);
+
+    // A failed send is recovered by the retransmission timer like a lost frame
+    espNowManager.sendUnicast(tx.mac, (uint8_t*)&packet, packet_len);
+
+    if (seg.transmissions > 0) {
+        stats.stream.retransmissions++;
+    }
+    if (seg.transmissions < 0xFF) {
+        seg.transmissions++;
+    }
+    seg.sent_ms = now_ms;
+    stats.stream.segments_sent++;
+}
+
+void StreamManager::updateTx(uint32_t now_ms) {
+    if (tx.state != STREAM_OPEN && tx.state != STREAM_CLOSING) {
+        return;
+    }
+
+    // A partial segment goes out once the host pauses or closes
+    TxSegment* open = openSegment();
+    if (open && (tx.state == STREAM_CLOSING || now_ms - tx.last_write_ms >= STREAM_FLUSH_MS)) {
+        open->sealed = true;
+    }
+    if (tx.state == STREAM_CLOSING && !tx.fin_queued) {
+        TxSegment* fin = appendSegment(STREAM_FLAG_FIN);
+        if (fin) {
+            fin->sealed = true;
+            tx.fin_queued = true;
+        }
+    }
+
+    // Retransmission timer: every segment not SACKed is presumed lost
+    for (uint16_t seq = tx.una; seqBefore(seq, tx.next); seq++) {
+        TxSegment& seg = tx.segments[seq % STREAM_WINDOW];
+        if (seg.sacked || seg.lost || now_ms - seg.sent_ms < tx.rto_ms) continue;
+        stats.stream.timeouts++;
+        enterRecovery(true);
+        tx.rto_ms = min(tx.rto_ms * 2, (uint32_t)STREAM_MAX_RTO_MS);
+        for (uint16_t s = tx.una; seqBefore(s, tx.next); s++) {
+            TxSegment& other = tx.segments[s % STREAM_WINDOW];
+            other.lost = !other.sacked;
+        }
+        break;
+    }
+
+    // Segments still in the air: neither SACKed nor waiting for a resend
+    uint16_t pipe = 0;
+    for (uint16_t seq = tx.una; seqBefore(seq, tx.next); seq++) {
+        const TxSegment& seg = tx.segments[seq % STREAM_WINDOW];
+        if (!seg.sacked && !seg.lost) pipe++;
+    }
+
+    // Resends first, then new segments, within the congestion window
+    uint16_t lost_seq = tx.una;
+    while (pipe < (uint16_t)tx.cwnd) {
+        while (seqBefore(lost_seq, tx.next) && !tx.segments[lost_seq % STREAM_WINDOW].lost) {
+            lost_seq++;
+        }
+        if (seqBefore(lost_seq, tx.next)) {
+            tx.segments[lost_seq % STREAM_WINDOW].lost = false;
+            transmitSegment(lost_seq, now_ms);
+            pipe++;
+            continue;
+        }
+        if (tx.next == tx.end || !tx.segments[tx.next % STREAM_WINDOW].sealed ||
+            !seqBefore(tx.next, tx.peer_window_end)) {
+            break;
+        }
+        transmitSegment(tx.next, now_ms);
+        tx.next++;
+        pipe++;
+    }
+
+    // With nothing in flight one segment probes a receive window that looks closed
+    if (tx.una == tx.next && tx.next != tx.end && tx.segments[tx.next % STREAM_WINDOW].sealed &&
+        now_ms - tx.last_progress_ms >= tx.rto_ms) {
+        transmitSegment(tx.next, now_ms);
+        tx.next++;
+    }
+
+    if (tx.fin_queued && tx.una == tx.end) {
+        finishTx(STREAM_CLOSED, now_ms);
+        return;
+    }
+    if (tx.una != tx.next && now_ms - tx.last_progress_ms > STREAM_IDLE_TIMEOUT_MS) {
+        Serial.printf("ERROR: Stream %d to drone %d: no progress for %d ms\n",
+                     tx.stream_id, tx.peer_id, STREAM_IDLE_TIMEOUT_MS);
+        finishTx(STREAM_FAILED, now_ms);
+        return;
+    }
+
+    // The host needs both numbers to know its room, report when either moved
+    if ((credit() != tx.last_credit || tx.bytes_written != tx.last_written || tx.state != tx.last_state) &&
+        now_ms - tx.last_status_ms >= STREAM_STATUS_INTERVAL_MS) {
+        sendStatus(now_ms);
+    }
+}
+
+void StreamManager::finishTx(uint8_t state, uint32_t now_ms) {
+    tx.state = state;
+    uint32_t elapsed = now_ms - tx.opened_ms;
+    if (state == STREAM_CLOSED) {
+        stats.stream.streams_closed++;
+    } else {
+        stats.stream.streams_failed++;
+    }
+    stats.stream.active_ms += elapsed;
+    stats.stream.last_goodput_kbps = elapsed > 0 ? tx.bytes_acked / (float)elapsed : 0.0f;  // bytes/ms == KB/s
+    Serial.printf("Stream %d to drone %d %s: %lu bytes in %lu ms\n", tx.stream_id, tx.peer_id,
+                 state == STREAM_CLOSED ? "closed" : "failed",
+                 (unsigned long)tx.bytes_acked, (unsigned long)elapsed);
+    sendStatus(now_ms);
+}
+
+uint16_t StreamManager::credit() {
+    if (tx.state != STREAM_OPEN) {
+        return 0;
+    }
+    uint16_t free_segments = STREAM_WINDOW - (uint16_t)(tx.end - tx.una);
+    TxSegment* open = openSegment();
+    return free_segments * STREAM_SEGMENT_SIZE + (open ? STREAM_SEGMENT_SIZE - open->len : 0);
+}
+
+void StreamManager::sendStatus(uint32_t now_ms) {
+    tx.last_credit = credit();
+    tx.last_written = tx.bytes_written;
+    tx.last_state = tx.state;
+    tx.last_status_ms = now_ms;
+    sendControl(STREAM_OP_STATUS, tx.stream_id, tx.peer_id, tx.state, tx.last_credit, tx.bytes_written);
+}
+
+void StreamManager::handleSegment(const uint8_t* mac, uint8_t src_id, const StreamDataPacket& packet, size_t len) {
+    size_t n = segmentLength(len);
+    if (n > STREAM_SEGMENT_SIZE) {
+        stats.stream.rx_out_of_window++;
+        return;
+    }
+    const StreamHeader& segment = packet.stream;
+    uint32_t now = millis();
+    bool fresh = false;
+    bool duplicate = false;
+    bool out_of_window = false;
+
+    portENTER_CRITICAL(&rx_lock);
+    if (rx.state == STREAM_IDLE || rx.peer_id != src_id || rx.stream_id != segment.stream_id) {
+        // Only a SYN starts a stream, and only once the previous one is over
+        if (!(segment.flags & STREAM_FLAG_SYN) || segment.seq != 0 || rx.state == STREAM_OPEN) {
+            portEXIT_CRITICAL(&rx_lock);
+            stats.stream.rx_out_of_window++;
+            return;
+        }
+        rx.state = STREAM_OPEN;
+        rx.stream_id = segment.stream_id;
+        rx.peer_id = src_id;
+        rx.deliver_seq = 0;
+        rx.next_seq = 0;
+        rx.bytes = 0;
+        rx.announce = true;
+        for (uint8_t i = 0; i < STREAM_WINDOW; i++) {
+            rx.segments[i].filled = false;
+        }
+        fresh = true;
+    }
+    memcpy(rx.mac, mac, 6);
+    rx.last_ms = now;
+
+    if (seqBefore(segment.seq, rx.deliver_seq)) {
+        duplicate = true;
+    } else if ((uint16_t)(segment.seq - rx.deliver_seq) >= STREAM_WINDOW || rx.state != STREAM_OPEN) {
+        out_of_window = true;
+    } else {
+        RxSegment& slot = rx.segments[segment.seq % STREAM_WINDOW];
+        if (slot.filled) {
+            duplicate = true;
+        } else {
+            slot.filled = true;
+            slot.flags = segment.flags;
+            slot.len = n;
+            memcpy(slot.data, packet.data, n);
+            while ((uint16_t)(rx.next_seq - rx.deliver_seq) < STREAM_WINDOW &&
+                   rx.segments[rx.next_seq % STREAM_WINDOW].filled) {
+                rx.next_seq++;
+            }
+        }
+    }
+    // Every segment is answered, duplicates included: the earlier ACK may have been lost
+    rx.ack_due = true;
+    portEXIT_CRITICAL(&rx_lock);
+
+    if (fresh) stats.stream.rx_streams++;
+    if (duplicate) {
+        stats.stream.rx_duplicates++;
+    } else if (out_of_window) {
+        stats.stream.rx_out_of_window++;
+    } else {
+        stats.stream.rx_segments++;
+    }
+}
+
+void StreamManager::buildAck(StreamAckPacket& ack) {
+    initPacketHeader(ack.header, STREAM_ACK, sizeof(ack), espNowManager.getConfig().network_id);
+    ack.stream_id = rx.stream_id;
+    ack.reserved = 0;
+    ack.cum_seq = rx.next_seq;
+    ack.sack_mask = 0;
+    for (uint8_t i = 0; i < 32; i++) {
+        uint16_t seq = rx.next_seq + 1 + i;
+        if ((uint16_t)(seq - rx.deliver_seq) >= STREAM_WINDOW) break;
+        if (rx.segments[seq % STREAM_WINDOW].filled) {
+            ack.sack_mask |= 1UL << i;
+        }
+    }
+    ack.window_end = rx.deliver_seq + STREAM_WINDOW;
+    rx.acked_window_end = ack.window_end;
+    sealPacket((uint8_t*)&ack, sizeof(ack));
+}
+
+void StreamManager::updateRx(uint32_t now_ms) {
+    uint8_t stream_id;
+    uint8_t peer_id;
+
+    portENTER_CRITICAL(&rx_lock);
+    bool announce = rx.announce;
+    rx.announce = false;
+    stream_id = rx.stream_id;
+    peer_id = rx.peer_id;
+    portEXIT_CRITICAL(&rx_lock);
+    if (announce) {
+        sendControl(STREAM_OP_INCOMING, stream_id, peer_id, STREAM_OPEN, 0, 0);
+    }
+
+    // In-order segments to the host; each one frees a window slot at once
+    uint8_t network_id = espNowManager.getConfig().network_id;
+    bool delivered = false;
+    while (true) {
+        RxSegment seg;
+        uint16_t seq = 0;
+        uint32_t bytes = 0;
+        bool have = false;
+        portENTER_CRITICAL(&rx_lock);
+        if (rx.state == STREAM_OPEN && rx.deliver_seq != rx.next_seq) {
+            RxSegment& slot = rx.segments[rx.deliver_seq % STREAM_WINDOW];
+            seg = slot;
+            slot.filled = false;
+            seq = rx.deliver_seq++;
+            rx.bytes += seg.len;
+            bytes = rx.bytes;
+            stream_id = rx.stream_id;
+            peer_id = rx.peer_id;
+            if (seg.flags & STREAM_FLAG_FIN) {
+                rx.state = STREAM_CLOSED;
+            }
+            have = true;
+        }
+        portEXIT_CRITICAL(&rx_lock);
+        if (!have) break;
+        delivered = true;
+        stats.stream.rx_bytes += seg.len;
+
+        for (uint16_t offset = 0; offset < seg.len; offset += STREAM_UART_CHUNK_SIZE) {
+            uint16_t n = min((uint16_t)(seg.len - offset), (uint16_t)STREAM_UART_CHUNK_SIZE);
+
+            StreamDataPacket packet;
+            size_t packet_len = offsetof(StreamDataPacket, data) + n + sizeof(uint16_t);
+            initPacketHeader(packet.header, STREAM_DATA, packet_len, network_id);
+            packet.stream.stream_id = stream_id;
+            packet.stream.flags = 0;
+            packet.stream.seq = seq;
+            memcpy(packet.data, seg.data + offset, n);
+            sealPacket((uint8_t*)&packet, packet_len);
+            sendToHost((uint8_t*)&packet, packet_len);
+        }
+
+        if (seg.flags & STREAM_FLAG_FIN) {
+            Serial.printf("Stream %d from drone %d finished: %lu bytes\n",
+                         stream_id, peer_id, (unsigned long)bytes);
+            sendControl(STREAM_OP_FINISHED, stream_id, peer_id, STREAM_CLOSED, 0, bytes);
+        }
+    }
+
+    StreamAckPacket ack;
+    uint8_t mac[6];
+    bool send_ack = false;
+    bool failed = false;
+    uint32_t bytes = 0;
+
+    portENTER_CRITICAL(&rx_lock);
+    // Built after delivery so it carries the window just freed. Without new
+    // segments, an ACK still goes out when the last one left the sender less
+    // than half a window, to reopen it.
+    if (rx.ack_due || (delivered && (uint16_t)(rx.acked_window_end - rx.next_seq) < STREAM_WINDOW / 2)) {
+        rx.ack_due = false;
+        buildAck(ack);
+        memcpy(mac, rx.mac, 6);
+        send_ack = true;
+    }
+    // The callback may stamp last_ms after now_ms was taken
+    int32_t idle_ms = (int32_t)(now_ms - rx.last_ms);
+    if (rx.state == STREAM_OPEN && idle_ms > STREAM_IDLE_TIMEOUT_MS) {
+        rx.state = STREAM_IDLE;
+        stream_id = rx.stream_id;
+        peer_id = rx.peer_id;
+        bytes = rx.bytes;
+        failed = true;
+    } else if (rx.state == STREAM_CLOSED && idle_ms > STREAM_LINGER_MS) {
+        rx.state = STREAM_IDLE;
+    }
+    portEXIT_CRITICAL(&rx_lock);
+
+    if (send_ack) {
+        espNowManager.sendUnicast(mac, (uint8_t*)&ack, sizeof(ack));
+    }
+    if (failed) {
+        Serial.printf("ERROR: Stream %d from drone %d stalled after %lu bytes\n",
+                     stream_id, peer_id, (unsigned long)bytes);
+        sendControl(STREAM_OP_FINISHED, stream_id, peer_id, STREAM_FAILED, 0, bytes);
+    }
+}
+
+void StreamManager::sendControl(uint8_t op, uint8_t stream_id, uint8_t peer_id, uint8_t state,
+                                uint16_t credit, uint32_t bytes) {
+    StreamControlPacket packet;
+    initPacketHeader(packet.header, STREAM_CONTROL, sizeof(packet), espNowManager.getConfig().network_id);
+    packet.op = op;
+    packet.stream_id = stream_id;
+    packet.peer_id = peer_id;
+    packet.state = state;
+    packet.credit = credit;
+    packet.bytes = bytes;
+    sealPacket((uint8_t*)&packet, sizeof(packet));
+    sendToHost((uint8_t*)&packet, sizeof(packet));
+}
@@ -0,0 +1,136 @@
+#ifndef STREAM_MANAGER_H
+#define STREAM_MANAGER_H
+
+#include <Arduino.h>
+#include "Packet.h"
+
+#define STREAM_WINDOW 32               // Segments buffered per direction, also the SACK bitmap width
+#define STREAM_INITIAL_CWND 4.0f
+#define STREAM_MIN_CWND 2.0f
+#define STREAM_INITIAL_RTO_MS 100
+#define STREAM_MIN_RTO_MS 20
+#define STREAM_MAX_RTO_MS 500
+#define STREAM_FLUSH_MS 5              // A partly filled segment goes out after this much host silence
+#define STREAM_IDLE_TIMEOUT_MS 3000    // No acknowledgement progress: the stream fails
+#define STREAM_SACK_THRESHOLD 3        // Later segments SACKed before a hole is resent
+#define STREAM_STATUS_INTERVAL_MS 20
+#define STREAM_LINGER_MS 2000          // A finished incoming stream is kept to re-ACK its FIN
+#define STREAM_ACK_QUEUE 8
+
+struct TxSegment {
+    bool sealed;           // Complete, may be sent
+    bool sacked;
+    bool lost;             // Waiting for a retransmission
+    uint8_t flags;
+    uint8_t len;
+    uint8_t transmissions;
+    uint32_t sent_ms;
+    uint8_t data[STREAM_SEGMENT_SIZE];
+};
+
+struct RxSegment {
+    bool filled;
+    uint8_t flags;
+    uint8_t len;
+    uint8_t data[STREAM_SEGMENT_SIZE];
+};
+
+// Outgoing stream. Segments [una, end) occupy slots seq % STREAM_WINDOW;
+// [una, next) are in flight and the last one may still be filling.
+struct TxStream {
+    uint8_t state = STREAM_IDLE;
+    uint8_t stream_id = 0;
+    uint8_t peer_id = 0;
+    uint8_t mac[6];
+    uint16_t una = 0;
+    uint16_t next = 0;
+    uint16_t end = 0;
+    uint16_t peer_window_end = 0;
+    bool fin_queued = false;
+    bool in_recovery = false;
+    uint16_t recovery_seq = 0;   // Recovery ends once this is acknowledged
+    float cwnd = STREAM_INITIAL_CWND;
+    float ssthresh = STREAM_WINDOW;
+    uint32_t srtt_ms = 0;
+    uint32_t rttvar_ms = 0;
+    uint32_t rto_ms = STREAM_INITIAL_RTO_MS;
+    uint32_t opened_ms = 0;
+    uint32_t last_progress_ms = 0;
+    uint32_t last_write_ms = 0;
+    uint32_t last_status_ms = 0;
+    uint16_t last_credit = 0;     // As last reported to the host
+    uint32_t last_written = 0;
+    uint8_t last_state = STREAM_IDLE;
+    uint32_t bytes_written = 0;  // Accepted from the host
+    uint32_t bytes_acked = 0;
+    TxSegment segments[STREAM_WINDOW];
+};
+
+// Incoming stream. Segments [deliver_seq, next_seq) are received in order
+// and wait for the host; later ones may be buffered out of order.
+struct RxStream {
+    uint8_t state = STREAM_IDLE;
+    uint8_t stream_id = 0;
+    uint8_t peer_id = 0;
+    uint8_t mac[6];
+    uint16_t deliver_seq = 0;
+    uint16_t next_seq = 0;
+    uint16_t acked_window_end = 0;
+    bool announce = false;       // INCOMING event not yet sent to the host
+    bool ack_due = false;        // Segments arrived since the last ACK, answered from loop()
+    uint32_t last_ms = 0;
+    uint32_t bytes = 0;
+    RxSegment segments[STREAM_WINDOW];
+};
+
+// Reliable byte streams to one peer over ESP-NOW unicast: selective repeat
+// with cumulative + SACK acknowledgements, an adaptive (AIMD) congestion
+// window and an RFC 6298 style retransmission timer. One outgoing and one
+// incoming stream at a time keep memory bounded. The outgoing side runs
+// entirely in loop(); ACKs are queued by the receive callback. The incoming
+// side buffers in the callback, then delivers to the host and acknowledges
+// from loop(), one ACK for all segments since the last.
+class StreamManager {
+public:
+    // Host side, from the UART parser
+    void handleHostControl(const StreamControlPacket& packet, uint32_t now_ms);
+    void handleHostData(const StreamDataPacket& packet, size_t len, uint32_t now_ms);
+
+    // Air side, from the ESP-NOW receive callback
+    void handleSegment(const uint8_t* mac, uint8_t src_id, const StreamDataPacket& packet, size_t len);
+    void handleAck(uint8_t src_id, const StreamAckPacket& packet);
+
+    // Transmission, retransmission and delivery, called from loop()
+    void update(uint32_t now_ms);
+
+private:
+    // Outgoing
+    void openTx(uint8_t stream_id, uint8_t peer_id, uint32_t now_ms);
+    TxSegment* openSegment();
+    TxSegment* appendSegment(uint8_t flags);
+    void processAck(const StreamAckPacket& ack, uint32_t now_ms);
+    void updateRtt(uint32_t sample_ms);
+    void enterRecovery(bool timeout);
+    void transmitSegment(uint16_t seq, uint32_t now_ms);
+    void updateTx(uint32_t now_ms);
+    void finishTx(uint8_t state, uint32_t now_ms);
+    uint16_t credit();
+    void sendStatus(uint32_t now_ms);
+
+    // Incoming
+    void buildAck(StreamAckPacket& ack);
+    void updateRx(uint32_t now_ms);
+
+    void sendControl(uint8_t op, uint8_t stream_id, uint8_t peer_id, uint8_t state, uint16_t credit, uint32_t bytes);
+
+    TxStream tx;
+    portMUX_TYPE ack_lock = portMUX_INITIALIZER_UNLOCKED;
+    StreamAckPacket ack_queue[STREAM_ACK_QUEUE];
+    uint8_t ack_head = 0;
+    uint8_t ack_count = 0;
+
+    portMUX_TYPE rx_lock = portMUX_INITIALIZER_UNLOCKED;
+    RxStream rx;
+};
+
+#endif // STREAM_MANAGER_H
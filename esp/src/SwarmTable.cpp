@@ -0,0 +1,528 @@
+#include "SwarmTable.h"
+#include "ESPNowManager.h"
+#include "HostLink.h"
+#include "Statistics.h"
+#include "crc_utils.h"
+
+extern Statistics stats;
+extern ESPNowManager espNowManager;
+
+// Metres (or m/s) to centimetres, clamped so that garbage floats cannot overflow
+static int32_t toCentimetres(float value) {
+    if (isnan(value)) return 0;
+    float cm = value * 100.0f;
+    if (cm > 10000000.0f) return 10000000;
+    if (cm < -10000000.0f) return -10000000;
+    return (int32_t)lroundf(cm);
+}
+
+static int16_t saturate16(int32_t value) {
+    if (value > INT16_MAX) return INT16_MAX;
+    if (value < INT16_MIN) return INT16_MIN;
+    return (int16_t)value;
+}
+
+SwarmTable::SwarmTable() {
+    memset(slot_by_id, SWARM_SLOT_NONE, sizeof(slot_by_id));
+    memset(active, 0, sizeof(active));
+}
+
+uint8_t SwarmTable::findOrAllocate(uint8_t id, uint32_t now_ms) {
+    uint8_t slot = slot_by_id[id];
+    if (slot != SWARM_SLOT_NONE) {
+        return slot;
+    }
+
+    // Take a free slot, or evict the drone heard least recently
+    uint8_t oldest = 0;
+    for (uint8_t i = 0; i < SWARM_TABLE_CAPACITY; i++) {
+        if (!active[i]) {
+            slot = i;
+            break;
+        }
+        if (now_ms - last_seen_ms[i] > now_ms - last_seen_ms[oldest]) {
+            oldest = i;
+        }
+    }
+    if (slot == SWARM_SLOT_NONE) {
+        removeSlot(oldest, now_ms);
+        stats.swarm.entries_evicted++;
+        slot = oldest;
+    }
+
+    active[slot] = true;
+    drone_id[slot] = id;
+    status_code[slot] = 0;
+    battery_mv[slot] = 0;
+    error_flags[slot] = 0;
+    interesting[slot] = true;  // Until the next interest refresh ranks it
+    last_alert_ms[slot] = now_ms - CONFLICT_ALERT_INTERVAL_MS;
+    frames[slot] = 0;
+    rate_dpps[slot] = 0;
+    rssi_valid[slot] = false;
+    last_seen_ms[slot] = now_ms;
+    slot_by_id[id] = slot;
+    count++;
+    queueEvent(slot, NEIGHBOR_JOIN, now_ms);
+    return slot;
+}
+
+void SwarmTable::removeSlot(uint8_t slot, uint32_t now_ms) {
+    if (!active[slot]) return;
+    queueEvent(slot, NEIGHBOR_LEAVE, now_ms);
+    active[slot] = false;
+    slot_by_id[drone_id[slot]] = SWARM_SLOT_NONE;
+    count--;
+}
+
+void SwarmTable::updateTelemetry(const TelemetryPacket& packet, uint32_t now_ms) {
+    int32_t x = toCentimetres(packet.x);
+    int32_t y = toCentimetres(packet.y);
+    int32_t z = toCentimetres(packet.z);
+    int32_t vx = toCentimetres(packet.vx);
+    int32_t vy = toCentimetres(packet.vy);
+    int32_t vz = toCentimetres(packet.vz);
+
+    portENTER_CRITICAL(&lock);
+    uint8_t slot = findOrAllocate(packet.drone_id, now_ms);
+    x_cm[slot] = x;
+    y_cm[slot] = y;
+    z_cm[slot] = z;
+    vx_cms[slot] = vx;
+    vy_cms[slot] = vy;
+    vz_cms[slot] = vz;
+    telemetry_ms[slot] = now_ms;
+    last_seen_ms[slot] = now_ms;
+    portEXIT_CRITICAL(&lock);
+}
+
+void SwarmTable::updateStatus(const StatusPacket& packet, uint32_t now_ms) {
+    portENTER_CRITICAL(&lock);
+    // Status alone carries no position, so it only refreshes known drones
+    uint8_t slot = slot_by_id[packet.drone_id];
+    if (slot != SWARM_SLOT_NONE) {
+        status_code[slot] = packet.status_code;
+        battery_mv[slot] = packet.battery_mv;
+        error_flags[slot] = packet.error_flags;
+        last_seen_ms[slot] = now_ms;
+    }
+    portEXIT_CRITICAL(&lock);
+}
+
+void SwarmTable::recordFrame(uint8_t id, bool has_rssi, int8_t rssi, uint32_t now_ms) {
+    portENTER_CRITICAL(&lock);
+    uint8_t slot = slot_by_id[id];
+    if (slot != SWARM_SLOT_NONE) {
+        last_seen_ms[slot] = now_ms;
+        if (frames[slot] < UINT16_MAX) {
+            frames[slot]++;
+        }
+        if (has_rssi) {
+            int16_t sample = (int16_t)rssi * 16;
+            if (rssi_valid[slot]) {
+                rssi_x16[slot] += (sample - rssi_x16[slot]) >> NEIGHBOR_RSSI_SHIFT;
+            } else {
+                rssi_x16[slot] = sample;
+                rssi_valid[slot] = true;
+            }
+        }
+    }
+    portEXIT_CRITICAL(&lock);
+}
+
+void SwarmTable::updateSelf(const TelemetryPacket& packet, uint32_t now_ms) {
+    int32_t x = toCentimetres(packet.x);
+    int32_t y = toCentimetres(packet.y);
+    int32_t z = toCentimetres(packet.z);
+    int32_t vx = toCentimetres(packet.vx);
+    int32_t vy = toCentimetres(packet.vy);
+    int32_t vz = toCentimetres(packet.vz);
+
+    portENTER_CRITICAL(&lock);
+    self_x_cm = x;
+    self_y_cm = y;
+    self_z_cm = z;
+    self_vx_cms = vx;
+    self_vy_cms = vy;
+    self_vz_cms = vz;
+    self_ms = now_ms;
+    has_self = true;
+    portEXIT_CRITICAL(&lock);
+}
+
+void SwarmTable::setInterestRadius(int32_t radius_cm) {
+    interest_radius_cm = radius_cm > 0 ? radius_cm : 0;
+    grid.setCellSize(interest_radius_cm > 0 ? interest_radius_cm : GRID_DEFAULT_CELL_CM);
+    Serial.printf("Interest radius: %ld cm%s\n", (long)interest_radius_cm,
+                 interest_radius_cm == 0 ? " (unlimited)" : "");
+}
+
+void SwarmTable::setInterestK(uint8_t k) {
+    interest_k = k;
+    Serial.printf("Interest k-nearest: %d%s\n", k, k == 0 ? " (all)" : "");
+}
+
+bool SwarmTable::isOfInterest(uint8_t id) {
+    if (!interestEnabled()) return true;
+
+    bool result = true;
+    portENTER_CRITICAL(&lock);
+    uint8_t slot = slot_by_id[id];
+    // Without our own position there is nothing to rank against, forward everything
+    if (has_self && slot != SWARM_SLOT_NONE) {
+        if (interest_radius_cm > 0) {
+            int64_t dx = x_cm[slot] - self_x_cm;
+            int64_t dy = y_cm[slot] - self_y_cm;
+            int64_t dz = z_cm[slot] - self_z_cm;
+            result = dx * dx + dy * dy + dz * dz <= (int64_t)interest_radius_cm * interest_radius_cm;
+        }
+        if (interest_k > 0) {
+            result = result && interesting[slot];
+        }
+    }
+    portEXIT_CRITICAL(&lock);
+    return result;
+}
+
+void SwarmTable::refreshInterest() {
+    uint8_t selected[SWARM_TABLE_CAPACITY];
+
+    portENTER_CRITICAL(&lock);
+    if (!has_self) {
+        memset(interesting, 1, sizeof(interesting));
+    } else {
+        grid.rebuild(active, x_cm, y_cm, z_cm, SWARM_TABLE_CAPACITY);
+        uint8_t n;
+        if (interest_k > 0) {
+            n = grid.queryNearest(self_x_cm, self_y_cm, self_z_cm, interest_k, interest_radius_cm, selected);
+        } else {
+            n = grid.queryRadius(self_x_cm, self_y_cm, self_z_cm, interest_radius_cm,
+                                 selected, SWARM_TABLE_CAPACITY);
+        }
+        memset(interesting, 0, sizeof(interesting));
+        for (uint8_t i = 0; i < n; i++) {
+            interesting[selected[i]] = true;
+        }
+    }
+    portEXIT_CRITICAL(&lock);
+}
+
+void SwarmTable::setConflictRadius(int32_t radius_cm) {
+    conflict_radius_cm = radius_cm > 0 ? radius_cm : 0;
+    Serial.printf("Conflict radius: %ld cm%s\n", (long)conflict_radius_cm,
+                 conflict_radius_cm == 0 ? " (detection off)" : "");
+}
+
+void SwarmTable::setConflictHorizon(uint32_t horizon_ms) {
+    // time_to_cpa_ms is reported in 16 bits
+    conflict_horizon_ms = horizon_ms > 0xFFFF ? 0xFFFF : horizon_ms;
+    Serial.printf("Conflict horizon: %lu ms\n", (unsigned long)conflict_horizon_ms);
+}
+
+static uint16_t distanceCm(int64_t d2) {
+    // Integer square root, result saturates at 65535 cm
+    if (d2 >= 65535LL * 65535LL) return 0xFFFF;
+    uint32_t r = (uint32_t)sqrtf((float)d2);
+    while ((int64_t)r * r > d2) r--;
+    while ((int64_t)(r + 1) * (r + 1) <= d2) r++;
+    return (uint16_t)r;
+}
+
+void SwarmTable::checkConflict(uint8_t id, uint32_t now_ms) {
+    if (!conflictDetectionEnabled()) return;
+
+    ConflictAlertPacket alert;
+    bool conflict = false;
+    bool send = false;
+
+    portENTER_CRITICAL(&lock);
+    uint8_t slot = slot_by_id[id];
+    if (has_self && slot != SWARM_SLOT_NONE && now_ms - self_ms <= SELF_STALE_MS) {
+        // Bring our own state forward to the neighbour's fix, all in cm, cm/s and ms
+        int64_t self_dt = now_ms - self_ms;
+        int64_t px = x_cm[slot] - (self_x_cm + self_vx_cms * self_dt / 1000);
+        int64_t py = y_cm[slot] - (self_y_cm + self_vy_cms * self_dt / 1000);
+        int64_t pz = z_cm[slot] - (self_z_cm + self_vz_cms * self_dt / 1000);
+        int64_t vx = vx_cms[slot] - self_vx_cms;
+        int64_t vy = vy_cms[slot] - self_vy_cms;
+        int64_t vz = vz_cms[slot] - self_vz_cms;
+
+        // t* = -(p.v)/(v.v), clamped to [0, horizon]
+        int64_t pv = px * vx + py * vy + pz * vz;
+        int64_t vv = vx * vx + vy * vy + vz * vz;
+        int64_t t_ms = 0;
+        if (vv > 0 && pv < 0) {
+            t_ms = -pv * 1000 / vv;
+            if (t_ms > (int64_t)conflict_horizon_ms) t_ms = conflict_horizon_ms;
+        }
+
+        int64_t cx = px + vx * t_ms / 1000;
+        int64_t cy = py + vy * t_ms / 1000;
+        int64_t cz = pz + vz * t_ms / 1000;
+        int64_t min_d2 = cx * cx + cy * cy + cz * cz;
+        int64_t now_d2 = px * px + py * py + pz * pz;
+        int64_t r2 = (int64_t)conflict_radius_cm * conflict_radius_cm;
+
+        conflict = min_d2 <= r2;
+        if (conflict && now_ms - last_alert_ms[slot] >= CONFLICT_ALERT_INTERVAL_MS) {
+            last_alert_ms[slot] = now_ms;
+            alert.drone_id = id;
+            alert.severity = now_d2 <= r2 ? CONFLICT_INSIDE : CONFLICT_PREDICTED;
+            alert.time_to_cpa_ms = (uint16_t)t_ms;
+            alert.min_distance_cm = distanceCm(min_d2);
+            alert.distance_cm = distanceCm(now_d2);
+            send = true;
+        }
+    }
+    portEXIT_CRITICAL(&lock);
+
+    stats.swarm.cpa_checks++;
+    if (conflict) stats.swarm.conflicts_detected++;
+    if (!send) return;
+
+    initPacketHeader(alert.header, CONFLICT_ALERT, sizeof(alert), espNowManager.getConfig().network_id);
+    sealPacket((uint8_t*)&alert, sizeof(alert));
+    if (sendToHost((uint8_t*)&alert, sizeof(alert))) {
+        stats.swarm.alerts_sent++;
+    }
+}
+
+void SwarmTable::expire(uint32_t now_ms) {
+    portENTER_CRITICAL(&lock);
+    for (uint8_t i = 0; i < SWARM_TABLE_CAPACITY; i++) {
+        if (active[i] && now_ms - last_seen_ms[i] > SWARM_ENTRY_TIMEOUT_MS) {
+            removeSlot(i, now_ms);
+            stats.swarm.entries_expired++;
+        }
+    }
+    portEXIT_CRITICAL(&lock);
+}
+
+void SwarmTable::setSnapshotInterval(uint32_t interval_ms) {
+    snapshot_interval_ms = interval_ms;
+    last_snapshot_ms = millis();
+    Serial.printf("Swarm snapshot interval: %lu ms%s\n", (unsigned long)interval_ms,
+                 interval_ms == 0 ? " (per-packet forwarding)" : "");
+}
+
+void SwarmTable::update(uint32_t now_ms) {
+    if (now_ms - last_expire_ms >= SWARM_EXPIRE_INTERVAL_MS) {
+        expire(now_ms);
+        last_expire_ms = now_ms;
+    }
+
+    if (now_ms - last_rate_ms >= NEIGHBOR_RATE_WINDOW_MS) {
+        updateRates(now_ms);
+    }
+
+    if (event_count > 0) {
+        sendEvents();
+    }
+
+    if (interestEnabled() && now_ms - last_interest_ms >= INTEREST_REFRESH_MS) {
+        refreshInterest();
+        last_interest_ms = now_ms;
+    }
+
+    if (snapshot_interval_ms > 0 && now_ms - last_snapshot_ms >= snapshot_interval_ms) {
+        publishSnapshot(now_ms);
+        last_snapshot_ms = now_ms;
+    }
+}
+
+void SwarmTable::publishSnapshot(uint32_t now_ms) {
+    // Copy out under the lock, pack and send without it
+    SnapshotEntry entries[SWARM_TABLE_CAPACITY];
+    uint8_t n = 0;
+    bool filtered = interestEnabled();
+
+    portENTER_CRITICAL(&lock);
+    for (uint8_t i = 0; i < SWARM_TABLE_CAPACITY; i++) {
+        if (!active[i] || (filtered && !interesting[i])) continue;
+        SnapshotEntry& e = entries[n++];
+        uint32_t age = now_ms - telemetry_ms[i];
+        e.drone_id = drone_id[i];
+        e.status_code = status_code[i];
+        e.age_ms = age > 0xFFFF ? 0xFFFF : (uint16_t)age;
+        e.x_cm = saturate16(x_cm[i]);
+        e.y_cm = saturate16(y_cm[i]);
+        e.z_cm = saturate16(z_cm[i]);
+        e.vx_cms = saturate16(vx_cms[i]);
+        e.vy_cms = saturate16(vy_cms[i]);
+        e.vz_cms = saturate16(vz_cms[i]);
+    }
+    portEXIT_CRITICAL(&lock);
+
+    sendSnapshot(entries, n, now_ms, snapshot_id++, filtered ? SNAPSHOT_FLAG_INTEREST_FILTERED : 0);
+    stats.swarm.snapshots_sent++;
+}
+
+void SwarmTable::publishPositions(uint8_t query_id, uint32_t ahead_ms, uint32_t now_ms) {
+    if (ahead_ms > DEAD_RECKONING_MAX_MS) ahead_ms = DEAD_RECKONING_MAX_MS;
+    uint32_t target_ms = now_ms + ahead_ms;
+
+    SnapshotEntry entries[SWARM_TABLE_CAPACITY];
+    uint8_t n = 0;
+    bool filtered = interestEnabled();
+
+    portENTER_CRITICAL(&lock);
+    for (uint8_t i = 0; i < SWARM_TABLE_CAPACITY; i++) {
+        if (!active[i] || (filtered && !interesting[i])) continue;
+        SnapshotEntry& e = entries[n++];
+        // age_ms is how far this entry was projected past its fix
+        uint32_t dt = target_ms - telemetry_ms[i];
+        e.drone_id = drone_id[i];
+        e.status_code = status_code[i];
+        e.age_ms = dt > 0xFFFF ? 0xFFFF : (uint16_t)dt;
+        if (dt > DEAD_RECKONING_MAX_MS) dt = DEAD_RECKONING_MAX_MS;
+        e.x_cm = saturate16(x_cm[i] + (int64_t)vx_cms[i] * dt / 1000);
+        e.y_cm = saturate16(y_cm[i] + (int64_t)vy_cms[i] * dt / 1000);
+        e.z_cm = saturate16(z_cm[i] + (int64_t)vz_cms[i] * dt / 1000);
+        e.vx_cms = saturate16(vx_cms[i]);
+        e.vy_cms = saturate16(vy_cms[i]);
+        e.vz_cms = saturate16(vz_cms[i]);
+    }
+    portEXIT_CRITICAL(&lock);
+
+    uint8_t flags = SNAPSHOT_FLAG_EXTRAPOLATED;
+    if (filtered) flags |= SNAPSHOT_FLAG_INTEREST_FILTERED;
+    sendSnapshot(entries, n, target_ms, query_id, flags);
+    stats.swarm.position_queries++;
+}
+
+void SwarmTable::sendSnapshot(const SnapshotEntry* entries, uint8_t n, uint32_t timestamp_ms, uint8_t id,
+                              uint8_t flags) {
+    uint8_t network_id = espNowManager.getConfig().network_id;
+    uint8_t part = 0;
+    uint8_t sent = 0;
+
+    // An empty table still produces one (empty) last part
+    do {
+        uint8_t chunk = n - sent;
+        if (chunk > SNAPSHOT_ENTRIES_PER_PACKET) {
+            chunk = SNAPSHOT_ENTRIES_PER_PACKET;
+        }
+
+        SwarmSnapshotPacket packet;
+        size_t len = offsetof(SwarmSnapshotPacket, entries) + chunk * sizeof(SnapshotEntry) + sizeof(uint16_t);
+        initPacketHeader(packet.header, SWARM_SNAPSHOT, len, network_id);
+        packet.timestamp_ms = timestamp_ms;
+        packet.snapshot_id = id;
+        packet.part = part++;
+        packet.count = chunk;
+        packet.flags = flags;
+        if (sent + chunk == n) {
+            packet.flags |= SNAPSHOT_FLAG_LAST_PART;
+        }
+        memcpy(packet.entries, entries + sent, chunk * sizeof(SnapshotEntry));
+        sealPacket((uint8_t*)&packet, len);
+
+        if (sendToHost((uint8_t*)&packet, len)) {
+            stats.swarm.snapshot_packets++;
+        }
+        sent += chunk;
+    } while (sent < n);
+}
+
+uint8_t SwarmTable::activeIds(uint8_t* out, uint8_t max_out) {
+    uint8_t n = 0;
+    portENTER_CRITICAL(&lock);
+    for (uint8_t i = 0; i < SWARM_TABLE_CAPACITY && n < max_out; i++) {
+        if (active[i]) out[n++] = drone_id[i];
+    }
+    portEXIT_CRITICAL(&lock);
+    return n;
+}
+
+void SwarmTable::updateRates(uint32_t now_ms) {
+    uint32_t window_ms = now_ms - last_rate_ms;
+    last_rate_ms = now_ms;
+    portENTER_CRITICAL(&lock);
+    for (uint8_t i = 0; i < SWARM_TABLE_CAPACITY; i++) {
+        if (!active[i]) continue;
+        uint32_t dpps = (uint32_t)frames[i] * 10000 / window_ms;
+        rate_dpps[i] = dpps > UINT16_MAX ? UINT16_MAX : (uint16_t)dpps;
+        frames[i] = 0;
+    }
+    portEXIT_CRITICAL(&lock);
+}
+
+// Caller holds the lock
+void SwarmTable::fillNeighbor(NeighborPacket& packet, uint8_t slot, uint8_t event, uint32_t now_ms) {
+    uint32_t age = now_ms - last_seen_ms[slot];
+    memset(&packet, 0, sizeof(packet));
+    packet.event = event;
+    packet.drone_id = drone_id[slot];
+    packet.status_code = status_code[slot];
+    if (rssi_valid[slot]) {
+        packet.rssi = (int8_t)(rssi_x16[slot] / 16);
+        packet.flags |= NEIGHBOR_FLAG_RSSI;
+    }
+    packet.rate_dpps = rate_dpps[slot];
+    packet.age_ms = age > 0xFFFF ? 0xFFFF : (uint16_t)age;
+}
+
+// Caller holds the lock
+void SwarmTable::queueEvent(uint8_t slot, uint8_t event, uint32_t now_ms) {
+    if (!events_enabled) return;
+    if (event_count >= NEIGHBOR_EVENT_QUEUE) {
+        stats.swarm.neighbor_events_dropped++;
+        return;
+    }
+    fillNeighbor(events[event_count++], slot, event, now_ms);
+}
+
+void SwarmTable::sendEvents() {
+    NeighborPacket out[NEIGHBOR_EVENT_QUEUE];
+    portENTER_CRITICAL(&lock);
+    uint8_t n = event_count;
+    memcpy(out, events, n * sizeof(NeighborPacket));
+    event_count = 0;
+    portEXIT_CRITICAL(&lock);
+
+    uint8_t network_id = espNowManager.getConfig().network_id;
+    for (uint8_t i = 0; i < n; i++) {
+        initPacketHeader(out[i].header, NEIGHBOR, sizeof(NeighborPacket), network_id);
+        sealPacket((uint8_t*)&out[i], sizeof(NeighborPacket));
+        if (sendToHost((uint8_t*)&out[i], sizeof(NeighborPacket))) {
+            stats.swarm.neighbor_events++;
+        }
+    }
+}
+
+void SwarmTable::setNeighborEvents(bool enabled) {
+    portENTER_CRITICAL(&lock);
+    events_enabled = enabled;
+    if (!enabled) {
+        event_count = 0;
+    }
+    portEXIT_CRITICAL(&lock);
+    Serial.printf("Neighbour events %s\n", enabled ? "on" : "off");
+}
+
+void SwarmTable::publishNeighbors(uint8_t query_id, uint32_t now_ms) {
+    // Copy out under the lock, send without it
+    NeighborPacket entries[SWARM_TABLE_CAPACITY];
+    uint8_t n = 0;
+    portENTER_CRITICAL(&lock);
+    for (uint8_t i = 0; i < SWARM_TABLE_CAPACITY; i++) {
+        if (active[i]) {
+            fillNeighbor(entries[n++], i, NEIGHBOR_STATE, now_ms);
+        }
+    }
+    portEXIT_CRITICAL(&lock);
+
+    uint8_t network_id = espNowManager.getConfig().network_id;
+    for (uint8_t i = 0; i <= n; i++) {
+        NeighborPacket& packet = entries[i < n ? i : 0];
+        if (i == n) {
+            memset(&packet, 0, sizeof(packet));
+            packet.event = NEIGHBOR_END;
+            packet.drone_id = n;
+        }
+        packet.query_id = query_id;
+        initPacketHeader(packet.header, NEIGHBOR, sizeof(packet), network_id);
+        sealPacket((uint8_t*)&packet, sizeof(packet));
+        sendToHost((uint8_t*)&packet, sizeof(packet));
+    }
+}
@@ -0,0 +1,141 @@
+#ifndef SWARM_TABLE_H
+#define SWARM_TABLE_H
+
+#include <Arduino.h>
+#include "Packet.h"
+#include "SpatialGrid.h"
+
+#define SWARM_TABLE_CAPACITY 48
+#define SWARM_SLOT_NONE 0xFF
+#define SWARM_ENTRY_TIMEOUT_MS 5000
+#define SWARM_EXPIRE_INTERVAL_MS 500
+#define INTEREST_REFRESH_MS 50
+#define CONFLICT_DEFAULT_HORIZON_MS 3000
+#define CONFLICT_ALERT_INTERVAL_MS 100  // Per-neighbour alert rate limit
+#define SELF_STALE_MS 1000              // Own telemetry older than this disables CPA checks
+#define DEAD_RECKONING_MAX_MS 2000      // Longest extrapolation; older fixes are held there
+#define NEIGHBOR_RATE_WINDOW_MS 1000    // Frames per second are counted over this window
+#define NEIGHBOR_RSSI_SHIFT 3           // RSSI average: each frame weighs 1/8
+#define NEIGHBOR_EVENT_QUEUE 16         // Join/leave events waiting for loop()
+
+// Latest telemetry/status of every drone heard over ESP-NOW.
+// Fixed-capacity structure of arrays indexed by slot; slot_by_id maps a
+// drone_id to its slot in O(1). Positions are stored in centimetres and
+// velocities in cm/s so that consumers can work in integer arithmetic.
+// Writers run in the ESP-NOW receive callback, readers in loop(); every
+// access goes through the spinlock.
+class SwarmTable {
+public:
+    SwarmTable();
+
+    void updateTelemetry(const TelemetryPacket& packet, uint32_t now_ms);
+    void updateStatus(const StatusPacket& packet, uint32_t now_ms);
+    // Own telemetry as sent by the host, the centre of the interest area
+    void updateSelf(const TelemetryPacket& packet, uint32_t now_ms);
+
+    // Periodic work from loop(): expiry and snapshot publishing
+    void update(uint32_t now_ms);
+
+    // Snapshot mode replaces per-frame telemetry forwarding to the host
+    void setSnapshotInterval(uint32_t interval_ms);
+    uint32_t getSnapshotInterval() const { return snapshot_interval_ms; }
+    bool snapshotsEnabled() const { return snapshot_interval_ms > 0; }
+    void publishSnapshot(uint32_t now_ms);
+
+    // Answer a host position query with every entry dead-reckoned to
+    // now + ahead_ms from its last fix and velocity
+    void publishPositions(uint8_t query_id, uint32_t ahead_ms, uint32_t now_ms);
+
+    // Interest management: only neighbours within radius and/or among the
+    // k nearest are forwarded to the host (0 disables either criterion)
+    void setInterestRadius(int32_t radius_cm);
+    void setInterestK(uint8_t k);
+    bool interestEnabled() const { return interest_radius_cm > 0 || interest_k > 0; }
+    bool isOfInterest(uint8_t drone_id);
+
+    // Closest-point-of-approach check against our own state, run for every
+    // neighbour telemetry frame; emits a CONFLICT_ALERT to the host at once
+    void setConflictRadius(int32_t radius_cm);
+    void setConflictHorizon(uint32_t horizon_ms);
+    bool conflictDetectionEnabled() const { return conflict_radius_cm > 0; }
+    void checkConflict(uint8_t drone_id, uint32_t now_ms);
+
+    // Any frame from a drone of the table: liveness, frame rate and, for
+    // frames heard directly, signal strength. From the receive callback.
+    void recordFrame(uint8_t drone_id, bool has_rssi, int8_t rssi, uint32_t now_ms);
+
+    // Push NEIGHBOR join/leave events to the host as drones come and go
+    void setNeighborEvents(bool enabled);
+    // One NEIGHBOR_STATE per entry, then NEIGHBOR_END
+    void publishNeighbors(uint8_t query_id, uint32_t now_ms);
+
+    // drone_ids of all current entries, returns the number written
+    uint8_t activeIds(uint8_t* out, uint8_t max_out);
+
+    uint8_t size() const { return count; }
+
+private:
+    uint8_t findOrAllocate(uint8_t drone_id, uint32_t now_ms);
+    void removeSlot(uint8_t slot, uint32_t now_ms);
+    void fillNeighbor(NeighborPacket& packet, uint8_t slot, uint8_t event, uint32_t now_ms);
+    void queueEvent(uint8_t slot, uint8_t event, uint32_t now_ms);
+    void updateRates(uint32_t now_ms);
+    void sendEvents();
+    void expire(uint32_t now_ms);
+    void refreshInterest();
+    void sendSnapshot(const SnapshotEntry* entries, uint8_t n, uint32_t timestamp_ms, uint8_t id, uint8_t flags);
+
+    portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+
+    uint8_t slot_by_id[256];
+    uint8_t count = 0;
+
+    bool active[SWARM_TABLE_CAPACITY];
+    uint8_t drone_id[SWARM_TABLE_CAPACITY];
+    int32_t x_cm[SWARM_TABLE_CAPACITY];
+    int32_t y_cm[SWARM_TABLE_CAPACITY];
+    int32_t z_cm[SWARM_TABLE_CAPACITY];
+    int32_t vx_cms[SWARM_TABLE_CAPACITY];
+    int32_t vy_cms[SWARM_TABLE_CAPACITY];
+    int32_t vz_cms[SWARM_TABLE_CAPACITY];
+    uint8_t status_code[SWARM_TABLE_CAPACITY];
+    uint16_t battery_mv[SWARM_TABLE_CAPACITY];
+    uint16_t error_flags[SWARM_TABLE_CAPACITY];
+    uint32_t telemetry_ms[SWARM_TABLE_CAPACITY];
+    uint32_t last_seen_ms[SWARM_TABLE_CAPACITY];
+    bool interesting[SWARM_TABLE_CAPACITY];
+    uint32_t last_alert_ms[SWARM_TABLE_CAPACITY];
+    uint16_t frames[SWARM_TABLE_CAPACITY];      // In the current rate window
+    uint16_t rate_dpps[SWARM_TABLE_CAPACITY];
+    int16_t rssi_x16[SWARM_TABLE_CAPACITY];     // Average in 1/16 dBm
+    bool rssi_valid[SWARM_TABLE_CAPACITY];
+
+    bool has_self = false;
+    int32_t self_x_cm = 0;
+    int32_t self_y_cm = 0;
+    int32_t self_z_cm = 0;
+    int32_t self_vx_cms = 0;
+    int32_t self_vy_cms = 0;
+    int32_t self_vz_cms = 0;
+    uint32_t self_ms = 0;
+
+    SpatialGrid grid;
+    int32_t interest_radius_cm = 0;
+    uint8_t interest_k = 0;
+    uint32_t last_interest_ms = 0;
+
+    int32_t conflict_radius_cm = 0;
+    uint32_t conflict_horizon_ms = CONFLICT_DEFAULT_HORIZON_MS;
+
+    uint32_t last_rate_ms = 0;
+    bool events_enabled = false;
+    NeighborPacket events[NEIGHBOR_EVENT_QUEUE];
+    uint8_t event_count = 0;
+
+    uint32_t snapshot_interval_ms = 0;
+    uint32_t last_snapshot_ms = 0;
+    uint32_t last_expire_ms = 0;
+    uint8_t snapshot_id = 0;
+};
+
+#endif // SWARM_TABLE_H
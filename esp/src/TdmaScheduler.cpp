@@ -0,0 +1,28 @@
+#include "TdmaScheduler.h"
+
+bool TdmaScheduler::configure(uint8_t n, uint32_t length_us) {
+    if (n > TDMA_MAX_SLOTS || (n > 0 && length_us < TDMA_MIN_SLOT_US)) {
+        return false;
+    }
+    slots = n;
+    if (n > 0) {
+        slot_us = length_us;
+    }
+    return true;
+}
+
+bool TdmaScheduler::canTransmit(int64_t now_us, uint8_t drone_id) const {
+    if (!enabled()) return true;
+    int64_t frame = frameUs();
+    int64_t position = ((now_us % frame) + frame) % frame;
+    int64_t into_slot = position - (int64_t)slotOf(drone_id) * slot_us;
+    return into_slot >= TDMA_GUARD_US && into_slot <= (int64_t)slot_us - TDMA_GUARD_US - TDMA_AIRTIME_US;
+}
+
+int64_t TdmaScheduler::nextWindow(int64_t now_us, uint8_t drone_id) const {
+    if (canTransmit(now_us, drone_id)) return now_us;
+    int64_t frame = frameUs();
+    int64_t position = ((now_us % frame) + frame) % frame;
+    int64_t window = now_us - position + (int64_t)slotOf(drone_id) * slot_us + TDMA_GUARD_US;
+    return window > now_us ? window : window + frame;
+}
@@ -0,0 +1,38 @@
+#ifndef TDMA_SCHEDULER_H
+#define TDMA_SCHEDULER_H
+
+#include <stdint.h>
+
+#define TDMA_GUARD_US 250        // Clock error allowed at both ends of a slot
+#define TDMA_AIRTIME_US 1000     // A telemetry frame at the 1 Mbps ESP-NOW rate, preamble included
+#define TDMA_MIN_SLOT_US 2000    // Guards, airtime and the ~1 ms loop() period
+#define TDMA_DEFAULT_SLOT_US 3000
+#define TDMA_MAX_SLOTS 64
+
+// Time division of the channel for periodic traffic. A frame of `slots`
+// slots repeats on a time base shared by the swarm; drone_id % slots picks
+// ours. A transmission may start once the guard time into the slot has
+// passed and only while it still ends a guard time before the slot does.
+// Plain arithmetic on microseconds, no Arduino dependency, so the native
+// simulator runs the same code.
+class TdmaScheduler {
+public:
+    // 0 slots turns TDMA off; false (and no change) for an unusable slot length
+    bool configure(uint8_t slots, uint32_t slot_us);
+    bool enabled() const { return slots > 0; }
+    uint8_t getSlots() const { return slots; }
+    uint32_t getSlotUs() const { return slot_us; }
+    uint32_t frameUs() const { return (uint32_t)slots * slot_us; }
+    uint8_t slotOf(uint8_t drone_id) const { return slots > 0 ? drone_id % slots : 0; }
+
+    // now_us is on the shared time base
+    bool canTransmit(int64_t now_us, uint8_t drone_id) const;
+    // Earliest time at or after now_us at which canTransmit holds
+    int64_t nextWindow(int64_t now_us, uint8_t drone_id) const;
+
+private:
+    uint8_t slots = 0;
+    uint32_t slot_us = TDMA_DEFAULT_SLOT_US;
+};
+
+#endif // TDMA_SCHEDULER_H
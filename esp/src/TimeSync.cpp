@@ -0,0 +1,255 @@
+#include "TimeSync.h"
+#include <esp_timer.h>
+#include "ESPNowManager.h"
+#include "Statistics.h"
+#include "HostLink.h"
+#include "crc_utils.h"
+
+extern ESPNowManager espNowManager;
+extern Statistics stats;
+
+void TimeSync::setRole(uint8_t r) {
+    portENTER_CRITICAL(&lock);
+    role = r;
+    is_master = false;
+    master_known = false;
+    resetFilter();
+    portEXIT_CRITICAL(&lock);
+    enabled_ms = millis();
+    stats.time.is_master = false;
+
+    static const char* names[] = {"off", "follower", "candidate"};
+    Serial.printf("Time sync: %s\n", r <= TIME_SYNC_CANDIDATE ? names[r] : "?");
+}
+
+void TimeSync::initPacket(TimeSyncPacket& packet, uint8_t op) {
+    memset(&packet, 0, sizeof(packet));
+    initPacketHeader(packet.header, TIME_SYNC, sizeof(packet), espNowManager.getConfig().network_id);
+    packet.op = op;
+}
+
+// Caller holds the lock
+void TimeSync::resetFilter() {
+    sample_count = 0;
+    sample_next = 0;
+    synced = false;
+    drift_ppb = 0;
+    drift_valid = false;
+    anchor_valid = false;
+    pending_t1 = 0;
+    stats.time.synced = false;
+}
+
+// Caller holds the lock
+void TimeSync::followMaster(uint8_t id, const uint8_t* mac, uint32_t now_ms) {
+    if (!master_known || master_id != id) {
+        resetFilter();
+        stats.time.master_changes++;
+    }
+    master_known = true;
+    master_id = id;
+    memcpy(master_mac, mac, 6);
+    master_seen_ms = now_ms;
+    stats.time.master_id = id;
+}
+
+// Caller holds the lock
+void TimeSync::addSample(const TimeSyncSample& sample) {
+    samples[sample_next] = sample;
+    sample_next = (sample_next + 1) % TIME_SYNC_SAMPLES;
+    if (sample_count < TIME_SYNC_SAMPLES) sample_count++;
+
+    const TimeSyncSample* best = &samples[0];
+    for (uint8_t i = 1; i < sample_count; i++) {
+        if (samples[i].delay_us < best->delay_us) best = &samples[i];
+    }
+
+    // Drift from how the offset of the best exchanges moves over time
+    if (!anchor_valid) {
+        anchor = *best;
+        anchor_valid = true;
+    } else if (best->local_us - anchor.local_us >= TIME_SYNC_DRIFT_SPAN_US) {
+        int64_t measured = (best->offset_us - anchor.offset_us) * 1000000000LL /
+                           (best->local_us - anchor.local_us);
+        if (measured >= -TIME_SYNC_MAX_DRIFT_PPB && measured <= TIME_SYNC_MAX_DRIFT_PPB) {
+            drift_ppb = drift_valid ? (int32_t)((3 * (int64_t)drift_ppb + measured) / 4) : (int32_t)measured;
+            drift_valid = true;
+        }
+        anchor = *best;
+    }
+
+    offset_us = best->offset_us;
+    ref_local_us = best->local_us;
+    error_us = (uint16_t)min<int64_t>(best->delay_us / 2, UINT16_MAX);
+    synced = true;
+
+    stats.time.synced = true;
+    stats.time.offset_us = offset_us;
+    stats.time.drift_ppb = drift_ppb;
+    stats.time.error_us = error_us;
+}
+
+bool TimeSync::toMasterTime(int64_t local_us, int64_t& master_us) {
+    portENTER_CRITICAL(&lock);
+    bool valid = synced || is_master;
+    if (is_master) {
+        master_us = local_us;
+    } else if (synced) {
+        master_us = local_us + offset_us + (local_us - ref_local_us) * drift_ppb / 1000000000LL;
+    } else {
+        master_us = local_us;
+    }
+    portEXIT_CRITICAL(&lock);
+    return valid;
+}
+
+void TimeSync::handleAir(const uint8_t* mac, uint8_t src_id, bool direct, const TimeSyncPacket& packet, int64_t rx_us) {
+    if (role == TIME_SYNC_OFF || src_id == espNowManager.getNodeId()) return;
+    uint32_t now_ms = millis();
+
+    switch (packet.op) {
+        case TIME_SYNC_BEACON: {
+            if (!direct) return;
+            stats.time.beacons_received++;
+            portENTER_CRITICAL(&lock);
+            bool current_alive = master_known && now_ms - master_seen_ms < TIME_SYNC_MASTER_TIMEOUT_MS;
+            if (!current_alive || src_id <= master_id) {
+                followMaster(src_id, mac, now_ms);
+            }
+            portEXIT_CRITICAL(&lock);
+            break;
+        }
+
+        case TIME_SYNC_REQUEST: {
+            if (!is_master) return;
+            TimeSyncPacket response;
+            initPacket(response, TIME_SYNC_RESPONSE);
+            response.master_id = espNowManager.getNodeId();
+            response.flags = TIME_SYNC_FLAG_MASTER | TIME_SYNC_FLAG_SYNCED;
+            response.t1 = packet.t1;
+            response.t2 = rx_us;
+            response.t3 = esp_timer_get_time();
+            sealPacket((uint8_t*)&response, sizeof(response));
+            if (espNowManager.replyUnicast(mac, (const uint8_t*)&response, sizeof(response))) {
+                stats.time.responses_sent++;
+            }
+            break;
+        }
+
+        case TIME_SYNC_RESPONSE: {
+            portENTER_CRITICAL(&lock);
+            // Only the answer to our outstanding request, from the master we follow
+            if (master_known && src_id == master_id && pending_t1 != 0 && (int64_t)packet.t1 == pending_t1) {
+                pending_t1 = 0;
+                int64_t t1 = packet.t1, t2 = packet.t2, t3 = packet.t3, t4 = rx_us;
+                TimeSyncSample sample;
+                sample.offset_us = ((t2 - t1) + (t3 - t4)) / 2;
+                sample.delay_us = (t4 - t1) - (t3 - t2);
+                sample.local_us = t4;
+                if (sample.delay_us >= 0 && sample.delay_us <= TIME_SYNC_MAX_DELAY_US) {
+                    addSample(sample);
+                    stats.time.samples++;
+                } else {
+                    stats.time.samples_rejected++;
+                }
+            }
+            portEXIT_CRITICAL(&lock);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+void TimeSync::handleHostPing(const PingPacket& ping) {
+    TimeSyncPacket status;
+    initPacket(status, TIME_SYNC_STATUS);
+    int64_t local_us = esp_timer_get_time();
+    int64_t master_us;
+    bool valid = toMasterTime(local_us, master_us);
+
+    portENTER_CRITICAL(&lock);
+    status.master_id = is_master ? espNowManager.getNodeId() : master_id;
+    status.flags = (valid ? TIME_SYNC_FLAG_SYNCED : 0) | (is_master ? TIME_SYNC_FLAG_MASTER : 0);
+    status.drift_ppb = drift_ppb;
+    status.error_us = is_master ? 0 : error_us;
+    portEXIT_CRITICAL(&lock);
+
+    status.t1 = ping.timestamp;
+    status.t2 = local_us;
+    status.t3 = master_us;
+    sealPacket((uint8_t*)&status, sizeof(status));
+    sendToHost((uint8_t*)&status, sizeof(status));
+}
+
+void TimeSync::update(uint32_t now_ms) {
+    if (role == TIME_SYNC_OFF) return;
+    uint8_t node_id = espNowManager.getNodeId();
+
+    portENTER_CRITICAL(&lock);
+    bool master_alive = master_known && now_ms - master_seen_ms < TIME_SYNC_MASTER_TIMEOUT_MS;
+    bool lower_master = master_alive && master_id < node_id;
+    bool became_master = false;
+    bool stepped_down = false;
+    if (role == TIME_SYNC_CANDIDATE) {
+        // Listen for a full timeout before claiming the role
+        if (!is_master && !lower_master && now_ms - enabled_ms >= TIME_SYNC_MASTER_TIMEOUT_MS) {
+            is_master = true;
+            became_master = true;
+            resetFilter();
+        } else if (is_master && lower_master) {
+            is_master = false;
+            stepped_down = true;
+        }
+    }
+    bool master = is_master;
+    bool full = sample_count >= TIME_SYNC_SAMPLES;
+    uint8_t mac[6];
+    memcpy(mac, master_mac, 6);
+    portEXIT_CRITICAL(&lock);
+
+    if (became_master || stepped_down) {
+        stats.time.is_master = master;
+        stats.time.master_changes++;
+        Serial.printf("Time sync: %s master\n", master ? "became" : "stepped down as");
+    }
+
+    if (master) {
+        if (now_ms - last_beacon_ms >= TIME_SYNC_BEACON_INTERVAL_MS) {
+            TimeSyncPacket beacon;
+            initPacket(beacon, TIME_SYNC_BEACON);
+            beacon.master_id = node_id;
+            beacon.flags = TIME_SYNC_FLAG_MASTER | TIME_SYNC_FLAG_SYNCED;
+            beacon.t3 = esp_timer_get_time();
+            sealPacket((uint8_t*)&beacon, sizeof(beacon));
+            if (espNowManager.sendPacket((const uint8_t*)&beacon, sizeof(beacon))) {
+                stats.time.beacons_sent++;
+            }
+            last_beacon_ms = now_ms;
+        }
+        return;
+    }
+
+    // Without a master the last estimate keeps running on its drift
+    if (!master_alive) return;
+
+    uint32_t interval = full ? TIME_SYNC_REQUEST_INTERVAL_MS : TIME_SYNC_FAST_INTERVAL_MS;
+    if (now_ms - last_request_ms >= interval) {
+        TimeSyncPacket request;
+        initPacket(request, TIME_SYNC_REQUEST);
+        request.master_id = stats.time.master_id;
+        int64_t t1 = esp_timer_get_time();
+        request.t1 = t1;
+        sealPacket((uint8_t*)&request, sizeof(request));
+
+        // Set before sending, the response may arrive before sendUnicast returns
+        portENTER_CRITICAL(&lock);
+        pending_t1 = t1;
+        portEXIT_CRITICAL(&lock);
+        if (espNowManager.sendUnicast(mac, (const uint8_t*)&request, sizeof(request))) {
+            stats.time.requests_sent++;
+        }
+        last_request_ms = now_ms;
+    }
+}
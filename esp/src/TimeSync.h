@@ -0,0 +1,82 @@
+#ifndef TIME_SYNC_H
+#define TIME_SYNC_H
+
+#include <Arduino.h>
+#include "Packet.h"
+
+#define TIME_SYNC_BEACON_INTERVAL_MS 1000
+#define TIME_SYNC_MASTER_TIMEOUT_MS 3500      // No beacon for this long: the master is gone
+#define TIME_SYNC_REQUEST_INTERVAL_MS 1000
+#define TIME_SYNC_FAST_INTERVAL_MS 100        // Until the sample filter is full
+#define TIME_SYNC_SAMPLES 8                   // Exchanges kept, the one with the shortest round trip wins
+#define TIME_SYNC_MAX_DELAY_US 20000          // Slower exchanges say little about the offset
+#define TIME_SYNC_DRIFT_SPAN_US 10000000LL    // Best samples this far apart give a drift measurement
+#define TIME_SYNC_MAX_DRIFT_PPB 500000        // 500 ppm, far beyond any crystal
+
+struct TimeSyncSample {
+    int64_t offset_us;  // Master minus local
+    int64_t delay_us;   // Round trip minus the master's turnaround
+    int64_t local_us;   // When it was taken
+};
+
+// Clock synchronization against one master bridge. Every bridge with the
+// role on keeps an offset and drift estimate of its esp_timer clock
+// against the master's, from four-timestamp exchanges filtered by shortest
+// round trip (as NTP's clock filter does): queueing only ever adds delay,
+// so the fastest exchange has the least asymmetry. Candidates elect the
+// lowest drone_id as master. Exchanges are answered and completed in the
+// receive callback so the timestamps are taken as close to the radio as
+// the Arduino stack allows.
+class TimeSync {
+public:
+    void setRole(uint8_t role);
+
+    // Air side, from the ESP-NOW receive callback; rx_us is the arrival time.
+    // Only direct frames may elect a master, its MAC is needed for unicast.
+    void handleAir(const uint8_t* mac, uint8_t src_id, bool direct, const TimeSyncPacket& packet, int64_t rx_us);
+
+    // Host PING: answered at once with a STATUS carrying the synchronized clock
+    void handleHostPing(const PingPacket& ping);
+
+    // Election, beacons and requests, called from loop()
+    void update(uint32_t now_ms);
+
+    // Master time for a local esp_timer time; false (and local time) while unsynchronized
+    bool toMasterTime(int64_t local_us, int64_t& master_us);
+
+private:
+    void initPacket(TimeSyncPacket& packet, uint8_t op);
+    void resetFilter();
+    void addSample(const TimeSyncSample& sample);
+    void followMaster(uint8_t id, const uint8_t* mac, uint32_t now_ms);
+
+    portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+    uint8_t role = TIME_SYNC_OFF;
+    bool is_master = false;
+    uint32_t enabled_ms = 0;
+    uint32_t last_beacon_ms = 0;
+    uint32_t last_request_ms = 0;
+
+    // Master heard most recently, from its beacons
+    bool master_known = false;
+    uint8_t master_id = 0;
+    uint8_t master_mac[6];
+    uint32_t master_seen_ms = 0;
+    int64_t pending_t1 = 0;  // Send time of the outstanding request
+
+    TimeSyncSample samples[TIME_SYNC_SAMPLES];
+    uint8_t sample_count = 0;
+    uint8_t sample_next = 0;
+
+    // master = local + offset + (local - ref_local) * drift / 1e9
+    bool synced = false;
+    int64_t offset_us = 0;
+    int64_t ref_local_us = 0;
+    int32_t drift_ppb = 0;
+    uint16_t error_us = 0;
+    bool drift_valid = false;
+    bool anchor_valid = false;
+    TimeSyncSample anchor;  // Earlier best sample the drift is measured from
+};
+
+#endif // TIME_SYNC_H
@@ -0,0 +1,32 @@
+#include "TxJitter.h"
+
+void TxJitter::setWindow(uint16_t window) {
+    window_ms = window > TX_JITTER_MAX_WINDOW_MS ? TX_JITTER_MAX_WINDOW_MS : window;
+    exponent = 0;
+    sent_run = 0;
+}
+
+uint32_t TxJitter::delayMs(uint32_t random) const {
+    if (!enabled()) return 0;
+    uint32_t window = (uint32_t)window_ms << exponent;
+    if (window > TX_BACKOFF_MAX_MS) {
+        window = TX_BACKOFF_MAX_MS;
+    }
+    return random % (window + 1);
+}
+
+void TxJitter::onBusy() {
+    if (!enabled()) return;
+    sent_run = 0;
+    if (exponent < TX_BACKOFF_MAX_EXPONENT) {
+        exponent++;
+    }
+}
+
+void TxJitter::onSent() {
+    if (!enabled() || exponent == 0) return;
+    if (++sent_run >= TX_BACKOFF_DECAY_SENDS) {
+        sent_run = 0;
+        exponent--;
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef TX_JITTER_H
+#define TX_JITTER_H
+
+#include <stdint.h>
+
+#define TX_JITTER_MAX_WINDOW_MS 50
+#define TX_BACKOFF_MAX_EXPONENT 3     // The window doubles at most this often
+#define TX_BACKOFF_MAX_MS 200         // Upper bound of any delay, backoff included
+#define TX_BACKOFF_DECAY_SENDS 8      // Periodic frames sent before the window halves again
+
+// Randomized start of periodic transmissions, CSMA style. Each frame waits
+// a uniform random delay within the window, so bridges that booted together
+// drift out of phase instead of colliding on every period. A busy channel
+// doubles the window (binary exponential backoff); it halves again after
+// every TX_BACKOFF_DECAY_SENDS periodic frames sent without the channel
+// being busy. Broadcasts are never acknowledged, so a send that went out
+// says little and only the run of them shrinks the window. Plain
+// arithmetic like TdmaScheduler; the random number comes from the caller.
+class TxJitter {
+public:
+    // 0 turns jitter and backoff off
+    void setWindow(uint16_t window_ms);
+    uint16_t getWindow() const { return window_ms; }
+    bool enabled() const { return window_ms > 0; }
+
+    // Delay for the next periodic frame, from a uniformly distributed random number
+    uint32_t delayMs(uint32_t random) const;
+
+    // A broadcast could not go out, the window doubles
+    void onBusy();
+    // A periodic frame went out
+    void onSent();
+    uint8_t getBackoffExponent() const { return exponent; }
+
+private:
+    uint16_t window_ms = 0;
+    uint8_t exponent = 0;
+    uint8_t sent_run = 0;  // Periodic frames sent since the last change of exponent
+};
+
+#endif // TX_JITTER_H
@@ -0,0 +1,45 @@
+#include "TxPowerController.h"
+
+static int8_t clampPower(int v, int8_t lo, int8_t hi) {
+    return v < lo ? lo : (v > hi ? hi : (int8_t)v);
+}
+
+void TxPowerController::configure(int8_t min, int8_t max, int8_t start) {
+    good_periods = 0;
+    if (min <= 0) {
+        min_dbm = 0;
+        return;
+    }
+    min_dbm = clampPower(min, TX_POWER_MIN_DBM, TX_POWER_MAX_DBM);
+    max_dbm = clampPower(max, min_dbm, TX_POWER_MAX_DBM);
+    power_dbm = clampPower(start, min_dbm, max_dbm);
+}
+
+int8_t TxPowerController::evaluate(const LinkQuality& quality) {
+    if (!enabled()) return power_dbm;
+
+    // Nobody heard: we may be the ones who cannot be heard, search upwards
+    if (quality.peers == 0) {
+        good_periods = 0;
+        power_dbm = clampPower(power_dbm + TX_POWER_STEP_UP_DB, min_dbm, max_dbm);
+        return power_dbm;
+    }
+
+    bool judged = quality.expected >= TX_POWER_MIN_SAMPLES;
+    bool lossy = judged && quality.lost * 100 > quality.expected * TX_POWER_LOSS_HIGH_PCT;
+    bool clean = judged && quality.lost * 100 < quality.expected * TX_POWER_LOSS_LOW_PCT;
+
+    if (lossy || quality.min_rssi < TX_POWER_RSSI_LOW_DBM) {
+        good_periods = 0;
+        power_dbm = clampPower(power_dbm + TX_POWER_STEP_UP_DB, min_dbm, max_dbm);
+    } else if (clean && quality.min_rssi > TX_POWER_RSSI_HIGH_DBM) {
+        if (++good_periods >= TX_POWER_HOLD_PERIODS) {
+            good_periods = 0;
+            power_dbm = clampPower(power_dbm - TX_POWER_STEP_DOWN_DB, min_dbm, max_dbm);
+        }
+    } else {
+        // Inside the hysteresis band: hold
+        good_periods = 0;
+    }
+    return power_dbm;
+}
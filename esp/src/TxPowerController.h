@@ -0,0 +1,51 @@
+#ifndef TX_POWER_CONTROLLER_H
+#define TX_POWER_CONTROLLER_H
+
+#include <stdint.h>
+
+#define TX_POWER_MIN_DBM 2            // esp_wifi_set_max_tx_power() accepts 8..84 quarter dBm
+#define TX_POWER_MAX_DBM 20
+#define TX_POWER_PERIOD_MS 2000       // One decision per period
+#define TX_POWER_STEP_UP_DB 3
+#define TX_POWER_STEP_DOWN_DB 1
+#define TX_POWER_HOLD_PERIODS 3       // Good periods in a row before each step down
+#define TX_POWER_MIN_SAMPLES 20       // Frames per period below which loss is not judged
+#define TX_POWER_LOSS_HIGH_PCT 5      // More loss than this raises power
+#define TX_POWER_LOSS_LOW_PCT 1       // Less loss than this may lower it
+#define TX_POWER_RSSI_LOW_DBM -82     // Weakest peer below this raises power
+#define TX_POWER_RSSI_HIGH_DBM -70    // Weakest peer above this may lower it
+
+// What one period looked like across all peers heard directly
+struct LinkQuality {
+    uint8_t peers = 0;
+    int8_t min_rssi = 0;      // Weakest peer's average, dBm; valid with peers > 0
+    uint32_t expected = 0;    // Frames sent or due to be received
+    uint32_t lost = 0;
+};
+
+// Closed-loop TX power: raise quickly when the weakest link degrades or
+// loss grows, step down slowly while every peer is strong and loss stays
+// low, always within [min, max]. Quieter bridges interfere less with
+// co-located swarms and let the channel be reused further away. Plain
+// arithmetic like TdmaScheduler, so the native link simulation runs the
+// same code.
+class TxPowerController {
+public:
+    // Bounds in dBm; start_dbm is where control begins, min_dbm = 0 turns control off
+    void configure(int8_t min_dbm, int8_t max_dbm, int8_t start_dbm);
+    bool enabled() const { return min_dbm > 0; }
+    int8_t getPower() const { return power_dbm; }
+    int8_t getMin() const { return min_dbm; }
+    int8_t getMax() const { return max_dbm; }
+
+    // Once per TX_POWER_PERIOD_MS; returns the power for the next period
+    int8_t evaluate(const LinkQuality& quality);
+
+private:
+    int8_t min_dbm = 0;
+    int8_t max_dbm = TX_POWER_MAX_DBM;
+    int8_t power_dbm = TX_POWER_MAX_DBM;
+    uint8_t good_periods = 0;
+};
+
+#endif // TX_POWER_CONTROLLER_H
@@ -1,4 +1,5 @@
 #include "crc_utils.h"
+#include <string.h>
 
 // CRC16 calculation function (matching controller)
 uint16_t calculateCRC16(const uint8_t* data, size_t length) {
@@ -16,4 +17,11 @@ uint16_t calculateCRC16(const uint8_t* data, size_t length) {
         }
     }
     return crc;
-} 
\ No newline at end of file
+}
+
+void sealPacket(uint8_t* data, size_t length) {
+    if (!data || length < 3) return;
+    
+    uint16_t crc = calculateCRC16(data, length);
+    memcpy(data + length - 2, &crc, sizeof(crc));
+}
@@ -7,4 +7,7 @@
 // CRC16 calculation function (matching controller)
 uint16_t calculateCRC16(const uint8_t* data, size_t length);
 
+// Compute CRC over data[0..length-2) and store it in the last two bytes
+void sealPacket(uint8_t* data, size_t length);
+
 #endif // CRC_UTILS_H 
\ No newline at end of file
@@ -5,6 +5,16 @@
 #include "PacketDeserializer.h"
 #include "Statistics.h"
 #include "ESPNowManager.h"
+#include "SwarmTable.h"
+#include "BulkTransfer.h"
+#include "StreamManager.h"
+#include "PeerTable.h"
+#include "LinkMonitor.h"
+#include "TimeSync.h"
+#include "RateLimiter.h"
+#include "ChannelSwitch.h"
+#include "RemoteStats.h"
+#include "ControlWorker.h"
 #include "ConfigManager.h"
 #include "OTAManager.h"
 
@@ -44,6 +54,16 @@ extern bool wifi_connected;
 Statistics stats;
 PacketDeserializer deserializer;
 ESPNowManager espNowManager;
+SwarmTable swarmTable;
+BulkTransfer bulkTransfer;
+StreamManager streamManager;
+PeerTable peerTable;
+LinkMonitor linkMonitor;
+TimeSync timeSync;
+RateLimiter rateLimiter;
+ChannelSwitch channelSwitch;
+RemoteStats remoteStats;
+ControlWorker controlWorker;
 
 // System state
 bool system_initialized = false;
@@ -132,6 +152,11 @@ void setup() {
     // Load configuration (with improved error handling)
     loadConfiguration();
     
+    // Config saves, OTA scheduling and restarts run in the background
+    if (!controlWorker.begin()) {
+        Serial.println("WARNING: Control worker not running, settings will not be saved");
+    }
+    
     // Initialize UART with production settings
     Serial.println("Initializing UART1...");
     Serial1.setRxBufferSize(4096);
@@ -211,6 +236,28 @@ void loop() {
     // Process incoming UART data from ROS
     deserializer.processReceivedData();
     
+    // Swarm table expiry and periodic snapshots to the host
+    swarmTable.update(millis());
+    
+    // Command retransmissions and delivery reports
+    espNowManager.update(millis());
+    
+    // Hand reassembled bulk blobs to the host
+    bulkTransfer.update(millis());
+    
+    // Stream segments, retransmissions and in-order delivery
+    streamManager.update(millis());
+    
+    // Periodic per-peer delivery reports to the host
+    linkMonitor.update(millis());
+    
+    // Master election, beacons and clock exchanges
+    timeSync.update(millis());
+    
+    // Announced channel changes
+    channelSwitch.update(millis());
+    remoteStats.update(millis());
+    
 #ifdef TEST_MODE
     // Send test telemetry packets
     sendTestTelemetry();
@@ -226,6 +273,7 @@ void loop() {
     
     if (now - last_stats >= 10000) { // Every 10 seconds
         stats.print();
+        linkMonitor.print();
 #ifdef TEST_MODE
         Serial.printf("TEST: Total test packets sent: %lu\n", test_packets_sent);
         int8_t power = 0;
@@ -0,0 +1,155 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "FrameFilter.h"
+
+// Frames laid out as on the wire: 5-byte header (preamble, payload size,
+// packet type, network id), payload, CRC
+#define TELEMETRY_TYPE 1
+#define STATUS_TYPE 3
+#define FRAME_DRONE_ID_OFFSET 5
+#define STATUS_ERROR_FLAGS_OFFSET 9  // drone_id, status_code, battery_mv, error_flags
+
+#define BENCH_FRAMES 200000
+
+static size_t makeFrame(uint8_t* frame, uint8_t type, uint8_t drone_id, uint16_t error_flags) {
+    size_t len = type == STATUS_TYPE ? 5 + 6 + 2 : 5 + 25 + 2;
+    memset(frame, 0, len);
+    frame[0] = 0x55;
+    frame[1] = 0xAA;
+    frame[2] = (uint8_t)(len - 5);
+    frame[3] = type;
+    frame[4] = 0x12;
+    frame[FRAME_DRONE_ID_OFFSET] = drone_id;
+    if (type == STATUS_TYPE) {
+        frame[STATUS_ERROR_FLAGS_OFFSET] = error_flags & 0xFF;
+        frame[STATUS_ERROR_FLAGS_OFFSET + 1] = error_flags >> 8;
+    }
+    return len;
+}
+
+static FilterRule makeRule(uint8_t type, uint8_t op, uint8_t action, uint8_t offset = 0, uint8_t width = 1,
+                           uint32_t lo = 0, uint32_t hi = 0) {
+    FilterRule rule;
+    rule.packet_type = type;
+    rule.op = op;
+    rule.action = action;
+    rule.offset = offset;
+    rule.width = width;
+    rule.lo = lo;
+    rule.hi = hi;
+    return rule;
+}
+
+void test_empty_filter_passes() {
+    FrameFilter filter;
+    uint8_t frame[64];
+    size_t len = makeFrame(frame, TELEMETRY_TYPE, 3, 0);
+    TEST_ASSERT_FALSE(filter.active());
+    TEST_ASSERT_TRUE(filter.pass(frame, len));
+}
+
+void test_telemetry_from_range_only() {
+    FrameFilter filter;
+    TEST_ASSERT_TRUE(filter.setRule(0, makeRule(TELEMETRY_TYPE, FILTER_RANGE, FILTER_PASS, FRAME_DRONE_ID_OFFSET, 1, 1, 8)));
+    TEST_ASSERT_TRUE(filter.setRule(1, makeRule(TELEMETRY_TYPE, FILTER_ALWAYS, FILTER_DROP)));
+
+    uint8_t frame[64];
+    for (uint8_t id = 0; id < 12; id++) {
+        size_t len = makeFrame(frame, TELEMETRY_TYPE, id, 0);
+        TEST_ASSERT_EQUAL(id >= 1 && id <= 8, filter.pass(frame, len));
+    }
+    TEST_ASSERT_EQUAL(8, filter.getHits(0));
+    TEST_ASSERT_EQUAL(4, filter.getHits(1));
+
+    // Other types are not touched
+    size_t len = makeFrame(frame, STATUS_TYPE, 20, 0);
+    TEST_ASSERT_TRUE(filter.pass(frame, len));
+    TEST_ASSERT_EQUAL(1, filter.getDefaultHits());
+}
+
+void test_status_only_with_errors() {
+    FrameFilter filter;
+    filter.setRule(0, makeRule(STATUS_TYPE, FILTER_NE, FILTER_PASS, STATUS_ERROR_FLAGS_OFFSET, 2, 0));
+    filter.setRule(1, makeRule(STATUS_TYPE, FILTER_ALWAYS, FILTER_DROP));
+
+    uint8_t frame[64];
+    size_t len = makeFrame(frame, STATUS_TYPE, 4, 0);
+    TEST_ASSERT_FALSE(filter.pass(frame, len));
+    len = makeFrame(frame, STATUS_TYPE, 4, 0x0100);
+    TEST_ASSERT_TRUE(filter.pass(frame, len));
+
+    // Mask on the same field
+    filter.setRule(0, makeRule(STATUS_TYPE, FILTER_MASK, FILTER_PASS, STATUS_ERROR_FLAGS_OFFSET, 2, 0x0002));
+    TEST_ASSERT_FALSE(filter.pass(frame, len));
+    len = makeFrame(frame, STATUS_TYPE, 4, 0x0003);
+    TEST_ASSERT_TRUE(filter.pass(frame, len));
+}
+
+void test_field_past_the_payload_never_matches() {
+    FrameFilter filter;
+    // A status frame is 13 bytes, nothing to read at offset 30
+    filter.setRule(0, makeRule(FILTER_ANY_TYPE, FILTER_EQ, FILTER_DROP, 30, 4, 0));
+    uint8_t frame[64];
+    size_t len = makeFrame(frame, STATUS_TYPE, 4, 0);
+    TEST_ASSERT_TRUE(filter.pass(frame, len));
+    TEST_ASSERT_EQUAL(0, filter.getHits(0));
+}
+
+void test_rule_validation() {
+    FrameFilter filter;
+    TEST_ASSERT_FALSE(filter.setRule(FILTER_MAX_RULES, makeRule(0, FILTER_ALWAYS, FILTER_DROP)));
+    TEST_ASSERT_FALSE(filter.setRule(0, makeRule(0, FILTER_MASK + 1, FILTER_DROP)));
+    TEST_ASSERT_FALSE(filter.setRule(0, makeRule(0, FILTER_EQ, FILTER_DROP, 5, 3)));
+    TEST_ASSERT_FALSE(filter.setRule(0, makeRule(0, FILTER_EQ, FILTER_DROP + 1)));
+    TEST_ASSERT_FALSE(filter.active());
+
+    filter.setRule(5, makeRule(0, FILTER_ALWAYS, FILTER_DROP));
+    TEST_ASSERT_TRUE(filter.active());
+    filter.setRule(5, makeRule(0, FILTER_OFF, FILTER_PASS));
+    TEST_ASSERT_FALSE(filter.active());
+
+    filter.setRule(2, makeRule(0, FILTER_ALWAYS, FILTER_DROP));
+    filter.clear();
+    TEST_ASSERT_FALSE(filter.active());
+}
+
+// Cost per frame with n rules that all miss, the worst case of a table walk
+static double benchmark(uint8_t rules) {
+    FrameFilter filter;
+    for (uint8_t i = 0; i < rules; i++) {
+        filter.setRule(i, makeRule(TELEMETRY_TYPE, FILTER_RANGE, FILTER_DROP, FRAME_DRONE_ID_OFFSET, 1, 100 + i, 100 + i));
+    }
+    uint8_t frame[64];
+    size_t len = makeFrame(frame, TELEMETRY_TYPE, 1, 0);
+
+    volatile uint32_t passed = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < BENCH_FRAMES; n++) {
+        frame[FRAME_DRONE_ID_OFFSET] = n & 0x3F;
+        passed += filter.pass(frame, len);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    TEST_ASSERT_EQUAL(BENCH_FRAMES, passed);
+    return std::chrono::duration<double, std::nano>(elapsed).count() / BENCH_FRAMES;
+}
+
+void test_filter_cost() {
+    printf("\n  rules  ns per frame (host CPU)\n");
+    const uint8_t counts[] = {1, 4, 8, FILTER_MAX_RULES};
+    for (uint8_t rules : counts) {
+        printf("  %5d  %8.1f\n", rules, benchmark(rules));
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_filter_passes);
+    RUN_TEST(test_telemetry_from_range_only);
+    RUN_TEST(test_status_only_with_errors);
+    RUN_TEST(test_field_past_the_payload_never_matches);
+    RUN_TEST(test_rule_validation);
+    RUN_TEST(test_filter_cost);
+    return UNITY_END();
+}
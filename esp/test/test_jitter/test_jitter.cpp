@@ -0,0 +1,149 @@
+#include <unity.h>
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+#include "TxJitter.h"
+
+// Channel simulator for bridges that booted together: N bridges forward
+// 20 Hz telemetry whose phases all lie within a few milliseconds. Without
+// jitter every period collides the same way; with jitter each frame waits
+// a random delay within the window. Frames whose 1 ms airtime overlaps
+// another frame are lost (no carrier sense, no feedback to the backoff).
+
+#define SIM_DURATION_US 10000000LL
+#define SIM_TELEMETRY_PERIOD_US 50000
+#define SIM_BOOT_SPREAD_US 2000
+#define SIM_LOOP_US 1000
+#define SIM_LOOP_JITTER_US 200
+#define SIM_AIRTIME_US 1000
+
+static uint32_t rng_state;
+
+static uint32_t rnd(uint32_t range) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state % range;
+}
+
+// Frames delivered per frame offered
+static float deliveryRatio(int drones, uint16_t window_ms) {
+    rng_state = 88675123u + drones * 31 + window_ms;
+    std::vector<int64_t> starts;
+    int offered = 0;
+    for (int id = 1; id <= drones; id++) {
+        TxJitter jitter;
+        jitter.setWindow(window_ms);
+        int64_t next_telemetry = rnd(SIM_BOOT_SPREAD_US);
+        bool held = false;
+        int64_t due = 0;
+        for (int64_t t = rnd(SIM_LOOP_US); t < SIM_DURATION_US; t += SIM_LOOP_US + rnd(SIM_LOOP_JITTER_US)) {
+            while (next_telemetry <= t) {
+                // Same path as ESPNowManager::sendTelemetryPacket: a replacement keeps the release time
+                if (!held) {
+                    due = t + (int64_t)jitter.delayMs(rnd(1u << 30)) * 1000;
+                }
+                held = true;
+                offered++;
+                next_telemetry += SIM_TELEMETRY_PERIOD_US;
+            }
+            if (held && t >= due) {
+                starts.push_back(t);
+                held = false;
+            }
+        }
+    }
+
+    std::sort(starts.begin(), starts.end());
+    int delivered = 0;
+    for (size_t i = 0; i < starts.size(); i++) {
+        bool overlap = (i > 0 && starts[i] - starts[i - 1] < SIM_AIRTIME_US) ||
+                       (i + 1 < starts.size() && starts[i + 1] - starts[i] < SIM_AIRTIME_US);
+        if (!overlap) delivered++;
+    }
+    return (float)delivered / offered;
+}
+
+void test_jitter_window() {
+    TxJitter jitter;
+    TEST_ASSERT_FALSE(jitter.enabled());
+    TEST_ASSERT_EQUAL(0, jitter.delayMs(12345));
+
+    jitter.setWindow(TX_JITTER_MAX_WINDOW_MS + 10);
+    TEST_ASSERT_EQUAL(TX_JITTER_MAX_WINDOW_MS, jitter.getWindow());
+
+    jitter.setWindow(10);
+    TEST_ASSERT_EQUAL(0, jitter.delayMs(0));
+    TEST_ASSERT_EQUAL(10, jitter.delayMs(10));
+    TEST_ASSERT_EQUAL(0, jitter.delayMs(11));
+}
+
+void test_exponential_backoff() {
+    TxJitter jitter;
+    jitter.setWindow(10);
+
+    // Each busy channel doubles the window, up to the limits
+    jitter.onBusy();
+    TEST_ASSERT_EQUAL(1, jitter.getBackoffExponent());
+    TEST_ASSERT_EQUAL(20, jitter.delayMs(20));
+    for (int i = 0; i < 10; i++) jitter.onBusy();
+    TEST_ASSERT_EQUAL(TX_BACKOFF_MAX_EXPONENT, jitter.getBackoffExponent());
+    TEST_ASSERT_EQUAL(80, jitter.delayMs(80));
+
+    jitter.setWindow(40);
+    for (int i = 0; i < 10; i++) jitter.onBusy();
+    TEST_ASSERT_EQUAL(TX_BACKOFF_MAX_MS, jitter.delayMs(TX_BACKOFF_MAX_MS));
+    TEST_ASSERT_EQUAL(0, jitter.delayMs(TX_BACKOFF_MAX_MS + 1));
+}
+
+void test_backoff_decay() {
+    TxJitter jitter;
+    jitter.setWindow(10);
+    jitter.onBusy();
+    jitter.onBusy();
+
+    // A single send that went out does not undo the backoff
+    jitter.onSent();
+    TEST_ASSERT_EQUAL(2, jitter.getBackoffExponent());
+
+    // A busy channel in the middle of a run starts it over
+    for (int i = 0; i < TX_BACKOFF_DECAY_SENDS - 2; i++) jitter.onSent();
+    jitter.onBusy();
+    TEST_ASSERT_EQUAL(3, jitter.getBackoffExponent());
+
+    // Each full run halves the window
+    for (int i = 0; i < TX_BACKOFF_DECAY_SENDS; i++) jitter.onSent();
+    TEST_ASSERT_EQUAL(2, jitter.getBackoffExponent());
+    for (int i = 0; i < 2 * TX_BACKOFF_DECAY_SENDS; i++) jitter.onSent();
+    TEST_ASSERT_EQUAL(0, jitter.getBackoffExponent());
+    jitter.onSent();
+    TEST_ASSERT_EQUAL(0, jitter.getBackoffExponent());
+}
+
+void test_delivery_by_window() {
+    const int sizes[] = {10, 20, 40};
+    const uint16_t windows[] = {0, 5, 10, 20, 50};
+    printf("\n  N  delivery ratio by jitter window (ms)\n      ");
+    for (uint16_t w : windows) printf("%8u", w);
+    printf("\n");
+    for (int drones : sizes) {
+        printf("%3d   ", drones);
+        for (uint16_t w : windows) printf("%8.3f", deliveryRatio(drones, w));
+        printf("\n");
+    }
+
+    // Phase-locked bridges lose most frames; a window of a few frame times breaks the lock
+    TEST_ASSERT_TRUE(deliveryRatio(10, 0) < 0.5f);
+    TEST_ASSERT_TRUE(deliveryRatio(10, 20) > 0.4f);
+    TEST_ASSERT_TRUE(deliveryRatio(20, 20) > deliveryRatio(20, 0));
+    TEST_ASSERT_TRUE(deliveryRatio(40, 20) > deliveryRatio(40, 0));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_jitter_window);
+    RUN_TEST(test_exponential_backoff);
+    RUN_TEST(test_backoff_decay);
+    RUN_TEST(test_delivery_by_window);
+    return UNITY_END();
+}
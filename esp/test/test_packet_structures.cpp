@@ -15,7 +15,22 @@ enum PacketType {
     PING = 7,
     ACK = 8,
     CUSTOM_MESSAGE = 9,
-    OTA_CONFIG = 10
+    OTA_CONFIG = 10,
+    BRIDGE_CONTROL = 11,
+    SWARM_SNAPSHOT = 12,
+    CONFLICT_ALERT = 13,
+    DELIVERY_REPORT = 14,
+    STREAM_DATA = 15,
+    STREAM_ACK = 16,
+    STREAM_CONTROL = 17,
+    FEC_PARITY = 18,
+    LINK_STATS = 19,
+    TIME_SYNC = 20,
+    RX_META = 21,
+    CHANNEL_SWITCH = 22,
+    FILTER_RULE = 23,
+    NEIGHBOR = 24,
+    STATS = 25
 };
 
 struct PacketHeader {
@@ -65,6 +80,242 @@ struct OtaConfigPacket {
     uint16_t crc;
 } __attribute__((packed));
 
+struct BridgeControlPacket {
+    PacketHeader header;
+    uint8_t command;
+    uint8_t arg;
+    int32_t value;
+    uint16_t crc;
+} __attribute__((packed));
+
+#define SNAPSHOT_ENTRIES_PER_PACKET 7
+
+struct SnapshotEntry {
+    uint8_t drone_id;
+    uint8_t status_code;
+    uint16_t age_ms;
+    int16_t x_cm;
+    int16_t y_cm;
+    int16_t z_cm;
+    int16_t vx_cms;
+    int16_t vy_cms;
+    int16_t vz_cms;
+} __attribute__((packed));
+
+struct SwarmSnapshotPacket {
+    PacketHeader header;
+    uint32_t timestamp_ms;
+    uint8_t snapshot_id;
+    uint8_t flags;
+    uint8_t part;
+    uint8_t count;
+    SnapshotEntry entries[SNAPSHOT_ENTRIES_PER_PACKET];
+    uint16_t crc;
+} __attribute__((packed));
+
+struct AirTrailer {
+    uint8_t src_id;
+    uint8_t flags;
+    uint16_t seq;
+} __attribute__((packed));
+
+#define BULK_AIR_FRAGMENT_SIZE 224
+
+struct BulkHeader {
+    uint8_t src_id;
+    uint8_t blob_id;
+    uint8_t flags;
+    uint16_t total_len;
+    uint16_t offset;
+} __attribute__((packed));
+
+struct BulkDataPacket {
+    PacketHeader header;
+    BulkHeader bulk;
+    uint8_t data[BULK_AIR_FRAGMENT_SIZE];
+    uint16_t crc;
+} __attribute__((packed));
+
+#define STREAM_SEGMENT_SIZE 200
+
+struct StreamHeader {
+    uint8_t stream_id;
+    uint8_t flags;
+    uint16_t seq;
+} __attribute__((packed));
+
+struct StreamDataPacket {
+    PacketHeader header;
+    StreamHeader stream;
+    uint8_t data[STREAM_SEGMENT_SIZE];
+    uint16_t crc;
+} __attribute__((packed));
+
+struct StreamAckPacket {
+    PacketHeader header;
+    uint8_t stream_id;
+    uint8_t reserved;
+    uint16_t cum_seq;
+    uint32_t sack_mask;
+    uint16_t window_end;
+    uint16_t crc;
+} __attribute__((packed));
+
+struct StreamControlPacket {
+    PacketHeader header;
+    uint8_t op;
+    uint8_t stream_id;
+    uint8_t peer_id;
+    uint8_t state;
+    uint16_t credit;
+    uint32_t bytes;
+    uint16_t crc;
+} __attribute__((packed));
+
+#define FEC_MAX_FRAME_SIZE 160
+
+struct FecParityPacket {
+    PacketHeader header;
+    uint16_t first_seq;
+    uint16_t member_mask;
+    uint8_t parity[FEC_MAX_FRAME_SIZE];
+    uint16_t crc;
+} __attribute__((packed));
+
+#define LINK_STATS_ENTRIES_PER_PACKET 4
+
+struct LinkStatsEntry {
+    uint8_t drone_id;
+    uint32_t expected;
+    uint32_t received;
+    uint32_t lost;
+    uint32_t duplicates;
+    uint32_t reordered;
+    uint16_t rtt_p50;
+    uint16_t rtt_p90;
+    uint16_t rtt_p99;
+} __attribute__((packed));
+
+struct LinkStatsPacket {
+    PacketHeader header;
+    uint32_t timestamp_ms;
+    uint8_t report_id;
+    uint8_t flags;
+    uint8_t part;
+    uint8_t count;
+    LinkStatsEntry entries[LINK_STATS_ENTRIES_PER_PACKET];
+    uint16_t crc;
+} __attribute__((packed));
+
+struct TimeSyncPacket {
+    PacketHeader header;
+    uint8_t op;
+    uint8_t master_id;
+    uint8_t flags;
+    int32_t drift_ppb;
+    uint16_t error_us;
+    uint64_t t1;
+    uint64_t t2;
+    uint64_t t3;
+    uint16_t crc;
+} __attribute__((packed));
+
+struct RxMetaPacket {
+    PacketHeader header;
+    int8_t rssi;
+    int8_t noise_floor;
+    uint8_t flags;
+    uint8_t src_id;
+    uint8_t mac[6];
+    uint64_t rx_us;
+    uint16_t crc;
+} __attribute__((packed));
+
+struct ChannelSwitchPacket {
+    PacketHeader header;
+    uint8_t op;
+    uint8_t channel;
+    uint8_t status;
+    uint16_t switch_id;
+    uint64_t switch_at_us;
+    uint32_t countdown_us;
+    uint32_t first_frame_us;
+    uint16_t crc;
+} __attribute__((packed));
+
+struct FilterRulePacket {
+    PacketHeader header;
+    uint8_t index;
+    uint8_t op;
+    uint8_t action;
+    uint8_t packet_type;
+    uint8_t offset;
+    uint8_t width;
+    uint32_t lo;
+    uint32_t hi;
+    uint32_t hits;
+    uint16_t crc;
+} __attribute__((packed));
+
+struct NeighborPacket {
+    PacketHeader header;
+    uint8_t event;
+    uint8_t drone_id;
+    uint8_t status_code;
+    int8_t rssi;
+    uint8_t flags;
+    uint8_t query_id;
+    uint16_t rate_dpps;
+    uint16_t age_ms;
+    uint16_t crc;
+} __attribute__((packed));
+
+struct StatsPacket {
+    PacketHeader header;
+    uint8_t op;
+    uint8_t target_id;
+    uint8_t src_id;
+    uint8_t query_id;
+    uint32_t uptime_s;
+    uint32_t air_sent;
+    uint32_t air_received;
+    uint32_t air_corrupted;
+    uint32_t send_failures;
+    uint32_t host_sent;
+    uint32_t host_received;
+    uint32_t policed;
+    uint32_t free_heap;
+    uint16_t air_tx_pps;
+    uint16_t air_rx_pps;
+    uint8_t neighbors;
+    int8_t tx_power;
+    uint8_t channel;
+    uint8_t time_master;
+    uint16_t crc;
+} __attribute__((packed));
+
+struct DeliveryReportPacket {
+    PacketHeader header;
+    uint8_t command_id;
+    uint8_t target_id;
+    uint8_t result;
+    uint8_t retransmissions;
+    uint8_t expected;
+    uint8_t acked;
+    uint16_t latency_ms;
+    uint16_t crc;
+} __attribute__((packed));
+
+struct ConflictAlertPacket {
+    PacketHeader header;
+    uint8_t drone_id;
+    uint8_t severity;
+    uint16_t time_to_cpa_ms;
+    uint16_t min_distance_cm;
+    uint16_t distance_cm;
+    uint16_t crc;
+} __attribute__((packed));
+
 // Simple CRC16 implementation for testing
 uint16_t calculateCRC16(const uint8_t* data, size_t length) {
     uint16_t crc = 0xFFFF;
@@ -107,6 +358,21 @@ void test_packet_types() {
     TEST_ASSERT_EQUAL(8, ACK);
     TEST_ASSERT_EQUAL(9, CUSTOM_MESSAGE);
     TEST_ASSERT_EQUAL(10, OTA_CONFIG);
+    TEST_ASSERT_EQUAL(11, BRIDGE_CONTROL);
+    TEST_ASSERT_EQUAL(12, SWARM_SNAPSHOT);
+    TEST_ASSERT_EQUAL(13, CONFLICT_ALERT);
+    TEST_ASSERT_EQUAL(14, DELIVERY_REPORT);
+    TEST_ASSERT_EQUAL(15, STREAM_DATA);
+    TEST_ASSERT_EQUAL(16, STREAM_ACK);
+    TEST_ASSERT_EQUAL(17, STREAM_CONTROL);
+    TEST_ASSERT_EQUAL(18, FEC_PARITY);
+    TEST_ASSERT_EQUAL(19, LINK_STATS);
+    TEST_ASSERT_EQUAL(20, TIME_SYNC);
+    TEST_ASSERT_EQUAL(21, RX_META);
+    TEST_ASSERT_EQUAL(22, CHANNEL_SWITCH);
+    TEST_ASSERT_EQUAL(23, FILTER_RULE);
+    TEST_ASSERT_EQUAL(24, NEIGHBOR);
+    TEST_ASSERT_EQUAL(25, STATS);
 }
 
 // Test maximum payload size
@@ -172,6 +438,92 @@ void test_ota_config_packet_size_limit() {
     TEST_ASSERT_EQUAL(115, sizeof(OtaConfigPacket)); // Exact size
 }
 
+// Test swarm snapshot layout (decoded by skyros packet_codec)
+void test_reliable_command_structures() {
+    TEST_ASSERT_EQUAL(4, sizeof(AirTrailer));  // 1 + 1 + 2 = 4 bytes
+    TEST_ASSERT_EQUAL(15, sizeof(DeliveryReportPacket));  // 5 + 6 + 2 + 2 = 15 bytes
+    
+    // The largest packet plus trailer must still fit one ESP-NOW frame (250 bytes)
+    TEST_ASSERT_LESS_OR_EQUAL(250, sizeof(PacketHeader) + MAX_PAYLOAD_SIZE + sizeof(AirTrailer));
+}
+
+void test_bulk_fragment_sizes() {
+    TEST_ASSERT_EQUAL(7, sizeof(BulkHeader));  // 1 + 1 + 1 + 2 + 2 = 7 bytes
+    
+    // A full UART chunk is exactly one maximum-size packet
+    size_t uart_chunk = MAX_PAYLOAD_SIZE - sizeof(BulkHeader) - sizeof(uint16_t);
+    TEST_ASSERT_EQUAL(119, uart_chunk);
+    
+    // A full air fragment plus trailer fits one ESP-NOW frame (250 bytes)
+    TEST_ASSERT_EQUAL(238, sizeof(BulkDataPacket));  // 5 + 7 + 224 + 2 = 238 bytes
+    TEST_ASSERT_LESS_OR_EQUAL(250, sizeof(BulkDataPacket) + sizeof(AirTrailer));
+    TEST_ASSERT_LESS_OR_EQUAL(255, sizeof(BulkDataPacket) - sizeof(PacketHeader));  // payload_size is 8 bits
+}
+
+void test_stream_structures() {
+    TEST_ASSERT_EQUAL(4, sizeof(StreamHeader));          // 1 + 1 + 2 = 4 bytes
+    TEST_ASSERT_EQUAL(17, sizeof(StreamAckPacket));      // 5 + 1 + 1 + 2 + 4 + 2 + 2 = 17 bytes
+    TEST_ASSERT_EQUAL(17, sizeof(StreamControlPacket));  // 5 + 4 + 2 + 4 + 2 = 17 bytes
+    
+    // A full UART chunk is exactly one maximum-size packet
+    size_t uart_chunk = MAX_PAYLOAD_SIZE - sizeof(StreamHeader) - sizeof(uint16_t);
+    TEST_ASSERT_EQUAL(122, uart_chunk);
+    
+    // A full segment plus trailer fits one ESP-NOW frame
+    TEST_ASSERT_EQUAL(211, sizeof(StreamDataPacket));  // 5 + 4 + 200 + 2 = 211 bytes
+    TEST_ASSERT_LESS_OR_EQUAL(250, sizeof(StreamDataPacket) + sizeof(AirTrailer));
+}
+
+void test_fec_parity_size() {
+    // Parity over the largest protected frame still fits one ESP-NOW frame
+    TEST_ASSERT_EQUAL(171, sizeof(FecParityPacket));  // 5 + 2 + 2 + 160 + 2
+    TEST_ASSERT_LESS_OR_EQUAL(250, sizeof(FecParityPacket) + sizeof(AirTrailer));
+    
+    // Every UART packet is small enough to be protected
+    TEST_ASSERT_LESS_OR_EQUAL(FEC_MAX_FRAME_SIZE, sizeof(PacketHeader) + MAX_PAYLOAD_SIZE);
+}
+
+void test_link_stats_packet_size() {
+    TEST_ASSERT_EQUAL(27, sizeof(LinkStatsEntry));  // 1 + 5*4 + 3*2 = 27 bytes
+    
+    // A full report part must still fit in one UART packet
+    TEST_ASSERT_LESS_OR_EQUAL(MAX_PAYLOAD_SIZE, sizeof(LinkStatsPacket) - sizeof(PacketHeader));
+}
+
+void test_time_sync_packet_size() {
+    TEST_ASSERT_EQUAL(40, sizeof(TimeSyncPacket));  // 5 + 3 + 4 + 2 + 3*8 + 2 = 40 bytes
+}
+
+void test_rx_meta_packet_size() {
+    TEST_ASSERT_EQUAL(25, sizeof(RxMetaPacket));  // 5 + 4 + 6 + 8 + 2 = 25 bytes
+}
+
+void test_channel_switch_packet_size() {
+    TEST_ASSERT_EQUAL(28, sizeof(ChannelSwitchPacket));  // 5 + 3 + 2 + 8 + 4 + 4 + 2 = 28 bytes
+}
+
+void test_filter_rule_packet_size() {
+    TEST_ASSERT_EQUAL(25, sizeof(FilterRulePacket));  // 5 + 6 + 3*4 + 2 = 25 bytes
+}
+
+void test_neighbor_packet_size() {
+    TEST_ASSERT_EQUAL(17, sizeof(NeighborPacket));  // 5 + 6 + 2 + 2 + 2 = 17 bytes
+}
+
+void test_stats_packet_size() {
+    TEST_ASSERT_EQUAL(55, sizeof(StatsPacket));  // 5 + 4 + 9*4 + 2*2 + 4 + 2 = 55 bytes
+}
+
+void test_swarm_snapshot_packet_size() {
+    TEST_ASSERT_EQUAL(13, sizeof(BridgeControlPacket));  // 5 + 1 + 1 + 4 + 2 = 13 bytes
+    TEST_ASSERT_EQUAL(16, sizeof(SnapshotEntry));  // 1 + 1 + 2 + 6*2 = 16 bytes
+    
+    // A full snapshot part must still fit in one UART packet
+    TEST_ASSERT_LESS_OR_EQUAL(MAX_PAYLOAD_SIZE, sizeof(SwarmSnapshotPacket) - sizeof(PacketHeader));
+    TEST_ASSERT_EQUAL(127, sizeof(SwarmSnapshotPacket));  // 5 + 4 + 4 + 7*16 + 2 = 127 bytes
+    TEST_ASSERT_EQUAL(15, sizeof(ConflictAlertPacket));  // 5 + 1 + 1 + 3*2 + 2 = 15 bytes
+}
+
 // Test config flags functionality
 void test_config_flags() {
     uint8_t flags = 0;
@@ -206,6 +558,18 @@ void RUN_UNITY_TESTS() {
     RUN_TEST(test_telemetry_packet_structure);
     RUN_TEST(test_ota_config_packet_structure);
     RUN_TEST(test_ota_config_packet_size_limit);
+    RUN_TEST(test_swarm_snapshot_packet_size);
+    RUN_TEST(test_reliable_command_structures);
+    RUN_TEST(test_bulk_fragment_sizes);
+    RUN_TEST(test_stream_structures);
+    RUN_TEST(test_fec_parity_size);
+    RUN_TEST(test_link_stats_packet_size);
+    RUN_TEST(test_time_sync_packet_size);
+    RUN_TEST(test_rx_meta_packet_size);
+    RUN_TEST(test_channel_switch_packet_size);
+    RUN_TEST(test_filter_rule_packet_size);
+    RUN_TEST(test_neighbor_packet_size);
+    RUN_TEST(test_stats_packet_size);
     RUN_TEST(test_config_flags);
     
     UNITY_END();
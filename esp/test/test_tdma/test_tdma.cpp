@@ -0,0 +1,135 @@
+#include <unity.h>
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+#include "TdmaScheduler.h"
+
+// Channel simulator: N bridges forward 20 Hz telemetry from their hosts.
+// Each bridge polls in loop() roughly every millisecond; without TDMA it
+// sends as soon as telemetry arrives, with TDMA it holds the newest frame
+// until a loop pass falls inside its transmit window. Frames whose airtime
+// overlaps another frame count as collisions (no carrier sense, the worst
+// case of two radios that cannot hear each other or back off alike).
+
+#define SIM_DURATION_US 10000000LL
+#define SIM_TELEMETRY_PERIOD_US 50000
+#define SIM_LOOP_US 1000
+#define SIM_LOOP_JITTER_US 200
+#define SIM_CLOCK_ERROR_US 150  // Time sync error, within TDMA_GUARD_US
+
+struct SimResult {
+    int offered;
+    int sent;
+    int collided;
+    float delivered_pps;
+};
+
+static uint32_t rng_state;
+
+static uint32_t rnd(uint32_t range) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state % range;
+}
+
+static SimResult simulate(int drones, bool slotted) {
+    rng_state = 2463534242u + drones;
+    TdmaScheduler tdma;
+    if (slotted) {
+        tdma.configure(drones + 1, TDMA_DEFAULT_SLOT_US);  // drone ids 1..N
+    }
+
+    std::vector<int64_t> starts;
+    SimResult result = {0, 0, 0, 0.0f};
+    for (int id = 1; id <= drones; id++) {
+        int64_t phase = rnd(SIM_TELEMETRY_PERIOD_US);
+        int64_t clock_error = (int64_t)rnd(2 * SIM_CLOCK_ERROR_US + 1) - SIM_CLOCK_ERROR_US;
+        int64_t next_telemetry = phase;
+        bool pending = false;
+        for (int64_t t = rnd(SIM_LOOP_US); t < SIM_DURATION_US; t += SIM_LOOP_US + rnd(SIM_LOOP_JITTER_US)) {
+            while (next_telemetry <= t) {
+                pending = true;
+                result.offered++;
+                next_telemetry += SIM_TELEMETRY_PERIOD_US;
+            }
+            if (pending && tdma.canTransmit(t + clock_error, id)) {
+                starts.push_back(t);
+                pending = false;
+            }
+        }
+    }
+
+    std::sort(starts.begin(), starts.end());
+    result.sent = starts.size();
+    for (size_t i = 0; i < starts.size(); i++) {
+        bool overlap = (i > 0 && starts[i] - starts[i - 1] < TDMA_AIRTIME_US) ||
+                       (i + 1 < starts.size() && starts[i + 1] - starts[i] < TDMA_AIRTIME_US);
+        if (overlap) result.collided++;
+    }
+    result.delivered_pps = (result.sent - result.collided) * 1e6f / SIM_DURATION_US;
+    return result;
+}
+
+void test_slot_assignment() {
+    TdmaScheduler tdma;
+    TEST_ASSERT_FALSE(tdma.enabled());
+    TEST_ASSERT_TRUE(tdma.canTransmit(12345, 7));  // Off: always
+
+    TEST_ASSERT_FALSE(tdma.configure(10, TDMA_MIN_SLOT_US - 1));
+    TEST_ASSERT_FALSE(tdma.configure(TDMA_MAX_SLOTS + 1, TDMA_DEFAULT_SLOT_US));
+    TEST_ASSERT_TRUE(tdma.configure(10, 3000));
+    TEST_ASSERT_EQUAL(30000, tdma.frameUs());
+    TEST_ASSERT_EQUAL(3, tdma.slotOf(3));
+    TEST_ASSERT_EQUAL(3, tdma.slotOf(13));
+}
+
+void test_transmit_window() {
+    TdmaScheduler tdma;
+    tdma.configure(10, 3000);
+
+    // Slot 3 spans 9000..12000 in every 30 ms frame
+    TEST_ASSERT_FALSE(tdma.canTransmit(9000 + TDMA_GUARD_US - 1, 3));
+    TEST_ASSERT_TRUE(tdma.canTransmit(9000 + TDMA_GUARD_US, 3));
+    TEST_ASSERT_TRUE(tdma.canTransmit(12000 - TDMA_GUARD_US - TDMA_AIRTIME_US, 3));
+    TEST_ASSERT_FALSE(tdma.canTransmit(12000 - TDMA_GUARD_US - TDMA_AIRTIME_US + 1, 3));
+    TEST_ASSERT_TRUE(tdma.canTransmit(30000 * 100LL + 10000, 3));
+    TEST_ASSERT_FALSE(tdma.canTransmit(10000, 4));
+
+    TEST_ASSERT_EQUAL_INT64(9000 + TDMA_GUARD_US, tdma.nextWindow(0, 3));
+    TEST_ASSERT_EQUAL_INT64(10000, tdma.nextWindow(10000, 3));
+    TEST_ASSERT_EQUAL_INT64(30000 + 9000 + TDMA_GUARD_US, tdma.nextWindow(11900, 3));
+}
+
+void test_simulated_swarm() {
+    const int sizes[] = {10, 20, 40};
+    printf("\n  N  mode      offered   sent  collided  delivered pps\n");
+    for (int drones : sizes) {
+        SimResult aloha = simulate(drones, false);
+        SimResult slotted = simulate(drones, true);
+        printf("%3d  unslotted %7d %6d %6d (%4.1f%%) %8.1f\n", drones, aloha.offered, aloha.sent, aloha.collided,
+               aloha.collided * 100.0f / aloha.sent, aloha.delivered_pps);
+        printf("%3d  TDMA      %7d %6d %6d (%4.1f%%) %8.1f\n", drones, slotted.offered, slotted.sent,
+               slotted.collided, slotted.collided * 100.0f / slotted.sent, slotted.delivered_pps);
+
+        // Slots never overlap while the clocks agree within the guard time
+        TEST_ASSERT_EQUAL(0, slotted.collided);
+        TEST_ASSERT_TRUE(aloha.collided > 0);
+
+        // Each drone gets one frame per TDMA frame, or every telemetry frame if that is slower
+        float frame_us = (drones + 1) * (float)TDMA_DEFAULT_SLOT_US;
+        float per_drone = 1e6f / std::max(frame_us, (float)SIM_TELEMETRY_PERIOD_US);
+        TEST_ASSERT_TRUE(slotted.delivered_pps >= 0.9f * drones * per_drone);
+    }
+
+    // In a crowded channel slotting delivers more than contention
+    TEST_ASSERT_TRUE(simulate(40, true).delivered_pps > simulate(40, false).delivered_pps);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_slot_assignment);
+    RUN_TEST(test_transmit_window);
+    RUN_TEST(test_simulated_swarm);
+    return UNITY_END();
+}
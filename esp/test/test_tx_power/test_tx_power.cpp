@@ -0,0 +1,199 @@
+#include <unity.h>
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include "TxPowerController.h"
+
+// Link model for a swarm whose bridges all run the controller and so
+// transmit at the same power: log-distance path loss with shadowing, and a
+// frame success probability that falls off around the receiver
+// sensitivity. Each period every peer sends 20 Hz telemetry to us and we
+// judge the period on what arrived.
+
+#define SIM_PERIODS 60
+#define SIM_FRAMES_PER_PERIOD (20 * TX_POWER_PERIOD_MS / 1000)
+#define SIM_PL_1M_DB 40.0          // Path loss at 1 m, 2.4 GHz
+#define SIM_PL_EXPONENT 2.7
+#define SIM_SHADOW_DB 2.0
+#define SIM_SENSITIVITY_DBM -88.0
+#define SIM_FADE_SLOPE_DB 1.5
+
+static uint32_t rng_state;
+
+static double pathLoss(double metres) {
+    return SIM_PL_1M_DB + 10.0 * SIM_PL_EXPONENT * log10(metres);
+}
+
+static double uniform() {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (rng_state + 0.5) / 4294967296.0;
+}
+
+static double gaussian() {
+    return sqrt(-2.0 * log(uniform())) * cos(6.283185307179586 * uniform());
+}
+
+struct SimResult {
+    int8_t final_power;
+    float late_delivery;  // Over the last third of the run
+};
+
+// distances[p][period] in metres
+static SimResult simulate(const std::vector<std::vector<double>>& distances, int8_t min_dbm, int8_t max_dbm) {
+    rng_state = 2463534242u;
+    TxPowerController controller;
+    controller.configure(min_dbm, max_dbm, max_dbm);
+    int8_t power = controller.getPower();
+
+    uint32_t late_sent = 0, late_received = 0;
+    for (int period = 0; period < SIM_PERIODS; period++) {
+        LinkQuality quality;
+        int worst = 0;
+        bool any = false;
+        for (const auto& path : distances) {
+            double loss_db = pathLoss(path[period]);
+            double rssi_sum = 0.0;
+            int heard = 0;
+            for (int f = 0; f < SIM_FRAMES_PER_PERIOD; f++) {
+                double rssi = power - loss_db + SIM_SHADOW_DB * gaussian();
+                double p = 1.0 / (1.0 + exp(-(rssi - SIM_SENSITIVITY_DBM) / SIM_FADE_SLOPE_DB));
+                if (uniform() < p) {
+                    rssi_sum += rssi;
+                    heard++;
+                }
+            }
+            if (period >= SIM_PERIODS * 2 / 3) {
+                late_sent += SIM_FRAMES_PER_PERIOD;
+                late_received += heard;
+            }
+            quality.expected += SIM_FRAMES_PER_PERIOD;
+            quality.lost += SIM_FRAMES_PER_PERIOD - heard;
+            if (heard > 0) {
+                int mean = (int)lround(rssi_sum / heard);
+                worst = any ? (mean < worst ? mean : worst) : mean;
+                any = true;
+                quality.peers++;
+            }
+        }
+        quality.min_rssi = (int8_t)worst;
+        power = controller.evaluate(quality);
+    }
+    return {power, (float)late_received / late_sent};
+}
+
+static std::vector<double> fixed(double metres) {
+    return std::vector<double>(SIM_PERIODS, metres);
+}
+
+void test_configure_bounds() {
+    TxPowerController controller;
+    TEST_ASSERT_FALSE(controller.enabled());
+
+    controller.configure(0, 20, 11);
+    TEST_ASSERT_FALSE(controller.enabled());
+
+    controller.configure(1, 30, 25);
+    TEST_ASSERT_TRUE(controller.enabled());
+    TEST_ASSERT_EQUAL(TX_POWER_MIN_DBM, controller.getMin());
+    TEST_ASSERT_EQUAL(TX_POWER_MAX_DBM, controller.getMax());
+    TEST_ASSERT_EQUAL(TX_POWER_MAX_DBM, controller.getPower());
+
+    controller.configure(10, 5, 2);
+    TEST_ASSERT_EQUAL(10, controller.getMax());
+    TEST_ASSERT_EQUAL(10, controller.getPower());
+}
+
+void test_steps() {
+    TxPowerController controller;
+    controller.configure(4, 20, 12);
+
+    LinkQuality strong;
+    strong.peers = 2;
+    strong.min_rssi = -50;
+    strong.expected = 100;
+    strong.lost = 0;
+
+    // Down one step only after a run of good periods
+    for (int i = 0; i < TX_POWER_HOLD_PERIODS - 1; i++) {
+        TEST_ASSERT_EQUAL(12, controller.evaluate(strong));
+    }
+    TEST_ASSERT_EQUAL(12 - TX_POWER_STEP_DOWN_DB, controller.evaluate(strong));
+
+    // Too few frames to judge the loss: hold
+    LinkQuality sparse = strong;
+    sparse.expected = TX_POWER_MIN_SAMPLES - 1;
+    for (int i = 0; i < TX_POWER_HOLD_PERIODS * 2; i++) {
+        TEST_ASSERT_EQUAL(12 - TX_POWER_STEP_DOWN_DB, controller.evaluate(sparse));
+    }
+
+    // Loss or a weak peer raises at once
+    LinkQuality lossy = strong;
+    lossy.lost = 10;
+    TEST_ASSERT_EQUAL(12 - TX_POWER_STEP_DOWN_DB + TX_POWER_STEP_UP_DB, controller.evaluate(lossy));
+    LinkQuality weak = strong;
+    weak.min_rssi = TX_POWER_RSSI_LOW_DBM - 1;
+    TEST_ASSERT_EQUAL(12 - TX_POWER_STEP_DOWN_DB + 2 * TX_POWER_STEP_UP_DB, controller.evaluate(weak));
+
+    // Nobody heard: up to the maximum and no further
+    LinkQuality silent;
+    for (int i = 0; i < 10; i++) controller.evaluate(silent);
+    TEST_ASSERT_EQUAL(20, controller.getPower());
+
+    // Never below the minimum
+    for (int i = 0; i < 100; i++) controller.evaluate(strong);
+    TEST_ASSERT_EQUAL(4, controller.getPower());
+}
+
+void test_simulated_links() {
+    const double ranges[] = {3, 10, 40, 100, 200};
+    printf("\n  peer at   power  delivery   fixed 20 dBm\n");
+    for (double d : ranges) {
+        SimResult adaptive = simulate({fixed(d)}, TX_POWER_MIN_DBM, TX_POWER_MAX_DBM);
+        SimResult full = simulate({fixed(d)}, TX_POWER_MAX_DBM, TX_POWER_MAX_DBM);
+        printf("  %5.0f m  %3d dBm  %8.3f   %8.3f\n", d, adaptive.final_power, adaptive.late_delivery,
+               full.late_delivery);
+    }
+
+    // Close swarm: settles well below full power without losing frames
+    SimResult close = simulate({fixed(3), fixed(5), fixed(8)}, TX_POWER_MIN_DBM, TX_POWER_MAX_DBM);
+    TEST_ASSERT_TRUE(close.final_power <= 8);
+    TEST_ASSERT_TRUE(close.late_delivery > 0.99f);
+
+    // One distant peer sets the power for everyone
+    SimResult mixed = simulate({fixed(3), fixed(40)}, TX_POWER_MIN_DBM, TX_POWER_MAX_DBM);
+    TEST_ASSERT_TRUE(mixed.final_power > close.final_power);
+    TEST_ASSERT_TRUE(mixed.late_delivery > 0.99f);
+
+    // Out of reach even at full power: stays at the maximum
+    SimResult far = simulate({fixed(200)}, TX_POWER_MIN_DBM, TX_POWER_MAX_DBM);
+    TEST_ASSERT_EQUAL(TX_POWER_MAX_DBM, far.final_power);
+
+    // The bounds hold whatever the links
+    SimResult capped = simulate({fixed(3)}, 12, 16);
+    TEST_ASSERT_EQUAL(12, capped.final_power);
+}
+
+void test_peer_moving_away() {
+    // Settles low while the peer is close, then it flies off to 60 m
+    std::vector<double> path(SIM_PERIODS);
+    for (int i = 0; i < SIM_PERIODS; i++) {
+        path[i] = i < SIM_PERIODS / 2 ? 3.0 : 60.0;
+    }
+    SimResult moving = simulate({path}, TX_POWER_MIN_DBM, TX_POWER_MAX_DBM);
+    printf("\n  peer moving 3 m -> 60 m: %d dBm, delivery %.3f after the move\n", moving.final_power,
+           moving.late_delivery);
+    TEST_ASSERT_TRUE(moving.late_delivery > 0.99f);
+    // Back above the weak-link threshold, somewhere in the hold band
+    TEST_ASSERT_TRUE(moving.final_power - pathLoss(60.0) >= TX_POWER_RSSI_LOW_DBM);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_configure_bounds);
+    RUN_TEST(test_steps);
+    RUN_TEST(test_simulated_links);
+    RUN_TEST(test_peer_moving_away);
+    return UNITY_END();
+}
@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
 #include "esp_system.h"
 #include "esp_wifi.h"
 #include "esp_event.h"
@@ -24,6 +25,14 @@ static const char *TAG = "SIMPLE_CONTROLLER";
 #define PACKET_PREAMBLE 0xAA55
 #define NETWORK_ID 18
 
+// Сбор статистики с мостов роя
+#define PACKET_TYPE_STATS 25
+#define STATS_REQUEST 1
+#define STATS_REPLY 2
+#define STATS_TARGET_ALL 0xFF
+#define STATS_POLL_INTERVAL_MS 2000   // Bridges answer at most every 500 ms
+#define STATS_QUEUE_DEPTH 32
+#define AIR_TRAILER_SIZE 4            // src_id, flags, seq appended by the bridges
 
 // Broadcast address
 static const uint8_t broadcast_address[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
@@ -47,6 +56,34 @@ typedef struct {
     uint16_t crc;
 } __attribute__((packed)) ota_config_packet_t;
 
+// Statistics snapshot packet (matching ESP drone StatsPacket - 55 bytes)
+typedef struct {
+    packet_header_t header;
+    uint8_t op;               // STATS_REQUEST / STATS_REPLY
+    uint8_t target_id;        // Request: drone_id asked, or STATS_TARGET_ALL
+    uint8_t src_id;           // Reply: drone_id of the bridge
+    uint8_t query_id;
+    uint32_t uptime_s;
+    uint32_t air_sent;
+    uint32_t air_received;
+    uint32_t air_corrupted;
+    uint32_t send_failures;
+    uint32_t host_sent;
+    uint32_t host_received;
+    uint32_t policed;
+    uint32_t free_heap;
+    uint16_t air_tx_pps;      // Tenths
+    uint16_t air_rx_pps;
+    uint8_t neighbors;
+    int8_t tx_power;
+    uint8_t channel;
+    uint8_t time_master;
+    uint16_t crc;
+} __attribute__((packed)) stats_packet_t;
+
+// Replies from the receive callback, printed by stats_printer_task
+static QueueHandle_t stats_queue = NULL;
+
 // Захардкоженные данные для отправки
 static const char* HARDCODED_SSID = WIFI_SSID;  // 5 chars, fits in 22-byte field
 static const char* HARDCODED_PASSWORD = WIFI_PASSWORD;
@@ -62,10 +99,26 @@ static void espnow_send_cb(const wifi_tx_info_t *tx_info, esp_now_send_status_t
     }
 }
 
+static uint16_t calculate_crc16(const uint8_t* data, size_t len);
+
 // ESP-NOW receive callback
 static void espnow_recv_cb(const esp_now_recv_info *recv_info, const uint8_t *data, int len)
 {
-    ESP_LOGI(TAG, "Received packet from %02x:%02x:%02x:%02x:%02x:%02x, length: %d", 
+    // Statistics replies, with or without the bridge's air trailer
+    if (len == sizeof(stats_packet_t) || len == sizeof(stats_packet_t) + AIR_TRAILER_SIZE) {
+        stats_packet_t packet;
+        memcpy(&packet, data, sizeof(packet));
+        if (packet.header.packet_type == PACKET_TYPE_STATS) {
+            if (packet.header.preamble == PACKET_PREAMBLE && packet.header.network_id == NETWORK_ID &&
+                packet.op == STATS_REPLY && packet.crc == calculate_crc16((const uint8_t*)&packet, sizeof(packet))) {
+                // Printing is too slow for the WiFi task
+                xQueueSend(stats_queue, &packet, 0);
+            }
+            return;
+        }
+    }
+
+    ESP_LOGD(TAG, "Received packet from %02x:%02x:%02x:%02x:%02x:%02x, length: %d", 
              recv_info->src_addr[0], recv_info->src_addr[1], recv_info->src_addr[2],
              recv_info->src_addr[3], recv_info->src_addr[4], recv_info->src_addr[5], len);
 }
@@ -176,6 +229,62 @@ static bool send_ota_config_packet(uint8_t drone_id)
     return true;
 }
 
+// Ask every bridge in range for its statistics snapshot
+static bool send_stats_request(uint8_t query_id)
+{
+    stats_packet_t packet;
+    memset(&packet, 0, sizeof(packet));
+
+    packet.header.preamble = PACKET_PREAMBLE;
+    packet.header.payload_size = sizeof(packet) - sizeof(packet_header_t);
+    packet.header.packet_type = PACKET_TYPE_STATS;
+    packet.header.network_id = NETWORK_ID;
+    packet.op = STATS_REQUEST;
+    packet.target_id = STATS_TARGET_ALL;
+    packet.query_id = query_id;
+    packet.crc = calculate_crc16((uint8_t*)&packet, sizeof(packet));
+
+    esp_err_t result = esp_now_send(broadcast_address, (uint8_t*)&packet, sizeof(packet));
+    if (result != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to send STATS request: %s", esp_err_to_name(result));
+        return false;
+    }
+    return true;
+}
+
+// Polls the swarm for statistics
+static void stats_poll_task(void *pvParameters)
+{
+    uint8_t query_id = 0;
+
+    ESP_LOGI(TAG, "Starting stats poll task, every %d ms", STATS_POLL_INTERVAL_MS);
+
+    while (1) {
+        send_stats_request(query_id++);
+        vTaskDelay(pdMS_TO_TICKS(STATS_POLL_INTERVAL_MS));
+    }
+}
+
+// Streams the replies to the PC over the console, one CSV line per bridge
+static void stats_printer_task(void *pvParameters)
+{
+    stats_packet_t p;
+
+    printf("STATS,time_ms,drone_id,query,uptime_s,air_sent,air_received,air_corrupted,send_failures,"
+           "host_sent,host_received,policed,free_heap,air_tx_pps,air_rx_pps,neighbors,tx_power,channel,time_master\n");
+
+    while (1) {
+        if (xQueueReceive(stats_queue, &p, portMAX_DELAY) == pdTRUE) {
+            printf("STATS,%lld,%u,%u,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%.1f,%.1f,%u,%d,%u,%u\n",
+                   (long long)(esp_timer_get_time() / 1000), p.src_id, p.query_id, (unsigned long)p.uptime_s,
+                   (unsigned long)p.air_sent, (unsigned long)p.air_received, (unsigned long)p.air_corrupted,
+                   (unsigned long)p.send_failures, (unsigned long)p.host_sent, (unsigned long)p.host_received,
+                   (unsigned long)p.policed, (unsigned long)p.free_heap, p.air_tx_pps / 10.0, p.air_rx_pps / 10.0,
+                   p.neighbors, p.tx_power, p.channel, p.time_master);
+        }
+    }
+}
+
 // Main task that sends packets in loop
 static void packet_sender_task(void *pvParameters)
 {
@@ -216,6 +325,8 @@ extern "C" void app_main(void)
     }
     ESP_ERROR_CHECK(ret);
 
+    stats_queue = xQueueCreate(STATS_QUEUE_DEPTH, sizeof(stats_packet_t));
+
     // Initialize ESP-NOW
     if (!espnow_init()) {
         ESP_LOGE(TAG, "Failed to initialize ESP-NOW");
@@ -231,4 +342,8 @@ extern "C" void app_main(void)
 
     // Create packet sender task
     xTaskCreate(packet_sender_task, "packet_sender", 4096, NULL, 5, NULL);
+
+    // Statistics of every bridge, streamed as CSV lines
+    xTaskCreate(stats_poll_task, "stats_poll", 3072, NULL, 4, NULL);
+    xTaskCreate(stats_printer_task, "stats_printer", 4096, NULL, 3, NULL);
 } 
\ No newline at end of file
@@ -22,7 +22,20 @@ except ImportError:
 
 from skyros.collision_avoidance import CollisionAvoidance, ForceCollisionAvoidance
 from skyros.drone_data import DroneDiscoveryMethod, DroneInfo, DronePosition
-from skyros.lib.packets import StatusPacket, TelemetryPacket
+from skyros.lib.packets import (
+    COMMAND_TARGET_ALL,
+    CONFLICT_INSIDE,
+    DELIVERY_OK,
+    RX_META_FLAG_RELAYED,
+    RX_META_FLAG_RSSI,
+    ConflictAlertPacket,
+    DeliveryReportPacket,
+    NeighborEvent,
+    NeighborPacket,
+    StatusPacket,
+    SwarmSnapshotPacket,
+    TelemetryPacket,
+)
 from skyros.lib.network_utils import get_local_ip_id
 from skyros.link import ESP32Link
 
@@ -41,6 +54,20 @@ class Drone:
         tx_power: int = 11,
         telemetry_rate: float = 20.0,
         telemetry_frame: str = "aruco_map",
+        snapshot_rate: float = 0.0,
+        interest_radius: float = 0.0,
+        interest_k: int = 0,
+        conflict_radius: float = 0.0,
+        conflict_horizon: float = 3.0,
+        command_retries: int = 0,
+        fec_group: int = 0,
+        relay_hops: int = 0,
+        time_sync: int = 0,
+        tdma_slots: int = 0,
+        tx_jitter_ms: int = 0,
+        rx_meta: bool = False,
+        tx_power_min: int = 0,
+        neighbor_events: bool = False,
     ):
         # Basic configuration
         self.drone_id = drone_id or get_local_ip_id()
@@ -53,6 +80,20 @@ class Drone:
         self.name = name or f"drone_{self.drone_id}"
         self.telemetry_rate = telemetry_rate
         self.telemetry_frame = telemetry_frame
+        self.snapshot_rate = snapshot_rate  # Hz, 0 = bridge forwards every telemetry frame
+        self.interest_radius = interest_radius  # metres, 0 = all neighbours
+        self.interest_k = interest_k  # nearest neighbours, 0 = all
+        self.conflict_radius = conflict_radius  # metres, 0 = no conflict alerts from the bridge
+        self.conflict_horizon = conflict_horizon  # seconds of look-ahead
+        self.command_retries = command_retries  # bridge retransmissions per command, 0 = fire-and-forget
+        self.fec_group = fec_group  # broadcast frames per parity frame, 0 = no FEC
+        self.relay_hops = relay_hops  # mesh relay hops for commands and status, 0 = direct range only
+        self.time_sync = time_sync  # TimeSyncRole of the bridge, 0 = no swarm clock
+        self.tdma_slots = tdma_slots  # TDMA slots per frame for telemetry, 0 = send at once
+        self.tx_jitter_ms = tx_jitter_ms  # random telemetry delay window, ignored under TDMA
+        self.rx_meta = rx_meta  # RSSI of each neighbour from the bridge's RX_META
+        self.tx_power_min = tx_power_min  # dBm the bridge may lower TX power to, 0 = always tx_power
+        self.neighbor_events = neighbor_events  # bridge pushes drone leaves, no expiry polling here
 
         # ESP32 communication link
         self.link = ESP32Link(port=uart_port, baudrate=baudrate, network_id=network_id, wifi_channel=wifi_channel, tx_power=tx_power)
@@ -84,12 +125,22 @@ class Drone:
         # Custom message callback
         self._custom_message_callback: Optional[Callable[[str], None]] = None
 
+        # Conflict alert callback
+        self._conflict_callback: Optional[Callable[[ConflictAlertPacket], None]] = None
+
+        # Command delivery callback
+        self._delivery_callback: Optional[Callable[[DeliveryReportPacket], None]] = None
+
         # Logger
         self.logger = logging.getLogger(self.name)
 
         # Set up packet callbacks
         self.link.set_packet_callback(1, self._handle_telemetry_packet)  # TELEMETRY
         self.link.set_packet_callback(3, self._handle_status_packet)  # STATUS
+        self.link.set_packet_callback(12, self._handle_swarm_snapshot)  # SWARM_SNAPSHOT
+        self.link.set_packet_callback(13, self._handle_conflict_alert)  # CONFLICT_ALERT
+        self.link.set_packet_callback(14, self._handle_delivery_report)  # DELIVERY_REPORT
+        self.link.set_packet_callback(24, self._handle_neighbor_event)  # NEIGHBOR
         self.link.set_custom_message_callback(self._handle_custom_message)
 
     def start(self) -> bool:
@@ -100,11 +151,27 @@ class Drone:
 
         self.running = True
 
+        # Let the bridge aggregate telemetry into periodic snapshots
+        interval_ms = int(1000.0 / self.snapshot_rate) if self.snapshot_rate > 0 else 0
+        self.link.set_snapshot_interval(interval_ms)
+        self.link.set_interest(self.interest_radius, self.interest_k)
+        self.link.set_conflict_detection(self.conflict_radius, self.conflict_horizon)
+        self.link.set_command_retries(self.command_retries)
+        self.link.set_fec(self.fec_group)
+        self.link.set_relay(self.relay_hops)
+        self.link.set_time_sync(self.time_sync)
+        self.link.set_tdma(self.tdma_slots)
+        self.link.set_tx_jitter(self.tx_jitter_ms)
+        self.link.set_rx_meta(self.rx_meta)
+        self.link.set_tx_power_control(self.tx_power_min, self.link.tx_power)
+        self.link.set_neighbor_events(self.neighbor_events)
+
         # Start telemetry broadcasting
         self._start_telemetry_timer()
 
-        # Start drone discovery cleanup
-        self._start_cleanup_timer()
+        # Start drone discovery cleanup, unless the bridge reports leaves itself
+        if not self.neighbor_events:
+            self._start_cleanup_timer()
 
         self.logger.info(f"Drone {self.name} started successfully")
         return True
@@ -251,12 +318,19 @@ class Drone:
                     # Create position from telemetry data
                     position = DronePosition(x=packet.x, y=packet.y, z=packet.z, vx=packet.vx, vy=packet.vy, vz=packet.vz)
 
+                    # Signal strength only when heard directly, a relay's says nothing about the sender
+                    rx_meta = getattr(packet, "rx_meta", None)
+                    rssi = None
+                    if rx_meta and rx_meta.flags & RX_META_FLAG_RSSI and not rx_meta.flags & RX_META_FLAG_RELAYED:
+                        rssi = rx_meta.rssi
+
                     # Always update/create drone info from telemetry (most important data)
                     self._other_drones[packet.drone_id] = DroneInfo(
                         drone_id=packet.drone_id,
                         position=position,
                         last_seen=current_time,
                         discovered_via=DroneDiscoveryMethod.TELEMETRY,
+                        rssi=rssi,
                     )
 
                     if was_new:
@@ -270,6 +344,74 @@ class Drone:
         except Exception as e:
             self.logger.error(f"Error handling telemetry packet: {e}")
 
+    def _handle_swarm_snapshot(self, packet: SwarmSnapshotPacket):
+        """Handle a swarm snapshot from the bridge - one entry per drone it has heard"""
+        try:
+            current_time = time.time()
+            with self._other_drones_lock:
+                for entry in packet.entries:
+                    if entry.drone_id == self.drone_id:
+                        continue
+                    was_new = entry.drone_id not in self._other_drones
+
+                    position = DronePosition(x=entry.x, y=entry.y, z=entry.z, vx=entry.vx, vy=entry.vy, vz=entry.vz)
+                    self._other_drones[entry.drone_id] = DroneInfo(
+                        drone_id=entry.drone_id,
+                        position=position,
+                        last_seen=current_time - entry.age_ms / 1000.0,
+                        discovered_via=DroneDiscoveryMethod.TELEMETRY,
+                    )
+
+                    if was_new:
+                        self.logger.info(
+                            f"Discovered drone_{entry.drone_id} via snapshot at ({entry.x:.1f}, {entry.y:.1f}, {entry.z:.1f})"
+                        )
+        except Exception as e:
+            self.logger.error(f"Error handling swarm snapshot: {e}")
+
+    def _handle_neighbor_event(self, packet: NeighborPacket):
+        """Handle a drone joining or leaving the bridge's neighbour table"""
+        if packet.drone_id == self.drone_id:
+            return
+        if packet.event == NeighborEvent.JOIN:
+            # The entry itself comes with the drone's telemetry
+            self.logger.debug(f"Drone_{packet.drone_id} joined the bridge's neighbour table")
+        elif packet.event == NeighborEvent.LEAVE:
+            with self._other_drones_lock:
+                if self._other_drones.pop(packet.drone_id, None) is not None:
+                    self.logger.info(f"Drone_{packet.drone_id} left (last heard {packet.age:.1f}s ago)")
+
+    def _handle_conflict_alert(self, packet: ConflictAlertPacket):
+        """Handle a closest-point-of-approach alert raised by the bridge"""
+        self.logger.warning(
+            f"Conflict with drone_{packet.drone_id}: "
+            f"{'inside' if packet.severity == CONFLICT_INSIDE else 'predicted'}, "
+            f"distance {packet.distance:.2f}m, closest {packet.min_distance:.2f}m in {packet.time_to_cpa:.2f}s"
+        )
+        if self._conflict_callback:
+            try:
+                self._conflict_callback(packet)
+            except Exception as e:
+                self.logger.error(f"Error in conflict callback: {e}")
+
+    def _handle_delivery_report(self, packet: DeliveryReportPacket):
+        """Handle the bridge's report on a reliable command"""
+        if packet.result == DELIVERY_OK:
+            self.logger.debug(
+                f"Command {packet.command_id} delivered to {packet.acked} drone(s) in {packet.latency_ms}ms "
+                f"({packet.retransmissions} retransmissions)"
+            )
+        else:
+            self.logger.warning(
+                f"Command {packet.command_id} to {packet.target_id}: only {packet.acked}/{packet.expected} "
+                f"acknowledged after {packet.retransmissions} retransmissions"
+            )
+        if self._delivery_callback:
+            try:
+                self._delivery_callback(packet)
+            except Exception as e:
+                self.logger.error(f"Error in delivery callback: {e}")
+
     def _handle_status_packet(self, packet: StatusPacket):
         """Handle received status packets - only update timestamp if drone already discovered via telemetry"""
         if packet.drone_id != self.drone_id:  # Don't track ourselves
@@ -341,6 +483,69 @@ class Drone:
         self._custom_message_callback = callback
         self.logger.info("Custom message callback set")
 
+    def send_command(self, command_id: int, target_id: int = COMMAND_TARGET_ALL, param: int = 0) -> bool:
+        """Send a command to another drone (or all of them).
+        Delivery is only confirmed when command_retries > 0; see set_delivery_callback."""
+        return self.link.send_command(command_id, target_id, param)
+
+    def send_bulk(self, data: bytes) -> bool:
+        """Send a blob (map, waypoint list, image...) of up to 4096 bytes to the other drones.
+        Receivers get it whole or not at all; delivery is not acknowledged."""
+        return self.link.send_bulk(data)
+
+    def set_bulk_callback(self, callback: Callable[[int, bytes], None]):
+        """Set callback function for bulk blobs from other drones: callback(drone_id, data)"""
+
+        def handler(src_id: int, data: bytes):
+            try:
+                callback(src_id, data)
+            except Exception as e:
+                self.logger.error(f"Error in bulk callback: {e}")
+
+        self.link.set_bulk_callback(handler)
+        self.logger.info("Bulk callback set")
+
+    def send_file(self, drone_id: int, data: bytes, timeout: float = 10.0) -> bool:
+        """Send data of any size to one drone as a reliable stream.
+        Returns True once the receiving bridge has acknowledged every byte."""
+        stream_id = self.link.open_stream(drone_id)
+        if stream_id is None:
+            return False
+        if not self.link.write_stream(stream_id, data, timeout):
+            self.link.close_stream(stream_id, timeout=0)
+            return False
+        return self.link.close_stream(stream_id, timeout)
+
+    def set_file_callback(self, callback: Callable[[int, bytes], None]):
+        """Set callback function for complete streams from other drones: callback(drone_id, data)"""
+        incoming: Dict[Any, bytearray] = {}
+
+        def on_data(peer_id: int, stream_id: int, data: bytes):
+            incoming.setdefault((peer_id, stream_id), bytearray()).extend(data)
+
+        def on_finished(peer_id: int, stream_id: int, complete: bool):
+            data = incoming.pop((peer_id, stream_id), bytearray())
+            if not complete:
+                self.logger.warning(f"Stream {stream_id} from drone_{peer_id} failed after {len(data)} bytes")
+                return
+            try:
+                callback(peer_id, bytes(data))
+            except Exception as e:
+                self.logger.error(f"Error in file callback: {e}")
+
+        self.link.set_stream_callbacks(on_data, on_finished)
+        self.logger.info("File callback set")
+
+    def set_delivery_callback(self, callback: Callable[[DeliveryReportPacket], None]):
+        """Set callback function for reliable command delivery reports"""
+        self._delivery_callback = callback
+        self.logger.info("Delivery callback set")
+
+    def set_conflict_callback(self, callback: Callable[[ConflictAlertPacket], None]):
+        """Set callback function for conflict alerts raised by the bridge (needs conflict_radius > 0)"""
+        self._conflict_callback = callback
+        self.logger.info("Conflict callback set")
+
     def navigate_with_avoidance(
         self,
         x: float = 0.0,
@@ -656,6 +861,21 @@ class Drone:
         with self._other_drones_lock:
             return set(self._other_drones.keys())
 
+    def get_predicted_positions(self, ahead: float = 0.0, timeout: float = 0.1) -> Optional[Dict[int, DronePosition]]:
+        """Get every other drone's position dead-reckoned by the bridge to now + ahead seconds.
+
+        One request/response over UART; entries are extrapolated from each drone's last
+        telemetry fix and velocity, so they stay usable when frames are lost.
+        """
+        entries = self.link.request_positions(ahead, timeout)
+        if entries is None:
+            return None
+        return {
+            e.drone_id: DronePosition(x=e.x, y=e.y, z=e.z, vx=e.vx, vy=e.vy, vz=e.vz)
+            for e in entries
+            if e.drone_id != self.drone_id
+        }
+
     def get_network_status(self) -> Dict[str, Any]:
         """Get network and communication status"""
         with self._other_drones_lock:
@@ -673,6 +893,7 @@ class Drone:
                     "last_seen": drone_info.last_seen,
                     "discovered_via": drone_info.discovered_via,
                     "age_seconds": time.time() - drone_info.last_seen,
+                    "rssi": drone_info.rssi,
                     "position": {
                         "x": drone_info.position.x,
                         "y": drone_info.position.y,
@@ -1,5 +1,6 @@
 from dataclasses import dataclass
 from enum import Enum
+from typing import Optional
 
 
 @dataclass
@@ -31,3 +32,4 @@ class DroneInfo:
     position: DronePosition
     last_seen: float
     discovered_via: DroneDiscoveryMethod = DroneDiscoveryMethod.TELEMETRY
+    rssi: Optional[int] = None  # dBm of the last frame heard directly, with RX_META on
@@ -4,27 +4,73 @@ from typing import Optional
 
 from .packets import (
     ACK_SIZE,
+    BRIDGE_CONTROL_FORMAT,
+    BULK_HEADER_FORMAT,
+    BULK_HEADER_SIZE,
+    CHANNEL_SWITCH_FORMAT,
+    CHANNEL_SWITCH_SIZE,
     COMMAND_SIZE,
     CONFIG_SIZE,
+    CONFLICT_ALERT_FORMAT,
+    CONFLICT_ALERT_SIZE,
     CUSTOM_MESSAGE_SIZE,
+    DELIVERY_REPORT_FORMAT,
+    DELIVERY_REPORT_SIZE,
+    FILTER_RULE_FORMAT,
+    FILTER_RULE_SIZE,
     HEADER_FORMAT,
+    LINK_STATS_ENTRY_FORMAT,
+    LINK_STATS_ENTRY_SIZE,
+    LINK_STATS_FORMAT,
     MAX_PAYLOAD_SIZE,
+    NEIGHBOR_FLAG_RSSI,
+    NEIGHBOR_FORMAT,
+    NEIGHBOR_SIZE,
     PACKET_PREAMBLE,
     PING_SIZE,
+    RX_META_FORMAT,
+    RX_META_SIZE,
     SENSOR_SIZE,
+    SNAPSHOT_ENTRY_FORMAT,
+    SNAPSHOT_ENTRY_SIZE,
+    SNAPSHOT_FORMAT,
+    STATS_FORMAT,
+    STATS_SIZE,
     STATUS_SIZE,
+    STREAM_CONTROL_FORMAT,
+    STREAM_CONTROL_SIZE,
+    STREAM_HEADER_FORMAT,
+    STREAM_HEADER_SIZE,
     TELEMETRY_FORMAT,
     TELEMETRY_SIZE,
+    TIME_SYNC_FORMAT,
+    TIME_SYNC_SIZE,
     AckPacket,
+    BridgeControlPacket,
+    BulkDataPacket,
+    ChannelSwitchPacket,
     CommandPacket,
     ConfigPacket,
+    ConflictAlertPacket,
     CustomMessagePacket,
+    DeliveryReportPacket,
+    FilterRulePacket,
+    LinkStatsEntry,
+    LinkStatsPacket,
+    NeighborPacket,
     PacketHeader,
     PacketType,
     PingPacket,
+    RxMetaPacket,
     SensorPacket,
+    SnapshotEntry,
+    StatsPacket,
     StatusPacket,
+    StreamControlPacket,
+    StreamDataPacket,
+    SwarmSnapshotPacket,
     TelemetryPacket,
+    TimeSyncPacket,
 )
 
 
@@ -71,6 +117,72 @@ def pack_packet(packet) -> bytes:
         data = struct.pack("<BBH", packet.ack_type, packet.ack_id, packet.status)
     elif isinstance(packet, CustomMessagePacket):
         data = struct.pack("<126s", packet.custom_data)
+    elif isinstance(packet, BridgeControlPacket):
+        data = struct.pack(BRIDGE_CONTROL_FORMAT, packet.command, packet.arg, packet.value)
+    elif isinstance(packet, ChannelSwitchPacket):
+        data = struct.pack(
+            CHANNEL_SWITCH_FORMAT,
+            packet.op,
+            packet.channel,
+            packet.status,
+            packet.switch_id,
+            packet.switch_at_us,
+            packet.countdown_us,
+            packet.first_frame_us,
+        )
+    elif isinstance(packet, FilterRulePacket):
+        data = struct.pack(
+            FILTER_RULE_FORMAT,
+            packet.index,
+            packet.op,
+            packet.action,
+            packet.packet_type,
+            packet.offset,
+            packet.width,
+            packet.lo,
+            packet.hi,
+            packet.hits,
+        )
+    elif isinstance(packet, StatsPacket):
+        data = struct.pack(
+            STATS_FORMAT,
+            packet.op,
+            packet.target_id,
+            packet.src_id,
+            packet.query_id,
+            packet.uptime_s,
+            packet.air_sent,
+            packet.air_received,
+            packet.air_corrupted,
+            packet.send_failures,
+            packet.host_sent,
+            packet.host_received,
+            packet.policed,
+            packet.free_heap,
+            int(packet.air_tx_pps * 10),
+            int(packet.air_rx_pps * 10),
+            packet.neighbors,
+            packet.tx_power,
+            packet.channel,
+            packet.time_master,
+        )
+    elif isinstance(packet, BulkDataPacket):
+        data = (
+            struct.pack(BULK_HEADER_FORMAT, packet.src_id, packet.blob_id, packet.flags, packet.total_len, packet.offset)
+            + packet.data
+        )
+    elif isinstance(packet, StreamDataPacket):
+        data = struct.pack(STREAM_HEADER_FORMAT, packet.stream_id, packet.flags, packet.seq) + packet.data
+    elif isinstance(packet, StreamControlPacket):
+        data = struct.pack(
+            STREAM_CONTROL_FORMAT,
+            packet.op,
+            packet.stream_id,
+            packet.peer_id,
+            packet.state,
+            packet.credit,
+            packet.bytes,
+        )
     elif isinstance(packet, bytes):
         # For bulk packets that are already packed
         return packet
@@ -158,8 +270,12 @@ def unpack_packet(header: PacketHeader, payload: bytes):
             return ConfigPacket(header, network_id, wifi_channel, tx_power, received_crc)
 
         elif header.packet_type == PacketType.BULK_DATA:
-            # For bulk data, just return the payload without CRC
-            return payload[:-2]
+            if header.payload_size < BULK_HEADER_SIZE + 2:
+                return None
+            src_id, blob_id, flags, total_len, offset = struct.unpack_from(BULK_HEADER_FORMAT, payload)
+            return BulkDataPacket(
+                header, src_id, blob_id, flags, total_len, offset, bytes(payload[BULK_HEADER_SIZE:-2]), received_crc
+            )
 
         elif header.packet_type == PacketType.PING:
             if header.payload_size != PING_SIZE:
@@ -179,6 +295,86 @@ def unpack_packet(header: PacketHeader, payload: bytes):
             (custom_data,) = struct.unpack("<126s", payload[:-2])
             return CustomMessagePacket(header, custom_data, received_crc)
 
+        elif header.packet_type == PacketType.SWARM_SNAPSHOT:
+            return _unpack_swarm_snapshot(header, payload[:-2], received_crc)
+
+        elif header.packet_type == PacketType.LINK_STATS:
+            return _unpack_link_stats(header, payload[:-2], received_crc)
+
+        elif header.packet_type == PacketType.TIME_SYNC:
+            if header.payload_size != TIME_SYNC_SIZE:
+                return None
+            return TimeSyncPacket(header, *struct.unpack(TIME_SYNC_FORMAT, payload[:-2]), received_crc)
+
+        elif header.packet_type == PacketType.RX_META:
+            if header.payload_size != RX_META_SIZE:
+                return None
+            return RxMetaPacket(header, *struct.unpack(RX_META_FORMAT, payload[:-2]), received_crc)
+
+        elif header.packet_type == PacketType.CHANNEL_SWITCH:
+            if header.payload_size != CHANNEL_SWITCH_SIZE:
+                return None
+            return ChannelSwitchPacket(header, *struct.unpack(CHANNEL_SWITCH_FORMAT, payload[:-2]), received_crc)
+
+        elif header.packet_type == PacketType.FILTER_RULE:
+            if header.payload_size != FILTER_RULE_SIZE:
+                return None
+            return FilterRulePacket(header, *struct.unpack(FILTER_RULE_FORMAT, payload[:-2]), received_crc)
+
+        elif header.packet_type == PacketType.NEIGHBOR:
+            if header.payload_size != NEIGHBOR_SIZE:
+                return None
+            event, drone_id, status_code, rssi, flags, query_id, rate_dpps, age_ms = struct.unpack(
+                NEIGHBOR_FORMAT, payload[:-2]
+            )
+            return NeighborPacket(
+                header,
+                event,
+                drone_id,
+                status_code,
+                rssi if flags & NEIGHBOR_FLAG_RSSI else None,
+                query_id,
+                rate_dpps / 10.0,
+                age_ms / 1000.0,
+                received_crc,
+            )
+
+        elif header.packet_type == PacketType.STATS:
+            if header.payload_size != STATS_SIZE:
+                return None
+            fields = list(struct.unpack(STATS_FORMAT, payload[:-2]))
+            fields[13] /= 10.0  # air_tx_pps
+            fields[14] /= 10.0  # air_rx_pps
+            return StatsPacket(header, *fields, received_crc)
+
+        elif header.packet_type == PacketType.CONFLICT_ALERT:
+            if header.payload_size != CONFLICT_ALERT_SIZE:
+                return None
+            drone_id, severity, t_cpa_ms, min_distance_cm, distance_cm = struct.unpack(
+                CONFLICT_ALERT_FORMAT, payload[:-2]
+            )
+            return ConflictAlertPacket(
+                header, drone_id, severity, t_cpa_ms / 1000.0, min_distance_cm / 100.0, distance_cm / 100.0, received_crc
+            )
+
+        elif header.packet_type == PacketType.DELIVERY_REPORT:
+            if header.payload_size != DELIVERY_REPORT_SIZE:
+                return None
+            fields = struct.unpack(DELIVERY_REPORT_FORMAT, payload[:-2])
+            return DeliveryReportPacket(header, *fields, received_crc)
+
+        elif header.packet_type == PacketType.STREAM_DATA:
+            if header.payload_size < STREAM_HEADER_SIZE + 2:
+                return None
+            stream_id, flags, seq = struct.unpack_from(STREAM_HEADER_FORMAT, payload)
+            return StreamDataPacket(header, stream_id, flags, seq, bytes(payload[STREAM_HEADER_SIZE:-2]), received_crc)
+
+        elif header.packet_type == PacketType.STREAM_CONTROL:
+            if header.payload_size != STREAM_CONTROL_SIZE:
+                return None
+            fields = struct.unpack(STREAM_CONTROL_FORMAT, payload[:-2])
+            return StreamControlPacket(header, *fields, received_crc)
+
         else:
             print(f"Unknown packet type: {header.packet_type}")
             return None
@@ -186,3 +382,43 @@ def unpack_packet(header: PacketHeader, payload: bytes):
     except struct.error as e:
         print(f"Struct unpack error for type {header.packet_type}: {e}")
         return None
+
+
+def _unpack_swarm_snapshot(header: PacketHeader, data: bytes, crc: int) -> Optional[SwarmSnapshotPacket]:
+    """Unpack a variable-length swarm snapshot (positions arrive in cm, returned in metres)"""
+    fixed_size = struct.calcsize(SNAPSHOT_FORMAT)
+    if len(data) < fixed_size:
+        return None
+    timestamp_ms, snapshot_id, flags, part, count = struct.unpack_from(SNAPSHOT_FORMAT, data)
+    if len(data) != fixed_size + count * SNAPSHOT_ENTRY_SIZE:
+        return None
+
+    entries = []
+    for i in range(count):
+        drone_id, status_code, age_ms, x, y, z, vx, vy, vz = struct.unpack_from(
+            SNAPSHOT_ENTRY_FORMAT, data, fixed_size + i * SNAPSHOT_ENTRY_SIZE
+        )
+        entries.append(
+            SnapshotEntry(
+                drone_id, status_code, age_ms, x / 100.0, y / 100.0, z / 100.0, vx / 100.0, vy / 100.0, vz / 100.0
+            )
+        )
+    return SwarmSnapshotPacket(header, timestamp_ms, snapshot_id, flags, part, entries, crc)
+
+
+def _unpack_link_stats(header: PacketHeader, data: bytes, crc: int) -> Optional[LinkStatsPacket]:
+    """Unpack one part of a per-peer link statistics report (RTT arrives in 0.1 ms, returned in ms)"""
+    fixed_size = struct.calcsize(LINK_STATS_FORMAT)
+    if len(data) < fixed_size:
+        return None
+    timestamp_ms, report_id, flags, part, count = struct.unpack_from(LINK_STATS_FORMAT, data)
+    if len(data) != fixed_size + count * LINK_STATS_ENTRY_SIZE:
+        return None
+
+    entries = []
+    for i in range(count):
+        *counters, p50, p90, p99 = struct.unpack_from(
+            LINK_STATS_ENTRY_FORMAT, data, fixed_size + i * LINK_STATS_ENTRY_SIZE
+        )
+        entries.append(LinkStatsEntry(*counters, p50 / 10.0, p90 / 10.0, p99 / 10.0))
+    return LinkStatsPacket(header, timestamp_ms, report_id, flags, part, entries, crc)
@@ -1,22 +1,21 @@
 #!/usr/bin/env python3
 import random
-import struct
 import time
 
-from .packet_codec import calculate_crc16
 from .packets import (
     ACK_SIZE,
+    BULK_HEADER_SIZE,
+    BULK_UART_CHUNK_SIZE,
     COMMAND_SIZE,
     CONFIG_SIZE,
     CUSTOM_MESSAGE_SIZE,
-    HEADER_FORMAT,
-    MAX_PAYLOAD_SIZE,
     PACKET_PREAMBLE,
     PING_SIZE,
     SENSOR_SIZE,
     STATUS_SIZE,
     TELEMETRY_SIZE,
     AckPacket,
+    BulkDataPacket,
     CommandPacket,
     ConfigPacket,
     CustomMessagePacket,
@@ -134,21 +133,31 @@ def generate_config_packet(network_id: int = 0x12, wifi_channel: int = 1, tx_pow
     return packet
 
 
-def generate_bulk_packet() -> bytes:
-    """Generate a packet with arbitrary data"""
-    # Random size from 10 to MAX_PAYLOAD_SIZE bytes
-    payload_size = random.randint(10, MAX_PAYLOAD_SIZE)
+def generate_bulk_packet() -> BulkDataPacket:
+    """Generate a single-chunk bulk blob with arbitrary data"""
+    # Random size from 8 bytes to one full UART chunk
+    data_size = random.randint(8, BULK_UART_CHUNK_SIZE)
 
-    header = struct.pack(HEADER_FORMAT, PACKET_PREAMBLE, payload_size, PacketType.BULK_DATA, 0x12)
+    header = PacketHeader(
+        preamble=PACKET_PREAMBLE,
+        payload_size=BULK_HEADER_SIZE + data_size + 2,
+        packet_type=PacketType.BULK_DATA,
+        network_id=0x12,
+    )
 
     # Generate random data
-    data = bytes([random.randint(0, 255) for _ in range(payload_size - 2)])
+    data = bytes([random.randint(0, 255) for _ in range(data_size)])
 
-    # Calculate CRC
-    temp_packet = header + data + b"\x00\x00"
-    crc = calculate_crc16(temp_packet)
-
-    return header + data + struct.pack("<H", crc)
+    return BulkDataPacket(
+        header=header,
+        src_id=0,
+        blob_id=random.randint(0, 255),
+        flags=0,
+        total_len=data_size,
+        offset=0,
+        data=data,
+        crc=0,
+    )
 
 
 def generate_ping_packet() -> PingPacket:
@@ -2,6 +2,7 @@
 import struct
 from dataclasses import dataclass
 from enum import IntEnum
+from typing import List, Optional
 
 # Packet constants
 PACKET_PREAMBLE = 0xAA55  # correct value for little-endian format
@@ -25,6 +26,83 @@ class PacketType(IntEnum):
     PING = 7
     ACK = 8
     CUSTOM_MESSAGE = 9
+    OTA_CONFIG = 10
+    BRIDGE_CONTROL = 11
+    SWARM_SNAPSHOT = 12
+    CONFLICT_ALERT = 13
+    DELIVERY_REPORT = 14
+    STREAM_DATA = 15
+    STREAM_ACK = 16  # Air only, consumed by the bridges
+    STREAM_CONTROL = 17
+    FEC_PARITY = 18  # Air only, consumed by the bridges
+    LINK_STATS = 19
+    TIME_SYNC = 20  # Clock exchanges between bridges; to the host only as the reply to a PING
+    RX_META = 21  # Bridge -> host radio metadata of the packet right after it
+    CHANNEL_SWITCH = 22  # Swarm-wide channel change: request to the bridge, report back
+    FILTER_RULE = 23  # One rule of the bridge's filter on frames forwarded to the host, answered with the slot
+    NEIGHBOR = 24  # Bridge -> host neighbour joined or left, or one entry of the neighbour table
+    STATS = 25  # Statistics snapshot of a bridge, requested over the air and unicast back
+
+
+# Bridge control commands (BRIDGE_CONTROL packets, host -> bridge only)
+class BridgeCommand(IntEnum):
+    SET_SNAPSHOT_INTERVAL = 1  # value: ms between snapshots, 0 = per-packet forwarding
+    SET_INTEREST_RADIUS = 2  # value: cm, 0 = no distance limit
+    SET_INTEREST_K = 3  # value: k nearest neighbours, 0 = no limit
+    SET_CONFLICT_RADIUS = 4  # value: cm, 0 = conflict detection off
+    SET_CONFLICT_HORIZON = 5  # value: ms of look-ahead
+    REQUEST_POSITIONS = 6  # arg: query id, value: ms ahead of now; reply is an extrapolated snapshot
+    SET_COMMAND_RETRIES = 7  # value: retransmissions per reliable COMMAND, 0 = fire-and-forget
+    BULK_BENCHMARK = 8  # arg: blob count, value: blob size in bytes
+    SET_FEC_GROUP = 9  # value: broadcast frames per parity frame, 0 = FEC off
+    LINK_BENCHMARK = 10  # arg: target drone_id, value: probes per mode (broadcast, unicast)
+    SET_RELAY_HOPS = 11  # value: hops our frames may travel, also turns relaying on; 0 = off
+    SET_RELAY_POLICY = 12  # value: bit n set relays packets of type n
+    SET_LINK_REPORT_INTERVAL = 13  # value: ms between LINK_STATS reports, 0 = only on request
+    REQUEST_LINK_STATS = 14  # arg: report id, echoed in the reply
+    SET_TIME_SYNC = 15  # value: TimeSyncRole
+    SET_PING_INTERVAL = 16  # value: ms between latency pings to the next known peer, 0 = off
+    SET_TDMA = 17  # arg: slots per frame, 0 = off; value: slot length in us (0 = default)
+    SET_TX_JITTER = 18  # value: ms window of random telemetry delay, 0 = off
+    SET_RATE_LIMIT = 19  # arg: packet type or RATE_LIMIT_RELAY; value: rate/s | burst << 16, 0 = off
+    SET_RX_META = 20  # value: 1 = RX_META ahead of every frame forwarded from the air, 0 = off
+    SET_TX_POWER_CONTROL = 21  # arg: lowest dBm, 0 = fixed configured power; value: highest dBm
+    SUBSCRIBE_NETWORK = 22  # arg: network_id, 0 = all; value: 1 = forward its frames, 0 = stop
+    SET_NEIGHBOR_EVENTS = 23  # value: 1 = push NEIGHBOR join/leave events, 0 = off
+    REQUEST_NEIGHBORS = 24  # arg: query id; reply is one NEIGHBOR per entry, then NeighborEvent.END
+
+
+RATE_LIMIT_RELAY = 0xFF  # SET_RATE_LIMIT arg for the per-originator limit on relay rebroadcasts
+
+
+class TimeSyncRole(IntEnum):
+    OFF = 0
+    FOLLOWER = 1
+    CANDIDATE = 2  # Becomes the swarm's time master unless a lower drone_id already is
+
+
+class TimeSyncOp(IntEnum):
+    BEACON = 1
+    REQUEST = 2
+    RESPONSE = 3
+    STATUS = 4  # bridge -> host, reply to a PING
+
+
+# Stream operations (STREAM_CONTROL packets)
+class StreamOp(IntEnum):
+    OPEN = 1  # host -> bridge: open stream_id to peer_id
+    CLOSE = 2  # host -> bridge: finish once everything written is acknowledged
+    STATUS = 3  # bridge -> host: outgoing stream state and credit
+    INCOMING = 4  # bridge -> host: peer_id opened stream_id to us
+    FINISHED = 5  # bridge -> host: incoming stream complete, state tells how
+
+
+class StreamState(IntEnum):
+    IDLE = 0
+    OPEN = 1
+    CLOSING = 2
+    CLOSED = 3  # Every byte acknowledged
+    FAILED = 4  # Peer unknown or no progress
 
 
 # Packet formats (without header and CRC)
@@ -33,6 +111,7 @@ TELEMETRY_SIZE = struct.calcsize(TELEMETRY_FORMAT) + 2  # +2 for CRC
 
 COMMAND_FORMAT = "<BBH"  # command_id, target_id, param
 COMMAND_SIZE = struct.calcsize(COMMAND_FORMAT) + 2  # +2 for CRC
+COMMAND_TARGET_ALL = 0xFF
 
 STATUS_FORMAT = "<BBHH"  # drone_id, status_code, battery_mv, error_flags
 STATUS_SIZE = struct.calcsize(STATUS_FORMAT) + 2  # +2 for CRC
@@ -52,6 +131,130 @@ ACK_SIZE = struct.calcsize(ACK_FORMAT) + 2  # +2 for CRC
 CUSTOM_MESSAGE_FORMAT = "<126s"  # 126 bytes of custom data
 CUSTOM_MESSAGE_SIZE = struct.calcsize(CUSTOM_MESSAGE_FORMAT) + 2  # +2 for CRC
 
+BRIDGE_CONTROL_FORMAT = "<BBi"  # command, arg, value
+BRIDGE_CONTROL_SIZE = struct.calcsize(BRIDGE_CONTROL_FORMAT) + 2  # +2 for CRC
+
+# Swarm snapshot: fixed part followed by a variable number of entries
+SNAPSHOT_FORMAT = "<IBBBB"  # timestamp_ms, snapshot_id, flags, part, count
+SNAPSHOT_ENTRY_FORMAT = "<BBHhhhhhh"  # drone_id, status_code, age_ms, x/y/z cm, vx/vy/vz cm/s
+SNAPSHOT_ENTRY_SIZE = struct.calcsize(SNAPSHOT_ENTRY_FORMAT)
+SNAPSHOT_FLAG_LAST_PART = 0x01
+SNAPSHOT_FLAG_INTEREST_FILTERED = 0x02
+SNAPSHOT_FLAG_EXTRAPOLATED = 0x04  # Reply to a position query, snapshot_id echoes the query id
+
+# Link statistics: per-peer delivery counters and RTT percentiles, same part layout as snapshots
+LINK_STATS_FORMAT = "<IBBBB"  # timestamp_ms, report_id, flags, part, count
+# drone_id, expected, received, lost, duplicates, reordered, rtt p50/p90/p99 (0.1 ms, 0 = never pinged)
+LINK_STATS_ENTRY_FORMAT = "<BIIIIIHHH"
+LINK_STATS_ENTRY_SIZE = struct.calcsize(LINK_STATS_ENTRY_FORMAT)
+LINK_STATS_FLAG_LAST_PART = 0x01
+LINK_STATS_FLAG_REPLY = 0x02  # Answer to a request, report_id echoes its id
+
+# Time sync: times are bridge esp_timer microseconds. A STATUS echoes the PING timestamp
+# in t1, the bridge clock in t2 and the synchronized swarm clock in t3
+TIME_SYNC_FORMAT = "<BBBiHQQQ"  # op, master_id, flags, drift_ppb, error_us, t1, t2, t3
+TIME_SYNC_SIZE = struct.calcsize(TIME_SYNC_FORMAT) + 2  # +2 for CRC
+TIME_SYNC_FLAG_SYNCED = 0x01  # t3 is the master's clock, not the bridge's own
+TIME_SYNC_FLAG_MASTER = 0x02
+
+RX_META_FORMAT = "<bbBB6sQ"  # rssi, noise_floor, flags, src_id, mac, rx_us
+RX_META_SIZE = struct.calcsize(RX_META_FORMAT) + 2  # +2 for CRC
+RX_META_FLAG_RSSI = 0x01  # rssi and noise_floor were measured
+RX_META_FLAG_SWARM_TIME = 0x02  # rx_us is on the swarm clock, else the bridge's own
+RX_META_FLAG_SRC_ID = 0x04  # src_id is known
+RX_META_FLAG_RELAYED = 0x08  # mac is the last relay's, not the originator's
+
+# Channel switch: countdown_us is the delay in a request; switch_at_us is swarm time, 0 = unknown
+CHANNEL_SWITCH_FORMAT = "<BBBHQII"  # op, channel, status, switch_id, switch_at_us, countdown_us, first_frame_us
+CHANNEL_SWITCH_SIZE = struct.calcsize(CHANNEL_SWITCH_FORMAT) + 2  # +2 for CRC
+
+
+class ChannelSwitchOp(IntEnum):
+    REQUEST = 1  # Host -> bridge
+    ANNOUNCE = 2  # Between the bridges only
+    REPORT = 3  # Bridge -> host after the switch
+
+
+class ChannelSwitchStatus(IntEnum):
+    OK = 1  # Switched at the announced swarm time
+    UNSYNCED = 2  # Switched on the countdown, without the swarm clock
+    REJECTED = 3  # Invalid channel or countdown
+
+
+# Host filter: rules tried in slot order, the first match passes or drops the frame, no match passes.
+# offset counts from the start of the frame, the 5-byte header included (drone_id of telemetry is at 5)
+FILTER_RULE_FORMAT = "<BBBBBBIII"  # index, op, action, packet_type (0 = any), offset, width, lo, hi, hits
+FILTER_RULE_SIZE = struct.calcsize(FILTER_RULE_FORMAT) + 2  # +2 for CRC
+FILTER_MAX_RULES = 16
+FILTER_ALL_RULES = 0xFF  # index: with FilterOp.OFF empties every slot; query: frames no rule matched
+FILTER_RULE_QUERY = 0xFF  # op: read the slot and its hits without changing it
+
+
+class FilterOp(IntEnum):
+    OFF = 0  # Empty slot
+    ALWAYS = 1  # Every frame of the type
+    EQ = 2  # field == lo
+    NE = 3  # field != lo
+    RANGE = 4  # lo <= field <= hi
+    OUTSIDE = 5  # field < lo or field > hi
+    MASK = 6  # field & lo != 0
+
+
+class FilterAction(IntEnum):
+    PASS = 0
+    DROP = 1
+
+
+# Neighbour table: a drone joins with its first telemetry frame and leaves after SWARM_ENTRY_TIMEOUT_MS of silence
+NEIGHBOR_FORMAT = "<BBBbBBHH"  # event, drone_id, status_code, rssi, flags, query_id, rate_dpps, age_ms
+NEIGHBOR_SIZE = struct.calcsize(NEIGHBOR_FORMAT) + 2  # +2 for CRC
+NEIGHBOR_FLAG_RSSI = 0x01  # rssi holds a value
+
+
+class NeighborEvent(IntEnum):
+    JOIN = 1
+    LEAVE = 2
+    STATE = 3  # Entry of a table dump
+    END = 4  # Last packet of a dump, drone_id holds the number of entries
+
+
+# Remote statistics: each bridge asked answers at most every 500 ms, unicast to whoever asked
+STATS_FORMAT = "<BBBBIIIIIIIIIHHBbBB"  # op, target_id, src_id, query_id, uptime_s, 9 counters, rates, state
+STATS_SIZE = struct.calcsize(STATS_FORMAT) + 2  # +2 for CRC
+STATS_TARGET_ALL = 0xFF
+
+
+class StatsOp(IntEnum):
+    REQUEST = 1
+    REPLY = 2
+
+
+CONFLICT_ALERT_FORMAT = "<BBHHH"  # drone_id, severity, time_to_cpa_ms, min_distance_cm, distance_cm
+CONFLICT_ALERT_SIZE = struct.calcsize(CONFLICT_ALERT_FORMAT) + 2  # +2 for CRC
+CONFLICT_PREDICTED = 1  # Separation will drop below the radius within the horizon
+CONFLICT_INSIDE = 2  # Already closer than the radius
+
+# Bulk data: blobs of up to BULK_MAX_BLOB_SIZE bytes travel as chunks, each with this header
+BULK_HEADER_FORMAT = "<BBBHH"  # src_id, blob_id, flags, total_len, offset
+BULK_HEADER_SIZE = struct.calcsize(BULK_HEADER_FORMAT)
+BULK_MAX_BLOB_SIZE = 4096
+BULK_UART_CHUNK_SIZE = MAX_PAYLOAD_SIZE - BULK_HEADER_SIZE - 2  # -2 for CRC
+BULK_FLAG_BENCHMARK = 0x01  # Counted by receiving bridges, never delivered to the host
+
+# Streams: reliable byte streams to one peer. The host writes within the
+# credit reported in STATUS packets; bytes counts what the bridge accepted.
+STREAM_HEADER_FORMAT = "<BBH"  # stream_id, flags, seq
+STREAM_HEADER_SIZE = struct.calcsize(STREAM_HEADER_FORMAT)
+STREAM_UART_CHUNK_SIZE = MAX_PAYLOAD_SIZE - STREAM_HEADER_SIZE - 2  # -2 for CRC
+STREAM_CONTROL_FORMAT = "<BBBBHI"  # op, stream_id, peer_id, state, credit, bytes
+STREAM_CONTROL_SIZE = struct.calcsize(STREAM_CONTROL_FORMAT) + 2  # +2 for CRC
+
+DELIVERY_REPORT_FORMAT = "<BBBBBBH"  # command_id, target_id, result, retransmissions, expected, acked, latency_ms
+DELIVERY_REPORT_SIZE = struct.calcsize(DELIVERY_REPORT_FORMAT) + 2  # +2 for CRC
+DELIVERY_OK = 0  # All expected receivers acknowledged
+DELIVERY_PARTIAL = 1  # Retries exhausted, some receivers acknowledged
+DELIVERY_FAILED = 2  # Retries exhausted, no acknowledgement
+
 
 @dataclass
 class PacketHeader:
@@ -133,3 +336,216 @@ class CustomMessagePacket:
     header: PacketHeader
     custom_data: bytes
     crc: int
+
+
+@dataclass
+class BridgeControlPacket:
+    header: PacketHeader
+    command: int
+    arg: int
+    value: int
+    crc: int
+
+
+@dataclass
+class SnapshotEntry:
+    drone_id: int
+    status_code: int
+    age_ms: int
+    x: float
+    y: float
+    z: float
+    vx: float
+    vy: float
+    vz: float
+
+
+@dataclass
+class SwarmSnapshotPacket:
+    header: PacketHeader
+    timestamp_ms: int
+    snapshot_id: int
+    flags: int
+    part: int
+    entries: List[SnapshotEntry]
+    crc: int
+
+
+@dataclass
+class LinkStatsEntry:
+    drone_id: int
+    expected: int
+    received: int
+    lost: int
+    duplicates: int
+    reordered: int
+    rtt_p50: float  # ms, 0 = never pinged
+    rtt_p90: float
+    rtt_p99: float
+
+    @property
+    def delivery_ratio(self) -> float:
+        return self.received / self.expected if self.expected else 0.0
+
+
+@dataclass
+class LinkStatsPacket:
+    header: PacketHeader
+    timestamp_ms: int
+    report_id: int
+    flags: int
+    part: int
+    entries: List[LinkStatsEntry]
+    crc: int
+
+
+@dataclass
+class TimeSyncPacket:
+    header: PacketHeader
+    op: int
+    master_id: int
+    flags: int
+    drift_ppb: int
+    error_us: int
+    t1: int
+    t2: int
+    t3: int
+    crc: int
+
+
+@dataclass
+class RxMetaPacket:
+    """How the bridge received the packet that follows it; attached to that packet as rx_meta"""
+
+    header: PacketHeader
+    rssi: int  # dBm
+    noise_floor: int  # dBm
+    flags: int
+    src_id: int
+    mac: bytes
+    rx_us: int
+    crc: int
+
+
+@dataclass
+class ChannelSwitchPacket:
+    header: PacketHeader
+    op: int
+    channel: int
+    status: int
+    switch_id: int
+    switch_at_us: int
+    countdown_us: int
+    first_frame_us: int  # Report: switch to first frame heard on the new channel, 0 = none
+    crc: int
+
+
+@dataclass
+class FilterRulePacket:
+    header: PacketHeader
+    index: int
+    op: int
+    action: int
+    packet_type: int
+    offset: int
+    width: int
+    lo: int
+    hi: int
+    hits: int  # Reply: frames the rule decided since it was set
+    crc: int
+
+
+@dataclass
+class NeighborPacket:
+    header: PacketHeader
+    event: int
+    drone_id: int
+    status_code: int
+    rssi: Optional[int]  # dBm, moving average over frames heard directly; None = only heard through relays
+    query_id: int
+    rate: float  # frames per second heard from the drone
+    age: float  # seconds since its last frame
+    crc: int
+
+
+@dataclass
+class StatsPacket:
+    header: PacketHeader
+    op: int
+    target_id: int  # Request: drone_id asked, or STATS_TARGET_ALL
+    src_id: int  # Reply: drone_id of the bridge
+    query_id: int
+    uptime_s: int
+    air_sent: int  # ESP-NOW frames
+    air_received: int
+    air_corrupted: int
+    send_failures: int
+    host_sent: int  # UART packets
+    host_received: int
+    policed: int  # Host packets and relays dropped over their rate
+    free_heap: int
+    air_tx_pps: float
+    air_rx_pps: float
+    neighbors: int  # Entries of the bridge's swarm table
+    tx_power: int  # dBm
+    channel: int
+    time_master: int  # drone_id of the swarm clock master, 0 = not synced
+    crc: int
+
+
+@dataclass
+class ConflictAlertPacket:
+    header: PacketHeader
+    drone_id: int
+    severity: int
+    time_to_cpa: float  # seconds
+    min_distance: float  # metres
+    distance: float  # metres
+    crc: int
+
+
+@dataclass
+class DeliveryReportPacket:
+    header: PacketHeader
+    command_id: int
+    target_id: int
+    result: int
+    retransmissions: int
+    expected: int
+    acked: int
+    latency_ms: int
+    crc: int
+
+
+@dataclass
+class BulkDataPacket:
+    header: PacketHeader
+    src_id: int
+    blob_id: int
+    flags: int
+    total_len: int
+    offset: int
+    data: bytes
+    crc: int
+
+
+@dataclass
+class StreamDataPacket:
+    header: PacketHeader
+    stream_id: int
+    flags: int
+    seq: int
+    data: bytes
+    crc: int
+
+
+@dataclass
+class StreamControlPacket:
+    header: PacketHeader
+    op: int
+    stream_id: int
+    peer_id: int
+    state: int
+    credit: int
+    bytes: int
+    crc: int
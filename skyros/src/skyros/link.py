@@ -8,25 +8,69 @@ import logging
 import struct
 import threading
 import time
-from typing import Any, Callable, Dict, Optional
+from typing import Any, Callable, Dict, Iterable, List, Optional
 
 import serial
 
 from skyros.lib.packet_codec import pack_packet, unpack_header, unpack_packet
-from skyros.lib.packet_generator import generate_ack_packet
+from skyros.lib.packet_generator import generate_ack_packet, generate_ping_packet
 from skyros.lib.packets import (
+    BRIDGE_CONTROL_SIZE,
+    BULK_HEADER_SIZE,
+    BULK_MAX_BLOB_SIZE,
+    BULK_UART_CHUNK_SIZE,
+    COMMAND_SIZE,
+    COMMAND_TARGET_ALL,
     CUSTOM_MESSAGE_SIZE,
     HEADER_SIZE,
     HEADER_FORMAT,
     MAX_PAYLOAD_SIZE,
     PACKET_PREAMBLE,
+    RATE_LIMIT_RELAY,
+    CHANNEL_SWITCH_SIZE,
     CONFIG_SIZE,
+    FILTER_ALL_RULES,
+    FILTER_RULE_QUERY,
+    FILTER_RULE_SIZE,
+    LINK_STATS_FLAG_LAST_PART,
+    LINK_STATS_FLAG_REPLY,
+    SNAPSHOT_FLAG_EXTRAPOLATED,
+    SNAPSHOT_FLAG_LAST_PART,
+    STATS_SIZE,
+    STATS_TARGET_ALL,
+    STREAM_CONTROL_SIZE,
+    STREAM_HEADER_SIZE,
+    STREAM_UART_CHUNK_SIZE,
+    BridgeCommand,
+    BridgeControlPacket,
+    BulkDataPacket,
+    ChannelSwitchOp,
+    ChannelSwitchPacket,
+    ChannelSwitchStatus,
+    CommandPacket,
     ConfigPacket,
     CustomMessagePacket,
+    FilterOp,
+    FilterRulePacket,
+    LinkStatsEntry,
+    LinkStatsPacket,
+    NeighborEvent,
+    NeighborPacket,
     PacketHeader,
     PacketType,
     PingPacket,
+    RxMetaPacket,
+    SnapshotEntry,
+    StatsOp,
+    StatsPacket,
+    StreamControlPacket,
+    StreamDataPacket,
+    StreamOp,
+    StreamState,
+    SwarmSnapshotPacket,
     TelemetryPacket,
+    TimeSyncOp,
+    TimeSyncPacket,
 )
 from skyros.lib.statistics import Statistics
 
@@ -63,6 +107,45 @@ class ESP32Link:
         # Callbacks
         self._packet_callbacks: Dict[int, Callable] = {}
         self._custom_message_callback: Optional[Callable[[str], None]] = None
+        self._network_callback: Optional[Callable[[int, Any], None]] = None
+
+        # Bulk blobs: outgoing id counter, incoming blobs being collected by (src_id, blob_id)
+        self._next_blob_id = 0
+        self._bulk_rx: Dict[Any, bytearray] = {}
+        self._bulk_callback: Optional[Callable[[int, bytes], None]] = None
+
+        # Outgoing streams: stream_id -> peer, state and credit as last reported by the bridge.
+        # The bridge takes one incoming stream at a time: (peer_id, stream_id) while it lasts
+        self._next_stream_id = 0
+        self._streams: Dict[int, Dict[str, int]] = {}
+        self._stream_cond = threading.Condition()
+        self._stream_in: Optional[Any] = None
+        self._stream_data_callback: Optional[Callable[[int, int, bytes], None]] = None
+        self._stream_finished_callback: Optional[Callable[[int, int, bool], None]] = None
+
+        # Outstanding numbered requests to the bridge, see _query():
+        # query id -> (done event, context, collected results)
+        self._next_query_id = 0
+        self._position_queries: Dict[int, Any] = {}
+        self._link_queries: Dict[int, Any] = {}
+
+        # Outstanding clock queries: PING timestamp -> (done event, [(receive time, status)])
+        self._time_queries: Dict[int, Any] = {}
+        self._swarm_offset: Optional[float] = None  # Swarm clock minus time.monotonic(), seconds
+
+        # Outstanding channel switches: switch id -> (done event, [report])
+        self._switch_queries: Dict[int, Any] = {}
+
+        # Outstanding filter rule requests: slot -> (done event, [reply])
+        self._filter_queries: Dict[int, Any] = {}
+
+        # Outstanding neighbour table dumps and statistics pulls, see _query(); the
+        # context of a statistics pull is its target_id
+        self._neighbor_queries: Dict[int, Any] = {}
+        self._stats_queries: Dict[int, Any] = {}
+
+        # RX_META received, waiting for the packet it describes
+        self._rx_meta: Optional[RxMetaPacket] = None
 
         # Logger
         self.logger = logging.getLogger(f"ESP32Link-{port}")
@@ -123,8 +206,73 @@ class ESP32Link:
         self.logger.info("ESP32 link started")
         return True
 
-    def _send_config_packet(self):
-        """Send configuration packet to ESP32"""
+    def reconfigure(
+        self, network_id: Optional[int] = None, wifi_channel: Optional[int] = None, tx_power: Optional[int] = None
+    ) -> bool:
+        """Switch the bridge to another network_id, channel or TX power without restarting it.
+
+        The bridge applies the change at once and saves it in the background; every drone of
+        the swarm must follow to stay in contact."""
+        if network_id is not None:
+            self.network_id = network_id
+        if wifi_channel is not None:
+            self.wifi_channel = wifi_channel
+        if tx_power is not None:
+            self.tx_power = tx_power
+        return self._send_config_packet()
+
+    def switch_channel(self, wifi_channel: int, delay: float = 0.5, timeout: float = 3.0) -> Optional[ChannelSwitchPacket]:
+        """Move the whole swarm to wifi_channel at one instant, delay seconds (0.1..10) from now.
+
+        The bridge announces the switch on the current channel with its time on the swarm clock;
+        every bridge that hears it passes it on and changes channel at that time, or after the
+        announced countdown without the swarm clock. Leave delay long enough for the announcement
+        to cross the swarm. Bridges save the new channel like a CONFIG; wifi_channel follows
+        here on success so the next CONFIG from this link does not switch back.
+
+        Returns:
+            The bridge's REPORT (status, first_frame_us: switch to first frame heard on the new
+            channel, 0 = none within 2 s), or None on timeout
+        """
+        switch_id = int(time.monotonic() * 1000) & 0xFFFF
+        header = PacketHeader(
+            preamble=PACKET_PREAMBLE,
+            payload_size=CHANNEL_SWITCH_SIZE,
+            packet_type=PacketType.CHANNEL_SWITCH,
+            network_id=self.network_id,
+        )
+        request = ChannelSwitchPacket(
+            header=header,
+            op=ChannelSwitchOp.REQUEST,
+            channel=int(wifi_channel),
+            status=0,
+            switch_id=switch_id,
+            switch_at_us=0,
+            countdown_us=max(0, int(delay * 1000000)),
+            first_frame_us=0,
+            crc=0,
+        )
+        done = threading.Event()
+        reply: List[ChannelSwitchPacket] = []
+        self._switch_queries[switch_id] = (done, reply)
+        try:
+            if not self.send_packet(request):
+                return None
+            if not done.wait(delay + timeout):
+                self.logger.warning(f"Channel switch {switch_id} timed out")
+                return None
+        finally:
+            self._switch_queries.pop(switch_id, None)
+
+        report = reply[0]
+        if report.status == ChannelSwitchStatus.REJECTED:
+            self.logger.error(f"Channel switch to {wifi_channel} rejected by the bridge")
+        else:
+            self.wifi_channel = report.channel
+        return report
+
+    def _send_config_packet(self) -> bool:
+        """Send configuration packet to ESP32; applied live, a no-op when nothing changed"""
         try:
             header = PacketHeader(
                 preamble=PACKET_PREAMBLE,
@@ -143,10 +291,11 @@ class ESP32Link:
 
             if self.send_packet(packet):
                 self.logger.info(f"Config packet sent: network_id={self.network_id}, wifi_channel={self.wifi_channel}, tx_power={self.tx_power}")
-            else:
-                self.logger.error("Failed to send config packet")
+                return True
+            self.logger.error("Failed to send config packet")
         except Exception as e:
             self.logger.error(f"Error sending config packet: {e}")
+        return False
 
     def _clear_esp32_buffer(self, read_timeout: float = 0.5, log_cleared: bool = True):
         """Clear any old packets from ESP32 buffer
@@ -264,6 +413,22 @@ class ESP32Link:
 
         return self.send_packet(packet)
 
+    def send_command(self, command_id: int, target_id: int = COMMAND_TARGET_ALL, param: int = 0) -> bool:
+        """Send a command to one drone or, with COMMAND_TARGET_ALL, to the whole swarm.
+
+        With reliable commands enabled (set_command_retries) the bridge retransmits until
+        every receiver acknowledges and answers with a DELIVERY_REPORT packet.
+        """
+        header = PacketHeader(
+            preamble=PACKET_PREAMBLE,
+            payload_size=COMMAND_SIZE,
+            packet_type=PacketType.COMMAND,
+            network_id=self.network_id,
+        )
+
+        packet = CommandPacket(header=header, command_id=command_id, target_id=target_id, param=param, crc=0)
+        return self.send_packet(packet)
+
     def send_telemetry(self, drone_id: int, x: float, y: float, z: float, vx: float, vy: float, vz: float) -> bool:
         """Send telemetry data"""
         header = PacketHeader(
@@ -287,10 +452,505 @@ class ESP32Link:
 
         return self.send_packet(packet)
 
+    def send_bridge_control(self, command: int, value: int = 0, arg: int = 0) -> bool:
+        """Send a control request to the local ESP32 bridge (never forwarded over ESP-NOW)"""
+        header = PacketHeader(
+            preamble=PACKET_PREAMBLE,
+            payload_size=BRIDGE_CONTROL_SIZE,
+            packet_type=PacketType.BRIDGE_CONTROL,
+            network_id=self.network_id,
+        )
+
+        packet = BridgeControlPacket(header=header, command=command, arg=arg, value=value, crc=0)
+        return self.send_packet(packet)
+
+    def set_snapshot_interval(self, interval_ms: int) -> bool:
+        """Make the bridge send periodic swarm snapshots instead of forwarding every telemetry frame.
+
+        Args:
+            interval_ms: Snapshot period in milliseconds, 0 restores per-packet forwarding
+        """
+        return self.send_bridge_control(BridgeCommand.SET_SNAPSHOT_INTERVAL, max(0, int(interval_ms)))
+
+    def set_interest(self, radius: float = 0.0, k: int = 0) -> bool:
+        """Limit telemetry forwarded by the bridge to neighbours that matter.
+
+        Args:
+            radius: Interest radius in metres around this drone, 0 = unlimited
+            k: Forward only the k nearest neighbours, 0 = all
+        """
+        ok = self.send_bridge_control(BridgeCommand.SET_INTEREST_RADIUS, max(0, int(radius * 100)))
+        return self.send_bridge_control(BridgeCommand.SET_INTEREST_K, max(0, min(255, int(k)))) and ok
+
+    def set_conflict_detection(self, radius: float, horizon: float = 3.0) -> bool:
+        """Have the bridge check every neighbour for a closest-point-of-approach conflict.
+
+        Args:
+            radius: Minimum safe separation in metres, 0 disables detection
+            horizon: Look-ahead in seconds
+        """
+        ok = self.send_bridge_control(BridgeCommand.SET_CONFLICT_HORIZON, max(0, int(horizon * 1000)))
+        return self.send_bridge_control(BridgeCommand.SET_CONFLICT_RADIUS, max(0, int(radius * 100))) and ok
+
+    def send_bulk(self, data: bytes) -> bool:
+        """Send a blob of up to BULK_MAX_BLOB_SIZE bytes to the swarm.
+
+        The blob goes to the bridge in UART-sized chunks; the bridge re-fragments it
+        for ESP-NOW and receiving bridges deliver it only once it is complete.
+        """
+        if not data or len(data) > BULK_MAX_BLOB_SIZE:
+            self.logger.error(f"Bulk blob must be 1..{BULK_MAX_BLOB_SIZE} bytes, got {len(data)}")
+            return False
+
+        with self._lock:
+            blob_id = self._next_blob_id
+            self._next_blob_id = (self._next_blob_id + 1) & 0xFF
+
+        for offset in range(0, len(data), BULK_UART_CHUNK_SIZE):
+            chunk = data[offset : offset + BULK_UART_CHUNK_SIZE]
+            header = PacketHeader(
+                preamble=PACKET_PREAMBLE,
+                payload_size=BULK_HEADER_SIZE + len(chunk) + 2,
+                packet_type=PacketType.BULK_DATA,
+                network_id=self.network_id,
+            )
+            packet = BulkDataPacket(
+                header=header,
+                src_id=0,
+                blob_id=blob_id,
+                flags=0,
+                total_len=len(data),
+                offset=offset,
+                data=bytes(chunk),
+                crc=0,
+            )
+            if not self.send_packet(packet):
+                return False
+        return True
+
+    def start_bulk_benchmark(self, blob_size: int = BULK_MAX_BLOB_SIZE, count: int = 10) -> bool:
+        """Have the bridge send count blobs of blob_size bytes back to back.
+        Throughput is printed on the sender's and receivers' debug console."""
+        return self.send_bridge_control(BridgeCommand.BULK_BENCHMARK, int(blob_size), max(1, min(255, int(count))))
+
+    def start_link_benchmark(self, target_id: int, probes: int = 50) -> bool:
+        """Have the bridge probe target_id probes times each by broadcast and by unicast.
+        Delivery ratio and round-trip time of both are printed on the bridge's debug console."""
+        return self.send_bridge_control(BridgeCommand.LINK_BENCHMARK, max(1, min(100, int(probes))), int(target_id) & 0xFF)
+
+    def set_bulk_callback(self, callback: Callable[[int, bytes], None]):
+        """Set callback for complete bulk blobs: callback(src_id, data)"""
+        self._bulk_callback = callback
+
+    def open_stream(self, peer_id: int, timeout: float = 1.0) -> Optional[int]:
+        """Open a reliable byte stream to one drone over ESP-NOW unicast.
+
+        The bridge must have heard from peer_id, and runs one outgoing stream at a time.
+
+        Returns:
+            stream_id for write_stream/close_stream, or None if the bridge refused
+        """
+        with self._lock:
+            stream_id = self._next_stream_id
+            self._next_stream_id = (self._next_stream_id + 1) & 0xFF
+        with self._stream_cond:
+            self._streams[stream_id] = {"peer_id": peer_id, "state": StreamState.IDLE, "credit": 0, "accepted": 0, "written": 0}
+        if not self._send_stream_control(StreamOp.OPEN, stream_id, peer_id):
+            return None
+
+        with self._stream_cond:
+            stream = self._streams[stream_id]
+            self._stream_cond.wait_for(lambda: stream["state"] != StreamState.IDLE, timeout)
+            if stream["state"] != StreamState.OPEN:
+                self.logger.error(f"Stream to drone_{peer_id} refused by the bridge")
+                del self._streams[stream_id]
+                return None
+        return stream_id
+
+    def write_stream(self, stream_id: int, data: bytes, timeout: float = 5.0) -> bool:
+        """Queue bytes on an open stream, blocking while the bridge's window is full"""
+        offset = 0
+        while offset < len(data):
+            with self._stream_cond:
+                stream = self._streams.get(stream_id)
+                if stream is None:
+                    return False
+                self._stream_cond.wait_for(
+                    lambda: stream["state"] != StreamState.OPEN or self._stream_room(stream) > 0, timeout
+                )
+                room = self._stream_room(stream)
+                if stream["state"] != StreamState.OPEN or room <= 0:
+                    self.logger.error(f"Stream {stream_id} stalled ({StreamState(stream['state']).name})")
+                    return False
+                n = min(room, STREAM_UART_CHUNK_SIZE, len(data) - offset)
+                stream["written"] += n
+
+            header = PacketHeader(
+                preamble=PACKET_PREAMBLE,
+                payload_size=STREAM_HEADER_SIZE + n + 2,
+                packet_type=PacketType.STREAM_DATA,
+                network_id=self.network_id,
+            )
+            packet = StreamDataPacket(header, stream_id, 0, 0, bytes(data[offset : offset + n]), 0)
+            if not self.send_packet(packet):
+                return False
+            offset += n
+        return True
+
+    def close_stream(self, stream_id: int, timeout: float = 10.0) -> bool:
+        """Finish a stream; True once the peer has acknowledged every byte"""
+        with self._stream_cond:
+            stream = self._streams.get(stream_id)
+        if stream is None or not self._send_stream_control(StreamOp.CLOSE, stream_id, stream["peer_id"]):
+            return False
+
+        with self._stream_cond:
+            self._stream_cond.wait_for(
+                lambda: stream["state"] in (StreamState.CLOSED, StreamState.FAILED), timeout
+            )
+            del self._streams[stream_id]
+            return stream["state"] == StreamState.CLOSED
+
+    def set_stream_callbacks(
+        self,
+        on_data: Optional[Callable[[int, int, bytes], None]] = None,
+        on_finished: Optional[Callable[[int, int, bool], None]] = None,
+    ):
+        """Set callbacks for incoming streams: on_data(peer_id, stream_id, data) with bytes
+        in order, then on_finished(peer_id, stream_id, complete)"""
+        self._stream_data_callback = on_data
+        self._stream_finished_callback = on_finished
+
+    @staticmethod
+    def _stream_room(stream: Dict[str, int]) -> int:
+        # Credit was reported after the bridge accepted "accepted" bytes; the rest may still be on the wire
+        return stream["credit"] - (stream["written"] - stream["accepted"])
+
+    def _send_stream_control(self, op: int, stream_id: int, peer_id: int) -> bool:
+        header = PacketHeader(
+            preamble=PACKET_PREAMBLE,
+            payload_size=STREAM_CONTROL_SIZE,
+            packet_type=PacketType.STREAM_CONTROL,
+            network_id=self.network_id,
+        )
+        packet = StreamControlPacket(header, op, stream_id, peer_id, 0, 0, 0, 0)
+        return self.send_packet(packet)
+
+    def set_command_retries(self, retries: int) -> bool:
+        """Retransmissions the bridge spends on each COMMAND, 0 = fire-and-forget"""
+        return self.send_bridge_control(BridgeCommand.SET_COMMAND_RETRIES, max(0, min(15, int(retries))))
+
+    def set_fec(self, group_size: int) -> bool:
+        """Broadcast frames the bridge protects with one parity frame (max 16), 0 = FEC off.
+
+        Receiving bridges rebuild one lost frame per group at a cost of 1/group_size
+        extra airtime."""
+        return self.send_bridge_control(BridgeCommand.SET_FEC_GROUP, max(0, min(16, int(group_size))))
+
+    def set_relay(self, hops: int, packet_types: Optional[Iterable[int]] = None) -> bool:
+        """Turn the bridge's mesh relay on for up to hops hops (max 3), 0 = off.
+
+        Our relayable frames are stamped with that many hops, and frames from others are
+        rebroadcast. packet_types replaces the bridge's default relay policy (commands, ACKs,
+        status, custom messages and OTA config; never telemetry)."""
+        if packet_types is not None:
+            mask = 0
+            for packet_type in packet_types:
+                mask |= 1 << int(packet_type)
+            if not self.send_bridge_control(BridgeCommand.SET_RELAY_POLICY, mask):
+                return False
+        return self.send_bridge_control(BridgeCommand.SET_RELAY_HOPS, max(0, min(3, int(hops))))
+
+    def request_positions(self, ahead: float = 0.0, timeout: float = 0.1) -> Optional[List[SnapshotEntry]]:
+        """Ask the bridge for every known drone dead-reckoned to a common instant.
+
+        Args:
+            ahead: Seconds past the bridge's current time to extrapolate to (max 2 s)
+            timeout: Seconds to wait for the reply
+
+        Returns:
+            Extrapolated entries (age_ms is how far each was projected), or None on timeout
+        """
+        ahead_ms = max(0, int(ahead * 1000))
+        return self._query(
+            self._position_queries,
+            lambda query_id: self.send_bridge_control(BridgeCommand.REQUEST_POSITIONS, ahead_ms, query_id),
+            timeout, "Position query")
+
+    def _query(self, registry: Dict[int, Any], send_fn: Callable[[int], bool], timeout: float, what: str,
+               context: Any = None, partial: bool = False) -> Optional[list]:
+        """Send one numbered request and wait until _complete_query() marks it done.
+
+        Args:
+            registry: Outstanding queries of this kind, as looked up by _handle_received_packet()
+            send_fn: Sends the request carrying the given query id, False on failure
+            timeout: Seconds to wait for the last part of the reply
+            what: Request name for the timeout warning
+            context: Kept with the query for the reply handler
+            partial: On timeout, return what arrived instead of None
+
+        Returns:
+            The collected results, or None if sending failed or the reply timed out
+        """
+        with self._lock:
+            query_id = self._next_query_id
+            self._next_query_id = (self._next_query_id + 1) & 0xFF
+        done = threading.Event()
+        results: List[Any] = []
+        registry[query_id] = (done, context, results)
+        try:
+            if not send_fn(query_id):
+                return None
+            if not done.wait(timeout) and not partial:
+                self.logger.warning(f"{what} timed out (query {query_id})")
+                return None
+            return list(results)
+        finally:
+            registry.pop(query_id, None)
+
+    @staticmethod
+    def _complete_query(registry: Dict[int, Any], query_id: int, results: list, last: bool) -> bool:
+        """Add part of a reply to its outstanding query; False when no such query is waiting."""
+        query = registry.get(query_id)
+        if not query:
+            return False
+        done, _, collected = query
+        collected.extend(results)
+        if last:
+            done.set()
+        return True
+
+    def set_link_report_interval(self, interval_ms: int) -> bool:
+        """Have the bridge push per-peer LINK_STATS reports every interval_ms, 0 = only on request.
+        Receive them with set_packet_callback(PacketType.LINK_STATS, ...), one packet per part."""
+        return self.send_bridge_control(BridgeCommand.SET_LINK_REPORT_INTERVAL, max(0, int(interval_ms)))
+
+    def set_ping_interval(self, interval_ms: int) -> bool:
+        """Have the bridge ping one known peer every interval_ms (min 20), 0 = off. Peers echo the pings
+        in their firmware; round-trip percentiles show up in request_link_stats() as rtt_p50/p90/p99."""
+        return self.send_bridge_control(BridgeCommand.SET_PING_INTERVAL, max(0, int(interval_ms)))
+
+    def request_link_stats(self, timeout: float = 0.1) -> Optional[List[LinkStatsEntry]]:
+        """Ask the bridge for its per-peer delivery counters (received/expected/lost/duplicates/reordered)
+        and round-trip percentiles over its latest latency pings.
+
+        Counters are cumulative since the bridge started; diff two replies for a rate.
+        Returns None on timeout."""
+        return self._query(
+            self._link_queries,
+            lambda query_id: self.send_bridge_control(BridgeCommand.REQUEST_LINK_STATS, 0, query_id),
+            timeout, "Link statistics request")
+
+    def set_neighbor_events(self, enabled: bool = True) -> bool:
+        """Have the bridge push a NEIGHBOR packet (NeighborEvent.JOIN/LEAVE) whenever a drone enters
+        or leaves its neighbour table, instead of the host polling for drones that went quiet.
+        Handle them with set_packet_callback(PacketType.NEIGHBOR, ...)."""
+        return self.send_bridge_control(BridgeCommand.SET_NEIGHBOR_EVENTS, 1 if enabled else 0)
+
+    def request_neighbors(self, timeout: float = 0.1) -> Optional[List[NeighborPacket]]:
+        """Ask the bridge for its neighbour table: per drone the status, frames per second, RSSI
+        average and time since its last frame. Returns None on timeout."""
+        return self._query(
+            self._neighbor_queries,
+            lambda query_id: self.send_bridge_control(BridgeCommand.REQUEST_NEIGHBORS, 0, query_id),
+            timeout, "Neighbour table request")
+
+    def request_stats(self, target_id: int = STATS_TARGET_ALL, timeout: float = 0.5) -> Optional[List[StatsPacket]]:
+        """Pull statistics snapshots over ESP-NOW: uptime, air and UART packet counters, policing drops,
+        free heap, current rates, neighbours, TX power, channel and swarm clock master.
+
+        The bridge answers for itself and asks target_id (STATS_TARGET_ALL = every bridge in range) on
+        the air; each answers unicast at most every 500 ms. For one drone this returns as soon as its
+        reply arrives, for all of them after timeout. Counters are cumulative since each bridge started.
+
+        Returns:
+            The replies, one per bridge; None if a single drone did not answer or the request failed
+        """
+        target_id = int(target_id) & 0xFF
+        header = PacketHeader(
+            preamble=PACKET_PREAMBLE,
+            payload_size=STATS_SIZE,
+            packet_type=PacketType.STATS,
+            network_id=self.network_id,
+        )
+        return self._query(
+            self._stats_queries,
+            lambda query_id: self.send_packet(
+                StatsPacket(header, StatsOp.REQUEST, target_id, 0, query_id, *([0] * 15), 0)),
+            timeout, f"Statistics request to drone_{target_id}",
+            context=target_id, partial=target_id == STATS_TARGET_ALL)
+
+    def set_tdma(self, slots: int, slot_us: int = 3000) -> bool:
+        """Send telemetry only in this drone's TDMA slot, drone_id % slots, 0 slots = off.
+
+        Use more slots than the highest drone_id in the swarm so no two drones share one, and
+        slots of at least 2000 us. Slots follow the swarm clock, so turn on set_time_sync() too.
+        Telemetry then goes out at most once per frame of slots * slot_us, the newest position wins."""
+        return self.send_bridge_control(BridgeCommand.SET_TDMA, max(0, int(slot_us)), max(0, min(64, int(slots))))
+
+    def set_tx_jitter(self, window_ms: int) -> bool:
+        """Delay each telemetry frame by a random 0..window_ms (max 50), 0 = off.
+
+        Breaks up bridges that booted together and would otherwise collide every period. The
+        window doubles when broadcasts fail to go out on a busy channel, up to 8x, and halves
+        again after every 8 telemetry frames sent. Failed unicasts to one peer do not count.
+        Commands and other traffic are never delayed."""
+        return self.send_bridge_control(BridgeCommand.SET_TX_JITTER, max(0, min(50, int(window_ms))))
+
+    def set_rate_limit(self, packet_type: Optional[int], rate: int, burst: int = 0) -> bool:
+        """Cap what the bridge puts on the air at rate packets/s with bursts of up to burst
+        (0 = same as rate); rate 0 removes the limit.
+
+        With a packet type, host packets of that type over the limit are dropped before they
+        are forwarded. With None, relay rebroadcasts are limited per originating drone instead.
+        Drops are counted under POLICING in the bridge's statistics."""
+        arg = RATE_LIMIT_RELAY if packet_type is None else int(packet_type)
+        rate = max(0, min(0xFFFF, int(rate)))
+        burst = max(0, min(0x7FFF, int(burst)))  # value is signed
+        return self.send_bridge_control(BridgeCommand.SET_RATE_LIMIT, rate | (burst << 16), arg)
+
+    def set_rx_meta(self, enabled: bool) -> bool:
+        """Have the bridge precede every frame it forwards from the air with an RX_META packet.
+
+        Received packets then carry an rx_meta attribute (RxMetaPacket) with RSSI and noise floor
+        in dBm, the arrival time in microseconds on the swarm clock when synchronized, and the
+        transmitter. Packets the bridge generates itself (snapshots, bulk blobs, ...) have none."""
+        return self.send_bridge_control(BridgeCommand.SET_RX_META, 1 if enabled else 0)
+
+    def subscribe_network(self, network_id: int, subscribe: bool = True) -> bool:
+        """Have the bridge forward the frames it hears from another network as well, or stop;
+        network_id 0 with subscribe=False stops all.
+
+        They go to set_network_callback() with their network_id, never to the packet callbacks,
+        and the bridge does not act on them (no relaying, swarm table or acknowledgements).
+        Frames of networks not subscribed are dropped and only counted."""
+        return self.send_bridge_control(BridgeCommand.SUBSCRIBE_NETWORK, 1 if subscribe else 0, int(network_id) & 0xFF)
+
+    def set_filter_rule(
+        self,
+        index: int,
+        packet_type: int,
+        op: int,
+        action: int,
+        offset: int = 0,
+        width: int = 1,
+        lo: int = 0,
+        hi: int = 0,
+        timeout: float = 0.1,
+    ) -> Optional[FilterRulePacket]:
+        """Set slot index (0..15) of the bridge's filter on frames from the air to the host.
+
+        Rules are tried in slot order and the first match passes or drops the frame (FilterAction);
+        frames no rule matches pass. A rule matches frames of packet_type (0 = any) whose
+        little-endian field of width 1, 2 or 4 bytes at offset from the start of the frame
+        (header included) satisfies op (FilterOp) against lo/hi. Telemetry from drones 1-8 only:
+
+            set_filter_rule(0, PacketType.TELEMETRY, FilterOp.RANGE, FilterAction.PASS, 5, 1, 1, 8)
+            set_filter_rule(1, PacketType.TELEMETRY, FilterOp.ALWAYS, FilterAction.DROP)
+
+        Returns:
+            The slot as the bridge now has it (unchanged if the rule was rejected), or None on timeout
+        """
+        return self._filter_request(index, op, action, packet_type, offset, width, lo, hi, timeout)
+
+    def clear_filter(self, timeout: float = 0.1) -> bool:
+        """Remove every rule of the bridge's host filter"""
+        return self._filter_request(FILTER_ALL_RULES, FilterOp.OFF, 0, 0, 0, 1, 0, 0, timeout) is not None
+
+    def get_filter_rule(self, index: int, timeout: float = 0.1) -> Optional[FilterRulePacket]:
+        """Read slot index of the host filter with its hits, the frames it decided since it was set.
+        FILTER_ALL_RULES reads the frames no rule matched."""
+        return self._filter_request(index, FILTER_RULE_QUERY, 0, 0, 0, 1, 0, 0, timeout)
+
+    def _filter_request(self, index, op, action, packet_type, offset, width, lo, hi, timeout):
+        header = PacketHeader(
+            preamble=PACKET_PREAMBLE,
+            payload_size=FILTER_RULE_SIZE,
+            packet_type=PacketType.FILTER_RULE,
+            network_id=self.network_id,
+        )
+        request = FilterRulePacket(
+            header, int(index) & 0xFF, int(op), int(action), int(packet_type), int(offset), int(width),
+            int(lo) & 0xFFFFFFFF, int(hi) & 0xFFFFFFFF, 0, 0
+        )
+        done = threading.Event()
+        reply: List[FilterRulePacket] = []
+        self._filter_queries[request.index] = (done, reply)
+        try:
+            if not self.send_packet(request):
+                return None
+            if not done.wait(timeout):
+                self.logger.warning(f"Filter rule {request.index} request timed out")
+                return None
+            return reply[0]
+        finally:
+            self._filter_queries.pop(request.index, None)
+
+    def set_tx_power_control(self, min_dbm: int, max_dbm: int = 20) -> bool:
+        """Let the bridge adapt its TX power within [min_dbm, max_dbm] (2..20 dBm), 0 = fixed power.
+
+        Every 2 s it steps down 1 dB after three periods in which every peer heard directly was
+        stronger than -70 dBm with under 1% loss, and raises 3 dB at once on over 5% loss, a peer
+        weaker than -82 dBm or nobody heard at all. Puts the bridge's radio in promiscuous mode."""
+        min_dbm = max(0, min(20, int(min_dbm)))
+        return self.send_bridge_control(BridgeCommand.SET_TX_POWER_CONTROL, max(0, min(20, int(max_dbm))), min_dbm)
+
+    def set_time_sync(self, role: int) -> bool:
+        """Have the bridge follow the swarm clock (TimeSyncRole.FOLLOWER), stand for time master
+        (TimeSyncRole.CANDIDATE, the lowest drone_id among candidates wins) or stop (OFF)."""
+        return self.send_bridge_control(BridgeCommand.SET_TIME_SYNC, int(role))
+
+    def sync_clock(self, samples: int = 4, timeout: float = 0.1) -> Optional[TimeSyncPacket]:
+        """Map this computer's clock onto the swarm clock through the bridge.
+
+        Each sample is a PING the bridge answers with its synchronized clock, read about halfway
+        through the UART round trip; the sample with the fastest round trip is kept. Afterwards
+        swarm_time() reads the swarm clock.
+
+        Returns:
+            The bridge's TIME_SYNC status of the kept sample (flags, drift_ppb, error_us), or
+            None if the bridge never answered
+        """
+        best = None  # (round trip, offset, status)
+        for _ in range(max(1, samples)):
+            ping = generate_ping_packet()
+            ping.timestamp = int(time.monotonic() * 1000000) & 0xFFFFFFFF  # Unique per sample
+            done = threading.Event()
+            reply: List[Any] = []
+            self._time_queries[ping.timestamp] = (done, reply)
+            try:
+                sent_at = time.monotonic()
+                if not self.send_packet(ping) or not done.wait(timeout):
+                    continue
+            finally:
+                self._time_queries.pop(ping.timestamp, None)
+            received_at, status = reply[0]
+            round_trip = received_at - sent_at
+            offset = status.t3 / 1000000.0 - (sent_at + round_trip / 2)
+            if best is None or round_trip < best[0]:
+                best = (round_trip, offset, status)
+
+        if best is None:
+            self.logger.warning("Clock sync: no answer from the bridge")
+            return None
+        self._swarm_offset = best[1]
+        return best[2]
+
+    def swarm_time(self) -> Optional[float]:
+        """Swarm clock in seconds, None before sync_clock(). While the bridge is not synchronized
+        (no TIME_SYNC_FLAG_SYNCED in its status) this is the bridge's own clock."""
+        if self._swarm_offset is None:
+            return None
+        return time.monotonic() + self._swarm_offset
+
     def set_packet_callback(self, packet_type: int, callback: Callable):
         """Set callback for specific packet type"""
         self._packet_callbacks[packet_type] = callback
 
+    def set_network_callback(self, callback: Callable[[int, Any], None]):
+        """Set callback(network_id, packet) for frames of other networks, see subscribe_network()"""
+        self._network_callback = callback
+
     def set_custom_message_callback(self, callback: Callable[[str], None]):
         """Set callback for custom messages"""
         self._custom_message_callback = callback
@@ -387,6 +1047,8 @@ class ESP32Link:
 
     def _handle_packet(self, packet_data: bytes):
         """Handle a complete packet"""
+        # RX_META describes only the packet directly after it, whatever happens to that one
+        rx_meta, self._rx_meta = self._rx_meta, None
         try:
             # Parse header
             header_data = packet_data[:HEADER_SIZE]
@@ -404,6 +1066,18 @@ class ESP32Link:
                 # Update statistics
                 self._update_receive_stats(packet_type, HEADER_SIZE + payload_size)
                 
+                if isinstance(packet, RxMetaPacket):
+                    self._rx_meta = packet
+                    return
+                if rx_meta:
+                    packet.rx_meta = rx_meta
+                
+                # Other networks' frames stay apart from our own
+                if network_id != self.network_id:
+                    if self._network_callback:
+                        self._network_callback(network_id, packet)
+                    return
+                
                 # Handle packet
                 self._handle_received_packet(packet, packet_type)
             else:
@@ -432,6 +1106,66 @@ class ESP32Link:
                 ack = generate_ack_packet()
                 self.send_packet(ack)
 
+            # Position query replies go to the waiting caller, not the snapshot callback
+            elif isinstance(packet, SwarmSnapshotPacket) and packet.flags & SNAPSHOT_FLAG_EXTRAPOLATED:
+                self._complete_query(self._position_queries, packet.snapshot_id, packet.entries,
+                                     bool(packet.flags & SNAPSHOT_FLAG_LAST_PART))
+                return
+
+            elif isinstance(packet, LinkStatsPacket) and packet.flags & LINK_STATS_FLAG_REPLY:
+                self._complete_query(self._link_queries, packet.report_id, packet.entries,
+                                     bool(packet.flags & LINK_STATS_FLAG_LAST_PART))
+                return
+
+            elif isinstance(packet, TimeSyncPacket) and packet.op == TimeSyncOp.STATUS:
+                query = self._time_queries.get(packet.t1)
+                if query:
+                    done, reply = query
+                    reply.append((time.monotonic(), packet))
+                    done.set()
+                return
+
+            elif isinstance(packet, FilterRulePacket):
+                query = self._filter_queries.get(packet.index)
+                if query:
+                    done, reply = query
+                    reply.append(packet)
+                    done.set()
+                return
+
+            elif isinstance(packet, NeighborPacket) and packet.event in (NeighborEvent.STATE, NeighborEvent.END):
+                last = packet.event == NeighborEvent.END
+                self._complete_query(self._neighbor_queries, packet.query_id, [] if last else [packet], last)
+                return
+
+            elif isinstance(packet, StatsPacket) and packet.op == StatsOp.REPLY:
+                query = self._stats_queries.get(packet.query_id)
+                if query:
+                    _, target_id, replies = query
+                    fresh = all(reply.src_id != packet.src_id for reply in replies)
+                    self._complete_query(self._stats_queries, packet.query_id, [packet] if fresh else [],
+                                         packet.src_id == target_id)
+                    return
+
+            elif isinstance(packet, ChannelSwitchPacket):
+                query = self._switch_queries.get(packet.switch_id)
+                if query and packet.op == ChannelSwitchOp.REPORT:
+                    done, reply = query
+                    reply.append(packet)
+                    done.set()
+                return
+
+            # Bulk blobs arrive from the bridge complete, as consecutive chunks
+            elif isinstance(packet, BulkDataPacket):
+                self._handle_bulk_chunk(packet)
+
+            elif isinstance(packet, StreamControlPacket):
+                self._handle_stream_control(packet)
+
+            elif isinstance(packet, StreamDataPacket):
+                if self._stream_in and self._stream_in[1] == packet.stream_id and self._stream_data_callback:
+                    self._stream_data_callback(self._stream_in[0], packet.stream_id, packet.data)
+
             # Handle custom messages
             elif isinstance(packet, CustomMessagePacket):
                 if self._custom_message_callback:
@@ -446,6 +1180,44 @@ class ESP32Link:
         except Exception as e:
             self.logger.error(f"Error handling packet: {e}")
 
+    def _handle_bulk_chunk(self, packet: BulkDataPacket):
+        """Collect chunks of a blob and hand the whole blob to the bulk callback"""
+        key = (packet.src_id, packet.blob_id)
+        if packet.offset == 0:
+            # A new blob from this source replaces anything left of the previous one
+            for stale in [k for k in self._bulk_rx if k[0] == packet.src_id]:
+                del self._bulk_rx[stale]
+            self._bulk_rx[key] = bytearray()
+
+        blob = self._bulk_rx.get(key)
+        if blob is None or len(blob) != packet.offset:
+            self.logger.warning(f"Out of order bulk chunk from drone_{packet.src_id}, blob {packet.blob_id}")
+            self._bulk_rx.pop(key, None)
+            return
+
+        blob.extend(packet.data)
+        if len(blob) >= packet.total_len:
+            del self._bulk_rx[key]
+            if self._bulk_callback:
+                self._bulk_callback(packet.src_id, bytes(blob))
+
+    def _handle_stream_control(self, packet: StreamControlPacket):
+        """Track outgoing stream credit and incoming stream lifetime"""
+        if packet.op == StreamOp.STATUS:
+            with self._stream_cond:
+                stream = self._streams.get(packet.stream_id)
+                if stream is not None:
+                    stream["state"] = packet.state
+                    stream["credit"] = packet.credit
+                    stream["accepted"] = packet.bytes
+                    self._stream_cond.notify_all()
+        elif packet.op == StreamOp.INCOMING:
+            self._stream_in = (packet.peer_id, packet.stream_id)
+        elif packet.op == StreamOp.FINISHED:
+            self._stream_in = None
+            if self._stream_finished_callback:
+                self._stream_finished_callback(packet.peer_id, packet.stream_id, packet.state == StreamState.CLOSED)
+
     def get_statistics(self) -> Dict[str, Any]:
         """Get communication statistics"""
         with self.stats.lock: